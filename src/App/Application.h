@@ -494,6 +494,11 @@ private:
     static PyObject *sGetActiveTransaction  (PyObject *self,PyObject *args);
     static PyObject *sCloseActiveTransaction(PyObject *self,PyObject *args);
     static PyObject *sCheckAbort(PyObject *self,PyObject *args);
+
+    static PyObject *sSetTracing        (PyObject *self,PyObject *args);
+    static PyObject *sIsTracing         (PyObject *self,PyObject *args);
+    static PyObject *sClearTrace        (PyObject *self,PyObject *args);
+    static PyObject *sExportTrace       (PyObject *self,PyObject *args);
     static PyMethodDef    Methods[]; 
 
     friend class ApplicationObserver;
@@ -46,6 +46,7 @@
 #include <Base/FileInfo.h>
 #include <Base/UnitsApi.h>
 #include <Base/Sequencer.h>
+#include <Base/Tracing.h>
 
 //using Base::GetConsole;
 using namespace Base;
@@ -179,6 +180,19 @@ PyMethodDef Application::Methods[] = {
      "There is an active sequencer during document restore and recomputation. User may\n"
      "abort the operation by pressing the ESC key. Once detected, this function will\n"
      "trigger a BaseExceptionFreeCADAbort exception."},
+    {"setTracing", (PyCFunction) Application::sSetTracing, METH_VARARGS,
+     "setTracing(enable, capacity=0) -- start or stop recording timing spans\n\n"
+     "Spans are recorded e.g. around document recomputes, features and saving or\n"
+     "restoring files. capacity: if not 0, the number of spans kept for each thread,\n"
+     "which discards the spans recorded so far."},
+    {"isTracing", (PyCFunction) Application::sIsTracing, METH_VARARGS,
+     "isTracing() -> Bool -- Test if timing spans are recorded"},
+    {"clearTrace", (PyCFunction) Application::sClearTrace, METH_VARARGS,
+     "clearTrace() -- discard all recorded timing spans"},
+    {"exportTrace", (PyCFunction) Application::sExportTrace, METH_VARARGS,
+     "exportTrace(filename) -> Int -- write the recorded timing spans to a file\n\n"
+     "The file is written in the Chrome trace event format, which can be viewed with\n"
+     "chrome://tracing or https://ui.perfetto.dev. Returns the number of spans."},
     {NULL, NULL, 0, NULL}		/* Sentinel */
 };
 
@@ -932,3 +946,51 @@ PyObject *Application::sCheckAbort(PyObject * /*self*/, PyObject *args)
         Py_Return;
     }PY_CATCH
 }
+
+PyObject *Application::sSetTracing(PyObject * /*self*/, PyObject *args)
+{
+    PyObject *enable;
+    unsigned long capacity = 0;
+    if (!PyArg_ParseTuple(args, "O|k", &enable, &capacity))
+        return 0;
+
+    PY_TRY {
+        if (capacity)
+            Base::Tracing::setCapacity(capacity);
+        Base::Tracing::setEnabled(PyObject_IsTrue(enable) ? true : false);
+        Py_Return;
+    }PY_CATCH
+}
+
+PyObject *Application::sIsTracing(PyObject * /*self*/, PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return 0;
+    return Py::new_reference_to(Py::Boolean(Base::Tracing::isEnabled()));
+}
+
+PyObject *Application::sClearTrace(PyObject * /*self*/, PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return 0;
+
+    PY_TRY {
+        Base::Tracing::clear();
+        Py_Return;
+    }PY_CATCH
+}
+
+PyObject *Application::sExportTrace(PyObject * /*self*/, PyObject *args)
+{
+    char *fileName;
+    if (!PyArg_ParseTuple(args, "et", "utf-8", &fileName))
+        return 0;
+    std::string utf8Name = fileName;
+    PyMem_Free(fileName);
+
+    PY_TRY {
+        std::size_t count = Base::Tracing::count();
+        Base::Tracing::exportChromeTrace(utf8Name.c_str());
+        return Py::new_reference_to(Py::Long(static_cast<unsigned long>(count)));
+    }PY_CATCH
+}
@@ -65,6 +65,7 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 # include <sstream>
 # include <climits>
 # include <bitset>
+# include <deque>
 # include <random>
 #endif
 
@@ -90,6 +91,11 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include "Document.h"
 #include "Application.h"
@@ -109,6 +115,7 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 #include <Base/Tools.h>
 #include <Base/Uuid.h>
 #include <Base/Sequencer.h>
+#include <Base/Tracing.h>
 
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
@@ -160,6 +167,7 @@ namespace App {
 
 static bool _IsRestoring;
 static bool _IsRelabeling;
+class RecomputeJob;
 // Pimpl class
 struct DocumentP
 {
@@ -178,7 +186,7 @@ struct DocumentP
     bool committing;
     std::bitset<32> StatusBits;
     int iUndoMode;
-    unsigned int UndoMemSize;
+    std::size_t UndoMemSize;
     unsigned int UndoMaxStackSize;
 #ifdef USE_OLD_DAG
     DependencyList DepList;
@@ -188,6 +196,24 @@ struct DocumentP
     std::multimap<const App::DocumentObject*, 
         std::unique_ptr<App::DocumentObjectExecReturn> > _RecomputeLog;
 
+    // Guards the members below and the undo transaction while objects are
+    // executed in worker threads by a parallel recompute
+    QMutex concurrentMutex;
+    QWaitCondition jobFinished;
+    std::vector<RecomputeJob*> finishedJobs;
+    // property changes that are signaled once the object is finished
+    std::unordered_map<const App::DocumentObject*,
+        std::vector<const App::Property*> > concurrentChanges;
+    // A worker waits until the main thread has signaled that a property is
+    // about to change, so that the observers still see the old value
+    struct BeforeChange {
+        const App::DocumentObject* obj;
+        const App::Property* prop;
+        bool done;
+    };
+    std::vector<BeforeChange*> beforeChanges;
+    QWaitCondition beforeChangeDone;
+
     DocumentP() {
         static std::random_device _RD;
         static std::mt19937 _RGEN(_RD());
@@ -234,6 +260,11 @@ struct DocumentP
             _RecomputeLog.erase(obj);
     }
 
+    /// run the given function and turn its exceptions and return code into a recompute log entry
+    /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
+    int runRecompute(App::DocumentObject *Feat,
+            const std::function<DocumentObjectExecReturn*()> &func);
+
     const char *findRecomputeLog(const App::DocumentObject *obj) {
         auto range = _RecomputeLog.equal_range(obj);
         if(range.first == range.second)
@@ -1192,6 +1223,18 @@ void Document::_commitTransaction(bool notify)
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        // keep at least the last transaction when the memory limit is exceeded
+        if(d->UndoMemSize > 0) {
+            // sum up once and subtract the removed transactions
+            std::size_t size = getUndoMemSize();
+            while(mUndoTransactions.size() > 1 && size > d->UndoMemSize) {
+                Transaction* front = mUndoTransactions.front();
+                size -= std::min(size, front->getUndoMemSize());
+                mUndoMap.erase(front->getID());
+                delete front;
+                mUndoTransactions.pop_front();
+            }
+        }
         signalCommitTransaction(*this);
 
         if(notify)
@@ -1376,12 +1419,24 @@ int Document::getUndoMode(void) const
     return d->iUndoMode;
 }
 
-unsigned int Document::getUndoMemSize (void) const
+std::size_t Document::getUndoMemSize (void) const
+{
+    std::size_t size = 0;
+    for (std::list<Transaction*>::const_iterator it = mUndoTransactions.begin(); it != mUndoTransactions.end(); ++it)
+        size += (*it)->getUndoMemSize();
+    for (std::list<Transaction*>::const_iterator it = mRedoTransactions.begin(); it != mRedoTransactions.end(); ++it)
+        size += (*it)->getUndoMemSize();
+    if (d->activeUndoTransaction)
+        size += d->activeUndoTransaction->getUndoMemSize();
+    return size;
+}
+
+std::size_t Document::getUndoLimit() const
 {
     return d->UndoMemSize;
 }
 
-void Document::setUndoLimit(unsigned int UndoMemSize)
+void Document::setUndoLimit(std::size_t UndoMemSize)
 {
     d->UndoMemSize = UndoMemSize;
 }
@@ -1449,10 +1504,28 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Property *What)
 {
-    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
-        signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
+        auto obj = static_cast<const App::DocumentObject*>(Who);
+        if(obj->testStatus(ObjectStatus::ConcurrentRecompute)) {
+            // Called from a worker thread. The transaction has already been
+            // opened by the main thread, which also emits the signals while
+            // the worker waits here.
+            QMutexLocker locker(&d->concurrentMutex);
+            if(!d->rollback && !_IsRelabeling && d->activeUndoTransaction)
+                d->activeUndoTransaction->addObjectChange(Who,What);
+            DocumentP::BeforeChange change = {obj, What, false};
+            d->beforeChanges.push_back(&change);
+            d->jobFinished.wakeAll();
+            while(!change.done)
+                d->beforeChangeDone.wait(&d->concurrentMutex);
+            return;
+        }
+        signalBeforeChangeObject(*obj, *What);
+    }
     if(!d->rollback && !_IsRelabeling) {
         _checkTransaction(0,What,__LINE__);
+        // the workers of a parallel recompute may add to the transaction at the same time
+        QMutexLocker locker(&d->concurrentMutex);
         if (d->activeUndoTransaction)
             d->activeUndoTransaction->addObjectChange(Who,What);
     }
@@ -1460,6 +1533,11 @@ void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    if(Who->testStatus(ObjectStatus::ConcurrentRecompute)) {
+        QMutexLocker locker(&d->concurrentMutex);
+        d->concurrentChanges[Who].push_back(What);
+        return;
+    }
     signalChangedObject(*Who, *What);
 }
 
@@ -2161,7 +2239,7 @@ unsigned int Document::getMemSize (void) const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    size += static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(), UINT_MAX));
 
     return size;
 }
@@ -2244,6 +2322,11 @@ bool Document::save (void)
 
 bool Document::saveToFile(const char* filename) const
 {
+    FC_TRACE_SPAN2("Document::saveToFile", getName());
+
+    // The file may be overwritten while data of it is still to be read
+    prefetchFiles(d->objectArray);
+
     signalStartSave(*this, filename);
 
     auto hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
@@ -2274,10 +2357,15 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        writer.setConcurrentFiles(hGrp->GetBool("ParallelFileIO", false));
         writer.putNextEntry("Document.xml");
 
         if (hGrp->GetBool("SaveBinaryBrep", false))
             writer.setMode("BinaryBrep");
+        if (hGrp->GetBool("SaveShapeBlob", false))
+            writer.setMode("ShapeBlob");
+        if (hGrp->GetBool("SaveShapeTriangulation", false))
+            writer.setMode("ShapeTriangulation");
 
         writer.Stream() << "<?xml version='1.0' encoding='utf-8'?>" << endl
                         << "<!--" << endl
@@ -2372,6 +2460,8 @@ bool Document::isAnyRestoring() {
 void Document::restore (const char *filename,
         bool delaySignal, const std::set<std::string> &objNames)
 {
+    FC_TRACE_SPAN2("Document::restore", getName());
+
     clearUndos();
     d->activeObject = 0;
 
@@ -2440,6 +2530,16 @@ void Document::restore (const char *filename,
     // Note: This file doesn't need to be available if the document has been created
     // without GUI. But if available then follow after all data files of the App document.
     signalRestoreDocument(reader);
+    auto hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    reader.setConcurrentFiles(hGrp->GetBool("ParallelFileIO", false));
+    if (hGrp->GetBool("LazyFileLoading", false)) {
+        try {
+            reader.setLazyFiles(std::make_shared<zipios::ZipFile>(fi.filePath()));
+        }
+        catch (const std::exception& e) {
+            Base::Console().Warning("Cannot defer reading of '%s': %s\n", filename, e.what());
+        }
+    }
     reader.readFiles(zipstream);
 
     if (reader.testStatus(Base::XMLReader::ReaderStatus::PartialRestore)) {
@@ -2451,6 +2551,26 @@ void Document::restore (const char *filename,
         afterRestore(true);
 }
 
+void Document::prefetchFiles(const std::vector<App::DocumentObject *> &objs) const {
+    for(auto obj : objs) {
+        if(!obj || obj->getDocument()!=this)
+            continue;
+        std::vector<Property*> props;
+        obj->getPropertyList(props);
+        for(auto prop : props) {
+            try {
+                prop->loadLazyDocFile();
+            }
+            catch(const Base::Exception &e) {
+                FC_ERR("Failed to read data of " << obj->getFullName() << '.' << prop->getName() << ": " << e.what());
+            }
+            catch(const std::exception &e) {
+                FC_ERR("Failed to read data of " << obj->getFullName() << '.' << prop->getName() << ": " << e.what());
+            }
+        }
+    }
+}
+
 void Document::afterRestore(bool checkPartial) {
     Base::FlagToggler<> flag(_IsRestoring,false);
     if(!afterRestore(d->objectArray,checkPartial)) {
@@ -3081,6 +3201,8 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
 
 int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool force, bool *hasError, int options) 
 {
+    FC_TRACE_SPAN2("Document::recompute", getName());
+
     if (d->undoing || d->rollback) {
         if (FC_LOG_INSTANCE.isEnabled(FC_LOGLEVEL_LOG))
             FC_WARN("Ignore document recompute on undo/redo");
@@ -3137,9 +3259,13 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     for(auto obj : topoSortedObjects)
         obj->setStatus(ObjectStatus::PendingRecompute,true);
 
-    ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
-            "User parameter:BaseApp/Preferences/Document");
-    bool canAbort = hGrp->GetBool("CanAbortRecompute",true);
+    // recompute() is called very often, so keep handles to the preferences
+    static ParameterValue<bool> canAbortRecompute(GetApplication().GetUserParameter(),
+            "BaseApp/Preferences/Document", "CanAbortRecompute", true);
+    static ParameterValue<bool> parallelRecompute(GetApplication().GetUserParameter(),
+            "BaseApp/Preferences/Document", "ParallelRecompute", false);
+    bool canAbort = canAbortRecompute;
+    bool parallel = parallelRecompute;
 
     std::set<App::DocumentObject *> filter;
     size_t idx = 0;
@@ -3149,8 +3275,15 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     try {
         // maximum two passes to allow some form of dependency inversion
         for(int passes=0; passes<2 && idx<topoSortedObjects.size(); ++passes) {
+            if(passes==0 && parallel) {
+                bool aborted = false;
+                objectCount += _recomputeConcurrently(topoSortedObjects,filter,hasError,canAbort,aborted);
+                idx = topoSortedObjects.size();
+                if(aborted)
+                    passes = 2;
+            }
             std::unique_ptr<Base::SequencerLauncher> seq;
-            if(canAbort)
+            if(canAbort && idx<topoSortedObjects.size())
                 seq.reset(new Base::SequencerLauncher("Recompute...", topoSortedObjects.size()));
             FC_LOG("Recompute pass " << passes);
             for (;idx<topoSortedObjects.size();(seq?seq->next(true):true),++idx) {
@@ -3402,44 +3535,37 @@ const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
     return d->findRecomputeLog(Obj);
 }
 
-// call the recompute of the Feature and handle the exceptions and errors.
-int Document::_recomputeFeature(DocumentObject* Feat)
+int DocumentP::runRecompute(DocumentObject *Feat,
+        const std::function<DocumentObjectExecReturn*()> &func)
 {
-    FC_LOG("Recomputing " << Feat->getFullName());
-
     DocumentObjectExecReturn  *returnCode = 0;
     try {
-        returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
-        if (returnCode == DocumentObject::StdReturn) {
-            returnCode = Feat->recompute();
-            if(returnCode == DocumentObject::StdReturn)
-                returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
-        }
+        returnCode = func();
     }
     catch(Base::AbortException &e){
         e.ReportException();
-        d->addRecomputeLog("User abort",Feat);
+        addRecomputeLog("User abort",Feat);
         return -1;
     }
     catch (const Base::MemoryException& e) {
         FC_ERR("Memory exception in " << Feat->getFullName() << " thrown: " << e.what());
-        d->addRecomputeLog("Out of memory exception",Feat);
+        addRecomputeLog("Out of memory exception",Feat);
         return 1;
     }
     catch (Base::Exception &e) {
         e.ReportException();
-        d->addRecomputeLog(e.what(),Feat);
+        addRecomputeLog(e.what(),Feat);
         return 1;
     }
     catch (std::exception &e) {
         FC_ERR("exception in " << Feat->getFullName() << " thrown: " << e.what());
-        d->addRecomputeLog(e.what(),Feat);
+        addRecomputeLog(e.what(),Feat);
         return 1;
     }
 #ifndef FC_DEBUG
     catch (...) {
         FC_ERR("Unknown exception in " << Feat->getFullName() << " thrown");
-        d->addRecomputeLog("Unknown exception!",Feat);
+        addRecomputeLog("Unknown exception!",Feat);
         return 1;
     }
 #endif
@@ -3448,7 +3574,7 @@ int Document::_recomputeFeature(DocumentObject* Feat)
         Feat->resetError();
     }else{
         returnCode->Which = Feat;
-        d->addRecomputeLog(returnCode);
+        addRecomputeLog(returnCode);
 #ifdef FC_DEBUG
         FC_ERR("Failed to recompute " << Feat->getFullName() << ": " << returnCode->Why);
 #else
@@ -3459,6 +3585,318 @@ int Document::_recomputeFeature(DocumentObject* Feat)
     return 0;
 }
 
+// call the recompute of the Feature and handle the exceptions and errors.
+int Document::_recomputeFeature(DocumentObject* Feat)
+{
+    FC_LOG("Recomputing " << Feat->getFullName());
+    FC_TRACE_SPAN2("Document::_recomputeFeature", Feat->getNameInDocument());
+
+    return d->runRecompute(Feat, [Feat]() -> DocumentObjectExecReturn* {
+        DocumentObjectExecReturn *returnCode =
+            Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+        if (returnCode == DocumentObject::StdReturn) {
+            returnCode = Feat->recompute();
+            if(returnCode == DocumentObject::StdReturn)
+                returnCode = Feat->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
+        }
+        return returnCode;
+    });
+}
+
+namespace App {
+
+// Executes a document object in a worker thread of a parallel recompute.
+// Only DocumentObject::recompute() runs in the worker, the expression
+// engine and all error handling stay in the main thread.
+class RecomputeJob : public QRunnable
+{
+public:
+    RecomputeJob(DocumentObject *obj, DocumentP *d)
+        : obj(obj), returnCode(0), d(d)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override
+    {
+        FC_TRACE_SPAN2("Document::_recomputeFeature", obj->getNameInDocument());
+        try {
+            returnCode = obj->recompute();
+        }
+        catch (...) {
+            // rethrown in the main thread by Document::_recomputeConcurrently()
+            error = std::current_exception();
+        }
+        QMutexLocker locker(&d->concurrentMutex);
+        d->finishedJobs.push_back(this);
+        d->jobFinished.wakeAll();
+    }
+
+    DocumentObject *obj;
+    DocumentObjectExecReturn *returnCode;
+    std::exception_ptr error;
+
+private:
+    DocumentP *d;
+};
+
+} // namespace App
+
+static QThreadPool &recomputeThreadPool()
+{
+    // Use our own pool as the features may use QtConcurrent on the global one
+    static QThreadPool pool;
+    return pool;
+}
+
+void Document::_signalConcurrentBeforeChanges()
+{
+    std::vector<DocumentP::BeforeChange*> changes;
+    {
+        QMutexLocker locker(&d->concurrentMutex);
+        changes.swap(d->beforeChanges);
+    }
+    if(changes.empty())
+        return;
+
+    // release the waiting workers in any case
+    std::exception_ptr error;
+    for(auto change : changes) {
+        try {
+            signalBeforeChangeObject(*change->obj, *change->prop);
+            change->obj->signalBeforeChange(*change->obj, *change->prop);
+        }
+        catch(...) {
+            if(!error)
+                error = std::current_exception();
+        }
+    }
+    {
+        QMutexLocker locker(&d->concurrentMutex);
+        for(auto change : changes)
+            change->done = true;
+        d->beforeChangeDone.wakeAll();
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+void Document::_replayConcurrentChanges(DocumentObject* Feat)
+{
+    std::vector<const Property*> changes;
+    {
+        QMutexLocker locker(&d->concurrentMutex);
+        auto it = d->concurrentChanges.find(Feat);
+        if(it == d->concurrentChanges.end())
+            return;
+        changes.swap(it->second);
+        d->concurrentChanges.erase(it);
+    }
+    for(auto prop : changes) {
+        if(prop == &Feat->Label)
+            signalRelabelObject(*Feat);
+        signalChangedObject(*Feat, *prop);
+        Feat->signalChanged(*Feat, *prop);
+    }
+}
+
+int Document::_recomputeConcurrently(const std::vector<App::DocumentObject*> &objs,
+        std::set<App::DocumentObject*> &filter, bool *hasError, bool canAbort, bool &aborted)
+{
+    ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
+            "User parameter:BaseApp/Preferences/Document");
+    int threads = hGrp->GetInt("RecomputeThreads",0);
+    if(threads <= 0)
+        threads = QThread::idealThreadCount();
+    QThreadPool &pool = recomputeThreadPool();
+    pool.setMaxThreadCount(std::max(threads,1));
+
+    // number of unfinished dependencies of each object, -1 when done
+    std::unordered_map<DocumentObject*, int> pending;
+    std::unordered_map<DocumentObject*, std::vector<DocumentObject*> > dependents;
+    for(auto obj : objs)
+        pending[obj] = 0;
+    for(auto obj : objs) {
+        auto outList = obj->getOutList();
+        std::sort(outList.begin(), outList.end());
+        outList.erase(std::unique(outList.begin(), outList.end()), outList.end());
+        for(auto dep : outList) {
+            if(dep != obj && pending.count(dep)) {
+                ++pending[obj];
+                dependents[dep].push_back(obj);
+            }
+        }
+    }
+
+    std::deque<DocumentObject*> ready;
+    for(auto obj : objs) {
+        if(pending[obj] == 0)
+            ready.push_back(obj);
+    }
+
+    std::unique_ptr<Base::SequencerLauncher> seq;
+    if(canAbort)
+        seq.reset(new Base::SequencerLauncher("Recompute...", objs.size()));
+
+    int objectCount = 0;
+    std::map<DocumentObject*, std::unique_ptr<RecomputeJob> > running;
+
+    auto finish = [&](DocumentObject *obj) {
+        pending[obj] = -1;
+        for(auto dependent : dependents[obj]) {
+            if(--pending[dependent] == 0)
+                ready.push_back(dependent);
+        }
+        if(seq)
+            seq->next(true);
+    };
+
+    // same handling as in the serial loop of recompute()
+    auto handleResult = [&](DocumentObject *obj, bool doRecompute, int res) {
+        if(res) {
+            if(hasError)
+                *hasError = true;
+            if(res < 0) {
+                aborted = true;
+            }
+            else {
+                obj->getInListEx(filter,true);
+                filter.insert(obj);
+            }
+        }
+        else if(obj->isTouched() || doRecompute) {
+            signalRecomputedObject(*obj);
+            obj->purgeTouched();
+            for (auto inObjIt : obj->getInList())
+                inObjIt->enforceRecompute();
+        }
+        finish(obj);
+    };
+
+    auto collectJobs = [&](bool wait) {
+        std::vector<RecomputeJob*> finished;
+        {
+            QMutexLocker locker(&d->concurrentMutex);
+            while(wait && d->finishedJobs.empty() && d->beforeChanges.empty())
+                d->jobFinished.wait(&d->concurrentMutex);
+        }
+        _signalConcurrentBeforeChanges();
+        {
+            QMutexLocker locker(&d->concurrentMutex);
+            finished.swap(d->finishedJobs);
+        }
+        std::vector<std::unique_ptr<RecomputeJob> > jobs;
+        for(auto job : finished) {
+            jobs.push_back(std::move(running[job->obj]));
+            running.erase(job->obj);
+            job->obj->setStatus(ObjectStatus::ConcurrentRecompute,false);
+        }
+        for(auto &holder : jobs) {
+            RecomputeJob *job = holder.get();
+            DocumentObject *obj = job->obj;
+            _replayConcurrentChanges(obj);
+            int res = d->runRecompute(obj, [job,obj]() -> DocumentObjectExecReturn* {
+                if(job->error)
+                    std::rethrow_exception(job->error);
+                if(job->returnCode != DocumentObject::StdReturn)
+                    return job->returnCode;
+                return obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteOutput);
+            });
+            handleResult(obj,true,res);
+        }
+    };
+
+    try {
+        while(!aborted) {
+            // pick up finished workers first to schedule their dependents early
+            if(running.size())
+                collectJobs(false);
+            DocumentObject *serialObj = 0;
+            while(ready.size() && !aborted) {
+                auto obj = ready.front();
+                ready.pop_front();
+                if(!obj->getNameInDocument() || filter.find(obj)!=filter.end()) {
+                    finish(obj);
+                    continue;
+                }
+                // ask the object if it should be recomputed
+                if(!obj->mustRecompute()) {
+                    handleResult(obj,false,0);
+                    continue;
+                }
+                ++objectCount;
+                if(!obj->testStatus(ObjectStatus::ThreadSafeExecute)) {
+                    serialObj = obj;
+                    break;
+                }
+
+                FC_LOG("Recomputing " << obj->getFullName() << " in worker thread");
+                int res = d->runRecompute(obj, [obj]() {
+                    return obj->ExpressionEngine.execute(PropertyExpressionEngine::ExecuteNonOutput);
+                });
+                if(res) {
+                    handleResult(obj,true,res);
+                    continue;
+                }
+                // make sure the transaction is opened here and not by the worker
+                _checkTransaction(0,0,__LINE__);
+                obj->setStatus(ObjectStatus::ConcurrentRecompute,true);
+                auto job = new RecomputeJob(obj,d);
+                running[obj].reset(job);
+                pool.start(job);
+            }
+
+            // Objects that are not thread safe are recomputed while the workers are busy
+            if(serialObj)
+                handleResult(serialObj,true,_recomputeFeature(serialObj));
+            else if(running.size())
+                collectJobs(true);
+            else
+                break;
+        }
+    }
+    catch(...) {
+        // let the running workers finish before handing the exception over
+        aborted = true;
+        seq.reset();
+        while(running.size()) {
+            try {
+                collectJobs(true);
+            }
+            catch(...) {
+            }
+        }
+        throw;
+    }
+
+    while(running.size())
+        collectJobs(true);
+
+    if(aborted)
+        return objectCount;
+
+    // Objects left over are part of a dependency cycle, handle them in the
+    // sorted order as the serial recompute does
+    for(auto obj : objs) {
+        if(pending[obj] < 0)
+            continue;
+        if(!obj->getNameInDocument() || filter.find(obj)!=filter.end()) {
+            pending[obj] = -1;
+            continue;
+        }
+        bool doRecompute = obj->mustRecompute();
+        int res = 0;
+        if(doRecompute) {
+            ++objectCount;
+            res = _recomputeFeature(obj);
+        }
+        handleResult(obj,doRecompute,res);
+        if(aborted)
+            break;
+    }
+    return objectCount;
+}
+
 bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
 {
     // delete recompute log
@@ -195,6 +195,11 @@ public:
             bool delaySignal=false, const std::set<std::string> &objNames={});
     void afterRestore(bool checkPartial=false);
     bool afterRestore(const std::vector<App::DocumentObject *> &, bool checkPartial=false);
+    /** Read the data files of the given objects which have been skipped when
+     * restoring with the preference LazyFileLoading. Otherwise they are read
+     * when the property is accessed for the first time.
+     */
+    void prefetchFiles(const std::vector<App::DocumentObject *> &objs) const;
     enum ExportStatus {
         NotExporting,
         Exporting,
@@ -386,9 +391,13 @@ public:
     /// If no transaction is open true is returned.
     bool isTransactionEmpty() const;
     /// Set the Undo limit in Byte!
-    void setUndoLimit(unsigned int UndoMemSize=0);
-    /// Returns the actual memory consumption of the Undo redo stuff.
-    unsigned int getUndoMemSize (void) const;
+    void setUndoLimit(std::size_t UndoMemSize=0);
+    /// Returns the Undo limit in Byte
+    std::size_t getUndoLimit() const;
+    /** Returns the actual memory consumption of the Undo redo stuff.
+     * Older versions returned the limit set with setUndoLimit() instead.
+     */
+    std::size_t getUndoMemSize (void) const;
     /// Set the Undo limit as stack size
     void setMaxUndoStackSize(unsigned int UndoMaxStackSize=20);
     /// Set the Undo limit as stack size
@@ -520,6 +529,16 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /** helper which recomputes the given sorted objects using worker threads
+     * for objects with ObjectStatus::ThreadSafeExecute set. All other objects
+     * are recomputed in the calling thread.
+     * @return the number of recomputed objects
+     */
+    int _recomputeConcurrently(const std::vector<App::DocumentObject*> &objs,
+            std::set<App::DocumentObject*> &filter, bool *hasError, bool canAbort, bool &aborted);
+    /// emit the signals that were postponed while the object was executed in a worker thread
+    void _signalConcurrentBeforeChanges();
+    void _replayConcurrentChanges(DocumentObject* Feat);
     void _clearRedos();
 
     /// refresh the internal dependency graph
@@ -678,7 +678,10 @@ void DocumentObject::onBeforeChange(const Property* prop)
     if (_pDoc)
         onBeforeChangeProperty(_pDoc, prop);
 
-    signalBeforeChange(*this,*prop);
+    // Signals of an object executed in a worker thread are emitted by the
+    // document in the main thread, see Document::recompute()
+    if (!testStatus(ObjectStatus::ConcurrentRecompute))
+        signalBeforeChange(*this,*prop);
 }
 
 /// get called by the container when a Property was changed
@@ -705,7 +708,8 @@ void DocumentObject::onChanged(const Property* prop)
     // if (_pDoc)
     //     _pDoc->onChangedProperty(this,prop);
 
-    if (prop == &Label && _pDoc && oldLabel != Label.getStrValue())
+    if (prop == &Label && _pDoc && oldLabel != Label.getStrValue()
+            && !testStatus(ObjectStatus::ConcurrentRecompute))
         _pDoc->signalRelabelObject(*this);
 
     // set object touched if it is an input property
@@ -729,7 +733,8 @@ void DocumentObject::onChanged(const Property* prop)
     if (_pDoc)
         _pDoc->onChangedProperty(this,prop);
 
-    signalChanged(*this,*prop);
+    if (!testStatus(ObjectStatus::ConcurrentRecompute))
+        signalChanged(*this,*prop);
 }
 
 void DocumentObject::clearOutListCache() const {
@@ -62,6 +62,8 @@ enum ObjectStatus {
     NoTouch = 14, // no touch on any property change
     GeoExcluded = 15, // mark as a member but not claimed by GeoFeatureGroup
     Expand = 16,
+    ThreadSafeExecute = 17, // set by the object if its execute() may run in a worker thread of a parallel recompute
+    ConcurrentRecompute = 18, // set by Document while the object is being executed in a worker thread
 };
 
 /** Return object for feature execution
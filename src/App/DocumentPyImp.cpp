@@ -491,6 +491,35 @@ PyObject*  DocumentPy::recompute(PyObject * args)
     } PY_CATCH;
 }
 
+PyObject*  DocumentPy::prefetchFiles(PyObject * args)
+{
+    PyObject *pyobjs = Py_None;
+    if (!PyArg_ParseTuple(args, "|O",&pyobjs))
+        return NULL;
+    PY_TRY {
+        std::vector<App::DocumentObject *> objs;
+        if(pyobjs==Py_None) {
+            objs = getDocumentPtr()->getObjects();
+        }
+        else {
+            if(!PySequence_Check(pyobjs)) {
+                PyErr_SetString(PyExc_TypeError, "expect input of sequence of document objects");
+                return 0;
+            }
+            Py::Sequence seq(pyobjs);
+            for(size_t i=0;i<seq.size();++i) {
+                if(!PyObject_TypeCheck(seq[i].ptr(),&DocumentObjectPy::Type)) {
+                    PyErr_SetString(PyExc_TypeError, "Expect element in sequence to be of type document object");
+                    return 0;
+                }
+                objs.push_back(static_cast<DocumentObjectPy*>(seq[i].ptr())->getDocumentObjectPtr());
+            }
+        }
+        getDocumentPtr()->prefetchFiles(objs);
+        Py_Return;
+    } PY_CATCH;
+}
+
 PyObject*  DocumentPy::getObject(PyObject *args)
 {
     long id = -1;
@@ -633,7 +662,7 @@ void  DocumentPy::setUndoMode(Py::Int arg)
 
 Py::Int DocumentPy::getUndoRedoMemSize(void) const
 {
-    return Py::Int((long)getDocumentPtr()->getUndoMemSize());
+    return Py::Int(static_cast<unsigned PY_LONG_LONG>(getDocumentPtr()->getUndoMemSize()));
 }
 
 Py::Int DocumentPy::getUndoCount(void) const
@@ -37,6 +37,7 @@
 #include <App/Document.h>
 #include <App/DocumentPy.h>
 #include <App/DocumentObject.h>
+#include <App/Link.h>
 #include <App/PropertyUnits.h>
 #include <Base/QuantityPy.h>
 #include <QStringList>
@@ -47,6 +48,7 @@
 #include <stack>
 #include <deque>
 #include <algorithm>
+#include <atomic>
 #include "Expression.h"
 #include <Base/Unit.h>
 #include <App/PropertyUnits.h>
@@ -215,6 +217,10 @@ std::string unquote(const std::string & input)
 //
 // ExpressionVistor
 //
+void ExpressionVisitor::aboutToChange() {
+    CompiledExpression::invalidateBindings();
+}
+
 void ExpressionVisitor::getDeps(Expression &e, ExpressionDeps &deps) {
     e._getDeps(deps);
 }
@@ -1101,7 +1107,6 @@ Expression * OperatorExpression::eval() const
     NumberExpression * v1;
     std::unique_ptr<Expression> e2(right->eval());
     NumberExpression * v2;
-    Expression * output;
 
     v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
@@ -1109,71 +1114,74 @@ Expression * OperatorExpression::eval() const
     if (v1 == 0 || v2 == 0)
         throw ExpressionError("Invalid expression");
 
+    Quantity output = calc(op, v1->getQuantity(), v2->getQuantity());
+
+    if (op >= EQ && op <= GTE)
+        return new BooleanExpression(owner, output.getValue() != 0.0);
+    return new NumberExpression(owner, output);
+}
+
+/**
+  * Apply the operator \a op to the evaluated operands \a v1 and \a v2.
+  * Comparisons return 1 or 0. Throws an ExpressionError exception if the
+  * units of the operands do not match.
+  *
+  * @returns The result of the operation.
+  */
+
+Quantity OperatorExpression::calc(Operator op, const Quantity &v1, const Quantity &v2)
+{
     switch (op) {
     case ADD:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for + operator");
-        output = new NumberExpression(owner, v1->getQuantity() + v2->getQuantity());
-        break;
+        return v1 + v2;
     case SUB:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for - operator");
-        output = new NumberExpression(owner, v1->getQuantity()- v2->getQuantity());
-        break;
+        return v1 - v2;
     case MUL:
     case UNIT:
-        output = new NumberExpression(owner, v1->getQuantity() * v2->getQuantity());
-        break;
+        return v1 * v2;
     case DIV:
-        output = new NumberExpression(owner, v1->getQuantity() / v2->getQuantity());
-        break;
+        return v1 / v2;
     case POW:
-        output = new NumberExpression(owner, v1->getQuantity().pow(v2->getQuantity()) );
-        break;
+        return v1.pow(v2);
     case EQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the = operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case NEQ:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the != operator");
-        output = new BooleanExpression(owner, !essentiallyEqual(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(!essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case LT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the < operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case GT:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the > operator");
-        output = new BooleanExpression(owner, definitelyGreaterThan(v1->getValue(), v2->getValue()) );
-        break;
+        return Quantity(definitelyGreaterThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case LTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the <= operator");
-        output = new BooleanExpression(owner, definitelyLessThan(v1->getValue(), v2->getValue()) ||
-                                       essentiallyEqual(v1->getValue(), v2->getValue()));
-        break;
+        return Quantity(definitelyLessThan(v1.getValue(), v2.getValue()) ||
+                        essentiallyEqual(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case GTE:
-        if (v1->getUnit() != v2->getUnit())
+        if (v1.getUnit() != v2.getUnit())
             throw ExpressionError("Incompatible units for the >= operator");
-        output = new BooleanExpression(owner, essentiallyEqual(v1->getValue(), v2->getValue()) ||
-                                       definitelyGreaterThan(v1->getValue(), v2->getValue()));
-        break;
+        return Quantity(essentiallyEqual(v1.getValue(), v2.getValue()) ||
+                        definitelyGreaterThan(v1.getValue(), v2.getValue()) ? 1.0 : 0.0);
     case NEG:
-        output = new NumberExpression(owner, -v1->getQuantity() );
-        break;
+        return -v1;
     case POS:
-        output = new NumberExpression(owner, v1->getQuantity() );
-        break;
+        return v1;
     default:
-        output = 0;
         assert(0);
     }
 
-    return output;
+    return Quantity();
 }
 
 /**
@@ -1674,13 +1682,34 @@ Expression * FunctionExpression::eval() const
     NumberExpression * v1 = freecad_dynamic_cast<NumberExpression>(e1.get());
     NumberExpression * v2 = freecad_dynamic_cast<NumberExpression>(e2.get());
     NumberExpression * v3 = freecad_dynamic_cast<NumberExpression>(e3.get());
-    double output;
-    Unit unit;
-    double scaler = 1;
 
     if (v1 == 0)
         throw ExpressionError("Invalid argument.");
 
+    if ((f == HYPOT || f == CATH) && args.size() > 2 && v2 && v3 == 0)
+        throw ExpressionError("Invalid second argument.");
+
+    Quantity q1 = v1->getQuantity();
+    Quantity q2 = v2 ? v2->getQuantity() : Quantity();
+    Quantity q3 = v3 ? v3->getQuantity() : Quantity();
+
+    return new NumberExpression(owner, calc(f, &q1, v2 ? &q2 : 0, v3 ? &q3 : 0));
+}
+
+/**
+  * Apply the non-aggregate function \a f to the evaluated arguments.
+  * \a v2 and \a v3 are null if the function was called with fewer arguments.
+  * Throws an ExpressionError exception if the arguments are invalid.
+  *
+  * @returns The result of the function.
+  */
+
+Quantity FunctionExpression::calc(Function f, const Quantity *v1, const Quantity *v2, const Quantity *v3)
+{
+    double output;
+    Unit unit;
+    double scaler = 1;
+
     double value = v1->getValue();
 
     /* Check units and arguments */
@@ -1783,12 +1812,8 @@ Expression * FunctionExpression::eval() const
         if (v1->getUnit() != v2->getUnit())
             throw ExpressionError("Units must be equal");
 
-        if (args.size() > 2) {
-            if (v3 == 0)
-                throw ExpressionError("Invalid second argument.");
-            if (v2->getUnit() != v3->getUnit())
-                throw ExpressionError("Units must be equal");
-        }
+        if (v3 && v2->getUnit() != v3->getUnit())
+            throw ExpressionError("Units must be equal");
         unit = v1->getUnit();
         break;
     default:
@@ -1876,7 +1901,7 @@ Expression * FunctionExpression::eval() const
         assert(0);
     }
 
-    return new NumberExpression(owner, Quantity(scaler * output, unit));
+    return Quantity(scaler * output, unit);
 }
 
 /**
@@ -2299,6 +2324,7 @@ void VariableExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVi
 void VariableExpression::setPath(const ObjectIdentifier &path)
 {
      var = path;
+     CompiledExpression::invalidateBindings();
 }
 
 //
@@ -2691,6 +2717,339 @@ void RangeExpression::_offsetCells(int rowOffset, int colOffset, ExpressionVisit
     }
 }
 
+//
+// CompiledExpression class
+//
+
+static std::atomic<unsigned int> _BindingGeneration;
+
+// Variables are resolved by object name, label and property name, so any
+// change of these may bind them to other properties.
+struct BindingMonitor {
+    BindingMonitor() {
+        auto &app = GetApplication();
+        auto objectChanged = [](const DocumentObject &) { CompiledExpression::invalidateBindings(); };
+        auto documentChanged = [](const Document &) { CompiledExpression::invalidateBindings(); };
+        auto propertyChanged = [](const Property &) { CompiledExpression::invalidateBindings(); };
+        app.signalNewObject.connect(objectChanged);
+        app.signalDeletedObject.connect(objectChanged);
+        app.signalRelabelObject.connect(objectChanged);
+        app.signalDeleteDocument.connect(documentChanged);
+        app.signalRenameDocument.connect(documentChanged);
+        app.signalRelabelDocument.connect(documentChanged);
+        app.signalAppendDynamicProperty.connect(propertyChanged);
+        app.signalRemoveDynamicProperty.connect(propertyChanged);
+    }
+};
+
+static inline bool anyToNumber(Quantity &res, const App::any &value) {
+    double d;
+    if (is_type(value,typeid(Quantity)))
+        res = cast<Quantity>(value);
+    else if (anyToDouble(d,value))
+        res = Quantity(d);
+    else
+        return false;
+    return true;
+}
+
+CompiledExpression::CompiledExpression()
+    : source(0), generation(0), valid(false)
+{
+}
+
+CompiledExpression::CompiledExpression(const CompiledExpression &)
+    : source(0), generation(0), valid(false)
+{
+}
+
+CompiledExpression::~CompiledExpression()
+{
+}
+
+CompiledExpression &CompiledExpression::operator=(const CompiledExpression &)
+{
+    reset();
+    return *this;
+}
+
+void CompiledExpression::reset()
+{
+    source = 0;
+    valid = false;
+    program.clear();
+    constants.clear();
+    variables.clear();
+    nodes.clear();
+}
+
+bool CompiledExpression::isConcurrent(const Expression *expr) const
+{
+    if (!valid || expr != source || generation != _BindingGeneration || !nodes.empty())
+        return false;
+
+    for (auto &v : variables) {
+        if (v.type == AnyValue)
+            return false;
+    }
+    return true;
+}
+
+void CompiledExpression::invalidateBindings()
+{
+    ++_BindingGeneration;
+}
+
+/**
+  * Check whether \a expr can be folded into a constant, i.e. it only consists
+  * of numbers, operators, conditionals and non-aggregate functions.
+  */
+
+bool CompiledExpression::isConstant(const Expression *expr) const
+{
+    if (freecad_dynamic_cast<NumberExpression>(expr))
+        return true;
+
+    auto op = freecad_dynamic_cast<OperatorExpression>(expr);
+    if (op)
+        return isConstant(op->getLeft()) && isConstant(op->getRight());
+
+    auto cond = freecad_dynamic_cast<ConditionalExpression>(expr);
+    if (cond)
+        return isConstant(cond->getCondition()) && isConstant(cond->getTrueExpression())
+            && isConstant(cond->getFalseExpression());
+
+    auto func = freecad_dynamic_cast<FunctionExpression>(expr);
+    if (func && func->getFunction() < FunctionExpression::AGGREGATES) {
+        for (auto arg : func->getArgs()) {
+            if (!isConstant(arg))
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool CompiledExpression::compile(const Expression *expr)
+{
+    reset();
+    source = expr;
+
+    if (!freecad_dynamic_cast<UnitExpression>(expr)
+            && !freecad_dynamic_cast<ConditionalExpression>(expr))
+        return false;
+
+    try {
+        return compileNode(expr);
+    }
+    catch (Base::Exception &) {
+        // Leave the error to be reported by Expression::eval()
+        return false;
+    }
+}
+
+bool CompiledExpression::compileNode(const Expression *expr)
+{
+    Instruction ins = {PushConstant, 0, 0};
+
+    if (isConstant(expr)) {
+        std::unique_ptr<Expression> e(expr->eval());
+        auto n = freecad_dynamic_cast<NumberExpression>(e.get());
+        if (!n)
+            return false;
+        ins.arg = static_cast<int>(constants.size());
+        constants.push_back(n->getQuantity());
+        program.push_back(ins);
+        return true;
+    }
+
+    auto op = freecad_dynamic_cast<OperatorExpression>(expr);
+    if (op) {
+        if (!compileNode(op->getLeft()) || !compileNode(op->getRight()))
+            return false;
+        ins.code = CallOperator;
+        ins.arg = op->getOperator();
+        program.push_back(ins);
+        return true;
+    }
+
+    auto cond = freecad_dynamic_cast<ConditionalExpression>(expr);
+    if (cond) {
+        if (!compileNode(cond->getCondition()))
+            return false;
+        std::size_t jumpToFalse = program.size();
+        ins.code = JumpIfFalse;
+        program.push_back(ins);
+        if (!compileNode(cond->getTrueExpression()))
+            return false;
+        std::size_t jumpToEnd = program.size();
+        ins.code = Jump;
+        program.push_back(ins);
+        program[jumpToFalse].arg = static_cast<int>(program.size());
+        if (!compileNode(cond->getFalseExpression()))
+            return false;
+        program[jumpToEnd].arg = static_cast<int>(program.size());
+        return true;
+    }
+
+    auto func = freecad_dynamic_cast<FunctionExpression>(expr);
+    if (func && func->getFunction() < FunctionExpression::AGGREGATES
+             && !func->getArgs().empty() && func->getArgs().size() <= 3) {
+        for (auto arg : func->getArgs()) {
+            if (!compileNode(arg))
+                return false;
+        }
+        ins.code = CallFunction;
+        ins.arg = func->getFunction();
+        ins.count = static_cast<int>(func->getArgs().size());
+        program.push_back(ins);
+        return true;
+    }
+
+    auto var = freecad_dynamic_cast<VariableExpression>(expr);
+    if (var) {
+        // Bind the property directly if the path resolves to a plain property
+        // of a document object, and not through a link or sub-object.
+        ObjectIdentifier path = var->getPath();
+        int ptype = 0;
+        const Property *prop = path.getProperty(&ptype);
+        if (!prop)
+            return false;
+        auto obj = freecad_dynamic_cast<DocumentObject>(prop->getContainer());
+        bool bindable = obj && ptype == 0 && path.getSubObjectName().empty()
+            && obj->getPropertyByName(path.getPropertyName().c_str()) == prop;
+        if (bindable && (prop->testStatus(Property::Hidden) || (prop->getType() & Prop_Hidden))) {
+            auto linked = obj->getLinkedObject(true);
+            bindable = (!linked || linked == obj)
+                && !obj->getExtensionByType<App::LinkBaseExtension>(true);
+        }
+        if (bindable) {
+            Variable v;
+            v.object = obj;
+            v.name = path.getPropertyName();
+            v.prop = prop;
+            v.type = AnyValue;
+            v.path = path;
+            // Read plain numeric properties directly, their getPathValue()
+            // would verify the path on every call
+            if (prop->isDerivedFrom(PropertyQuantity::getClassTypeId()))
+                v.type = QuantityValue;
+            else if (prop->isDerivedFrom(PropertyInteger::getClassTypeId()))
+                v.type = IntegerValue;
+            else if (path.verify(*prop, true)) {
+                if (prop->isDerivedFrom(PropertyFloat::getClassTypeId()))
+                    v.type = FloatValue;
+                else if (prop->isDerivedFrom(PropertyBool::getClassTypeId()))
+                    v.type = BoolValue;
+            }
+            ins.code = PushVariable;
+            ins.arg = static_cast<int>(variables.size());
+            variables.push_back(v);
+            program.push_back(ins);
+            return true;
+        }
+    }
+
+    // No flat form, use the expression tree for this node
+    ins.code = PushNode;
+    ins.arg = static_cast<int>(nodes.size());
+    nodes.push_back(expr);
+    program.push_back(ins);
+    return true;
+}
+
+bool CompiledExpression::eval(const Expression *expr, Quantity &result)
+{
+    static BindingMonitor monitor;
+    (void)monitor;
+
+    unsigned int current = _BindingGeneration;
+    if (expr != source || generation != current) {
+        generation = current;
+        valid = compile(expr);
+    }
+    if (!valid)
+        return false;
+
+    stack.clear();
+    for (std::size_t pc = 0; pc < program.size(); ++pc) {
+        const Instruction &ins = program[pc];
+
+        switch (ins.code) {
+        case PushConstant:
+            stack.push_back(constants[ins.arg]);
+            break;
+        case PushVariable: {
+            const Variable &v = variables[ins.arg];
+            if (v.object->getPropertyByName(v.name.c_str()) != v.prop) {
+                // The name resolves to another property by now, e.g. a
+                // re-assigned spreadsheet alias, so compile again next time
+                source = 0;
+                return false;
+            }
+            switch (v.type) {
+            case QuantityValue:
+                stack.push_back(static_cast<const PropertyQuantity*>(v.prop)->getQuantityValue());
+                break;
+            case FloatValue:
+                stack.push_back(Quantity(static_cast<const PropertyFloat*>(v.prop)->getValue()));
+                break;
+            case IntegerValue:
+                stack.push_back(Quantity(static_cast<const PropertyInteger*>(v.prop)->getValue()));
+                break;
+            case BoolValue:
+                stack.push_back(Quantity(static_cast<const PropertyBool*>(v.prop)->getValue() ? 1.0 : 0.0));
+                break;
+            default:
+                stack.emplace_back();
+                if (!anyToNumber(stack.back(), v.prop->getPathValue(v.path)))
+                    return false;
+            }
+            break;
+        }
+        case PushNode: {
+            std::unique_ptr<Expression> e(nodes[ins.arg]->eval());
+            auto n = freecad_dynamic_cast<NumberExpression>(e.get());
+            if (!n)
+                return false;
+            stack.push_back(n->getQuantity());
+            break;
+        }
+        case CallOperator: {
+            Quantity v2 = stack.back();
+            stack.pop_back();
+            stack.back() = OperatorExpression::calc(
+                    static_cast<OperatorExpression::Operator>(ins.arg), stack.back(), v2);
+            break;
+        }
+        case CallFunction: {
+            std::size_t first = stack.size() - ins.count;
+            Quantity output = FunctionExpression::calc(
+                    static_cast<FunctionExpression::Function>(ins.arg), &stack[first],
+                    ins.count > 1 ? &stack[first + 1] : 0,
+                    ins.count > 2 ? &stack[first + 2] : 0);
+            stack.resize(first);
+            stack.push_back(output);
+            break;
+        }
+        case JumpIfFalse: {
+            bool condition = fabs(stack.back().getValue()) > 0.5;
+            stack.pop_back();
+            if (!condition)
+                pc = ins.arg - 1;
+            break;
+        }
+        case Jump:
+            pc = ins.arg - 1;
+            break;
+        }
+    }
+
+    assert(stack.size() == 1);
+    result = stack.back();
+    return true;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////
 
@@ -57,7 +57,8 @@ class AppExport ExpressionVisitor {
 public:
     virtual ~ExpressionVisitor() {}
     virtual void visit(Expression &e) = 0;
-    virtual void aboutToChange() {}
+    /// Called before an expression is modified in place, invalidates compiled expressions
+    virtual void aboutToChange();
     virtual int changed() const { return 0;}
     virtual void reset() {}
     virtual App::PropertyLinkBase* getPropertyLink() {return 0;}
@@ -92,6 +93,7 @@ public:
     virtual ~ExpressionModifier() { }
 
     virtual void aboutToChange() override{
+        ExpressionVisitor::aboutToChange();
         ++_changed;
         signaller.aboutToChange();
     }
@@ -336,6 +338,8 @@ public:
 
     virtual void _visit(ExpressionVisitor & v);
 
+    static Base::Quantity calc(Operator op, const Base::Quantity &v1, const Base::Quantity &v2);
+
     Operator getOperator() const { return op; }
 
     Expression * getLeft() const { return left; }
@@ -376,6 +380,12 @@ public:
 
     virtual void _visit(ExpressionVisitor & v);
 
+    Expression * getCondition() const { return condition; }
+
+    Expression * getTrueExpression() const { return trueExpr; }
+
+    Expression * getFalseExpression() const { return falseExpr; }
+
 protected:
 
     Expression * condition;  /**< Condition */
@@ -451,6 +461,13 @@ public:
 
     virtual void _visit(ExpressionVisitor & v);
 
+    static Base::Quantity calc(Function f, const Base::Quantity *v1,
+            const Base::Quantity *v2 = 0, const Base::Quantity *v3 = 0);
+
+    Function getFunction() const { return f; }
+
+    const std::vector<Expression*> &getArgs() const { return args; }
+
 protected:
     Expression *evalAggregate() const;
 
@@ -607,6 +624,96 @@ protected:
     std::string end;
 };
 
+/**
+  * Flat evaluation form of a numeric expression.
+  *
+  * The expression tree is translated into a postfix program working on a stack
+  * of quantities. Sub-expressions without variables are folded into constants,
+  * and the properties referenced by variables are resolved once, so repeated
+  * evaluation neither allocates expression nodes nor resolves object
+  * identifiers again. Nodes that have no flat form (aggregates, strings,
+  * ranges, Python objects) are evaluated with Expression::eval().
+  *
+  * The program is rebuilt when a different expression is passed in, or when
+  * document objects, labels or dynamic properties change, since variables may
+  * then resolve to other properties.
+  */
+
+class AppExport CompiledExpression {
+public:
+    CompiledExpression();
+    CompiledExpression(const CompiledExpression &);
+    ~CompiledExpression();
+
+    CompiledExpression &operator=(const CompiledExpression &);
+
+    /** Evaluate \a expr into \a result, compiling it first if needed.
+      * Errors are reported by the same exceptions as Expression::eval().
+      *
+      * @returns false if the expression has no numeric result or cannot be
+      * compiled, the caller must then evaluate it with Expression::eval().
+      */
+    bool eval(const Expression *expr, Base::Quantity &result);
+
+    /** Check whether \a expr is compiled and its evaluation only reads plain
+      * numeric properties. Such expressions can be evaluated concurrently, as
+      * long as no thread modifies the properties they refer to.
+      */
+    bool isConcurrent(const Expression *expr) const;
+
+    /// Discard the compiled program
+    void reset();
+
+    /// Mark the property bindings of all compiled expressions as outdated
+    static void invalidateBindings();
+
+private:
+    bool compile(const Expression *expr);
+    bool compileNode(const Expression *expr);
+    bool isConstant(const Expression *expr) const;
+
+    enum OpCode {
+        PushConstant,
+        PushVariable,
+        PushNode,
+        CallOperator,
+        CallFunction,
+        JumpIfFalse,
+        Jump
+    };
+
+    struct Instruction {
+        OpCode code;
+        int arg;    /**< Constant, variable or node index, operator, function or jump target */
+        int count;  /**< Number of function arguments */
+    };
+
+    enum ValueType {
+        AnyValue,       /**< Read with Property::getPathValue() */
+        QuantityValue,
+        FloatValue,
+        IntegerValue,
+        BoolValue
+    };
+
+    struct Variable {
+        const App::DocumentObject *object; /**< Owner of the bound property */
+        std::string name;                  /**< Property name used for resolving */
+        const App::Property *prop;         /**< Property the path resolved to */
+        ValueType type;
+        ObjectIdentifier path;
+    };
+
+    const Expression *source;
+    unsigned int generation;
+    bool valid;
+    std::vector<Instruction> program;
+    std::vector<Base::Quantity> constants;
+    std::vector<Variable> variables;
+    std::vector<const Expression*> nodes;
+    std::vector<Base::Quantity> stack;
+};
+
 namespace ExpressionParser {
 AppExport Expression * parse(const App::DocumentObject *owner, const char *buffer);
 AppExport UnitExpression * parseUnit(const App::DocumentObject *owner, const char *buffer);
@@ -167,6 +167,8 @@ public:
         ADD_PROPERTY(Proxy,(Py::Object()));
         // cannot move this to the initializer list to avoid warning
         imp = new FeaturePythonImp(this);
+        // Python code must always be executed in the main thread
+        this->setStatus(App::ThreadSafeExecute, false);
     }
     virtual ~FeaturePythonT() {
         delete imp;
@@ -115,6 +115,8 @@ FeatureTest::FeatureTest()
   //ADD_PROPERTY(QuantityAngle,(1.0));
   //QuantityAngle.setUnit(Base::Unit::Angle);
 
+  // execute() only touches our own properties
+  setStatus(App::ThreadSafeExecute, true);
 }
 
 FeatureTest::~FeatureTest()
@@ -553,8 +553,14 @@ DocumentObjectExecReturn *App::PropertyExpressionEngine::execute(ExecuteOption o
         App::any value;
         try {
             // Evaluate expression
-            std::unique_ptr<Expression> e(expressions[*it].expression->eval());
-            value = e->getValueAsAny();
+            ExpressionInfo &info = expressions[*it];
+            Base::Quantity result;
+            if (info.compiled.eval(info.expression.get(), result))
+                value = result.getUnit().isEmpty() ? App::any(result.getValue()) : App::any(result);
+            else {
+                std::unique_ptr<Expression> e(info.expression->eval());
+                value = e->getValueAsAny();
+            }
             if(option == ExecuteOnRestore && prop->testStatus(Property::EvalOnRestore)) {
                 if(isAnyEqual(value, prop->getPathValue(*it)))
                     continue;
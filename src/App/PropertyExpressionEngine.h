@@ -85,6 +85,7 @@ public:
 
     struct ExpressionInfo {
         boost::shared_ptr<App::Expression> expression; /**< The actual expression tree */
+        App::CompiledExpression compiled; /**< Flat form of the expression, built on first evaluation */
 
         ExpressionInfo(boost::shared_ptr<App::Expression> expression = boost::shared_ptr<App::Expression>()) {
             this->expression = expression;
@@ -96,6 +97,7 @@ public:
 
         ExpressionInfo & operator=(const ExpressionInfo & other) {
             expression = other.expression;
+            compiled.reset();
             return *this;
         }
     };
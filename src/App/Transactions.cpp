@@ -24,7 +24,9 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <cassert>
+# include <climits>
 #endif
 
 #include <atomic>
@@ -111,7 +113,16 @@ int Transaction::getLastID() {
 
 unsigned int Transaction::getMemSize (void) const
 {
-    return 0;
+    return static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(), UINT_MAX));
+}
+
+std::size_t Transaction::getUndoMemSize() const
+{
+    std::size_t size = 0;
+    auto &index = _Objects.get<0>();
+    for (auto It = index.begin(); It != index.end(); ++It)
+        size += It->second->getUndoMemSize();
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -393,7 +404,19 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
 
 unsigned int TransactionObject::getMemSize (void) const
 {
-    return 0;
+    return static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(), UINT_MAX));
+}
+
+std::size_t TransactionObject::getUndoMemSize() const
+{
+    // Note: Properties that share their data with the document until it's
+    // modified (e.g. meshes or points) only count the memory of their own.
+    std::size_t size = 0;
+    for (auto &v : _PropChangeMap) {
+        if (v.second.property)
+            size += v.second.property->getMemSize();
+    }
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
@@ -65,6 +65,8 @@ public:
     std::string Name;
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory used by the saved values, without the 32-bit limit of getMemSize()
+    std::size_t getUndoMemSize() const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
@@ -120,6 +122,8 @@ public:
     void addOrRemoveProperty(const Property* pcProp, bool add);
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory used by the saved values, without the 32-bit limit of getMemSize()
+    std::size_t getUndoMemSize() const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
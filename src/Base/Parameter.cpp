@@ -52,6 +52,8 @@
 #   endif
 #   include <sstream>
 #   include <stdio.h>
+#   include <QMutex>
+#   include <QMutexLocker>
 #endif
 
 
@@ -189,6 +191,22 @@ inline bool DOMTreeErrorReporter::getSawErrors() const
 // ParameterManager
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+/** Lock of the group maps, the entry index and the cached values of all groups
+  * The getters are const and may be called from worker threads, so reading
+  * a value for the first time must not race with other readers. Looking up
+  * a group may create it, which is why the lock is recursive.
+  */
+static QMutex &ParamMutex()
+{
+    static QMutex mutex(QMutex::Recursive);
+    return mutex;
+}
+
+/// number of changes of the group structure, see ParameterGrp::GetGroupRevision()
+static std::atomic<unsigned long> ParamGroupRevision(1);
+
+/// element names of the entry types, in the order of ParameterGrp::ParamType
+static const char *ParamTypeNames[] = {"FCBool","FCInt","FCUInt","FCFloat","FCText"};
 
 //**************************************************************************
 // Construction/Destruction
@@ -198,6 +216,7 @@ inline bool DOMTreeErrorReporter::getSawErrors() const
   */
 ParameterGrp::ParameterGrp(XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *GroupNode,const char* sName)
         : Base::Handled(), Subject<const char*>(),_pGroupNode(GroupNode)
+        , _Indexed(false), _Revision(1)
 {
     if (sName) _cName=sName;
 }
@@ -295,6 +314,7 @@ void ParameterGrp::insert(const char* FileName)
 
 Base::Reference<ParameterGrp> ParameterGrp::GetGroup(const char* Name)
 {
+    QMutexLocker locker(&ParamMutex());
     std::string cName = Name;
 
     std::string::size_type pos = cName.find('/');
@@ -330,6 +350,7 @@ Base::Reference<ParameterGrp> ParameterGrp::GetGroup(const char* Name)
 
 Base::Reference<ParameterGrp> ParameterGrp::_GetGroup(const char* Name)
 {
+    QMutexLocker locker(&ParamMutex());
     Base::Reference<ParameterGrp> rParamGrp;
     DOMElement *pcTemp;
 
@@ -356,6 +377,7 @@ std::vector<Base::Reference<ParameterGrp> > ParameterGrp::GetGroups(void)
     DOMElement *pcTemp; //= _pGroupNode->getFirstChild();
     std::string Name;
 
+    QMutexLocker locker(&ParamMutex());
     pcTemp = FindElement(_pGroupNode,"FCParamGroup");
 
     while (pcTemp) {
@@ -385,6 +407,7 @@ bool ParameterGrp::IsEmpty(void) const
 /// test if a special sub group is in this group
 bool ParameterGrp::HasGroup(const char* Name) const
 {
+    QMutexLocker locker(&ParamMutex());
     if ( _GroupMap.find(Name) != _GroupMap.end() )
         return true;
 
@@ -396,23 +419,31 @@ bool ParameterGrp::HasGroup(const char* Name) const
 
 bool ParameterGrp::GetBool(const char* Name, bool bPreset) const
 {
+    QMutexLocker locker(&ParamMutex());
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCBool",Name);
+    ParamEntry *pcEntry = FindEntry(ParamBool,Name);
     // if not return preset
-    if (!pcElem) return bPreset;
+    if (!pcEntry) return bPreset;
     // if yes check the value and return
-    if (strcmp(StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str(),"1"))
-        return false;
-    else
-        return true;
+    if (!pcEntry->cached) {
+        pcEntry->bValue = !strcmp(StrX(pcEntry->element->getAttribute(XStr("Value").unicodeForm())).c_str(),"1");
+        pcEntry->cached = true;
+    }
+    return pcEntry->bValue;
 }
 
 void  ParameterGrp::SetBool(const char* Name, bool bValue)
 {
-    // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCBool",Name);
-    // and set the value
-    pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(bValue?"1":"0").unicodeForm());
+    {
+        QMutexLocker locker(&ParamMutex());
+        // find or create the Element
+        ParamEntry *pcEntry = FindOrCreateEntry(ParamBool,Name);
+        // and set the value
+        pcEntry->element->setAttribute(XStr("Value").unicodeForm(), XStr(bValue?"1":"0").unicodeForm());
+        pcEntry->bValue = bValue;
+        pcEntry->cached = true;
+        ++_Revision;
+    }
     // trigger observer
     Notify(Name);
 }
@@ -463,22 +494,33 @@ std::vector<std::pair<std::string,bool> > ParameterGrp::GetBoolMap(const char *
 
 long ParameterGrp::GetInt(const char* Name, long lPreset) const
 {
+    QMutexLocker locker(&ParamMutex());
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCInt",Name);
+    ParamEntry *pcEntry = FindEntry(ParamInt,Name);
     // if not return preset
-    if (!pcElem) return lPreset;
+    if (!pcEntry) return lPreset;
     // if yes check the value and return
-    return atol (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str());
+    if (!pcEntry->cached) {
+        pcEntry->lValue = atol (StrX(pcEntry->element->getAttribute(XStr("Value").unicodeForm())).c_str());
+        pcEntry->cached = true;
+    }
+    return pcEntry->lValue;
 }
 
 void  ParameterGrp::SetInt(const char* Name, long lValue)
 {
     char cBuf[256];
-    // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCInt",Name);
-    // and set the value
-    sprintf(cBuf,"%li",lValue);
-    pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+    {
+        QMutexLocker locker(&ParamMutex());
+        // find or create the Element
+        ParamEntry *pcEntry = FindOrCreateEntry(ParamInt,Name);
+        // and set the value
+        sprintf(cBuf,"%li",lValue);
+        pcEntry->element->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcEntry->lValue = lValue;
+        pcEntry->cached = true;
+        ++_Revision;
+    }
     // trigger observer
     Notify(Name);
 }
@@ -524,22 +566,33 @@ std::vector<std::pair<std::string,long> > ParameterGrp::GetIntMap(const char * s
 
 unsigned long ParameterGrp::GetUnsigned(const char* Name, unsigned long lPreset) const
 {
+    QMutexLocker locker(&ParamMutex());
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCUInt",Name);
+    ParamEntry *pcEntry = FindEntry(ParamUnsigned,Name);
     // if not return preset
-    if (!pcElem) return lPreset;
+    if (!pcEntry) return lPreset;
     // if yes check the value and return
-    return strtoul (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str(),0,10);
+    if (!pcEntry->cached) {
+        pcEntry->uValue = strtoul (StrX(pcEntry->element->getAttribute(XStr("Value").unicodeForm())).c_str(),0,10);
+        pcEntry->cached = true;
+    }
+    return pcEntry->uValue;
 }
 
 void  ParameterGrp::SetUnsigned(const char* Name, unsigned long lValue)
 {
     char cBuf[256];
-    // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCUInt",Name);
-    // and set the value
-    sprintf(cBuf,"%lu",lValue);
-    pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+    {
+        QMutexLocker locker(&ParamMutex());
+        // find or create the Element
+        ParamEntry *pcEntry = FindOrCreateEntry(ParamUnsigned,Name);
+        // and set the value
+        sprintf(cBuf,"%lu",lValue);
+        pcEntry->element->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcEntry->uValue = lValue;
+        pcEntry->cached = true;
+        ++_Revision;
+    }
     // trigger observer
     Notify(Name);
 }
@@ -585,22 +638,34 @@ std::vector<std::pair<std::string,unsigned long> > ParameterGrp::GetUnsignedMap(
 
 double ParameterGrp::GetFloat(const char* Name, double dPreset) const
 {
+    QMutexLocker locker(&ParamMutex());
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCFloat",Name);
+    ParamEntry *pcEntry = FindEntry(ParamFloat,Name);
     // if not return preset
-    if (!pcElem) return dPreset;
+    if (!pcEntry) return dPreset;
     // if yes check the value and return
-    return atof (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str());
+    if (!pcEntry->cached) {
+        pcEntry->fValue = atof (StrX(pcEntry->element->getAttribute(XStr("Value").unicodeForm())).c_str());
+        pcEntry->cached = true;
+    }
+    return pcEntry->fValue;
 }
 
 void  ParameterGrp::SetFloat(const char* Name, double dValue)
 {
     char cBuf[256];
-    // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCFloat",Name);
-    // and set the value
-    sprintf(cBuf,"%.12f",dValue); // use %.12f instead of %f to handle values < 1.0e-6
-    pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+    {
+        QMutexLocker locker(&ParamMutex());
+        // find or create the Element
+        ParamEntry *pcEntry = FindOrCreateEntry(ParamFloat,Name);
+        // and set the value
+        sprintf(cBuf,"%.12f",dValue); // use %.12f instead of %f to handle values < 1.0e-6
+        pcEntry->element->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        // cache the stored value, which is rounded
+        pcEntry->fValue = atof(cBuf);
+        pcEntry->cached = true;
+        ++_Revision;
+    }
     // trigger observer
     Notify(Name);
 }
@@ -660,17 +725,24 @@ void ParameterGrp::GetBlob(const char* /*Name*/, void* /*pBuf*/, long /*lMaxLeng
 
 void  ParameterGrp::SetASCII(const char* Name, const char *sValue)
 {
-    // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCText",Name);
-    // and set the value
-    DOMNode *pcElem2 = pcElem->getFirstChild();
-    if (!pcElem2) {
-        XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *pDocument = _pGroupNode->getOwnerDocument();
-        DOMText *pText = pDocument->createTextNode(XUTF8Str(sValue).unicodeForm());
-        pcElem->appendChild(pText);
-    }
-    else {
-        pcElem2->setNodeValue(XUTF8Str(sValue).unicodeForm());
+    {
+        QMutexLocker locker(&ParamMutex());
+        // find or create the Element
+        ParamEntry *pcEntry = FindOrCreateEntry(ParamText,Name);
+        DOMElement *pcElem = pcEntry->element;
+        // and set the value
+        DOMNode *pcElem2 = pcElem->getFirstChild();
+        if (!pcElem2) {
+            XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *pDocument = _pGroupNode->getOwnerDocument();
+            DOMText *pText = pDocument->createTextNode(XUTF8Str(sValue).unicodeForm());
+            pcElem->appendChild(pText);
+        }
+        else {
+            pcElem2->setNodeValue(XUTF8Str(sValue).unicodeForm());
+        }
+        // read back on the next access, the text may not be valid UTF-8
+        pcEntry->cached = false;
+        ++_Revision;
     }
     // trigger observer
     Notify(Name);
@@ -679,19 +751,25 @@ void  ParameterGrp::SetASCII(const char* Name, const char *sValue)
 
 std::string ParameterGrp::GetASCII(const char* Name, const char * pPreset) const
 {
+    QMutexLocker locker(&ParamMutex());
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCText",Name);
+    ParamEntry *pcEntry = FindEntry(ParamText,Name);
     // if not return preset
-    if (!pcElem) {
+    if (!pcEntry) {
         if (pPreset==0)
             return std::string("");
         else
             return std::string(pPreset);
     }
     // if yes check the value and return
-    DOMNode *pcElem2 = pcElem->getFirstChild();
-    if (pcElem2)
-        return std::string(StrXUTF8(pcElem2->getNodeValue()).c_str());
+    if (pcEntry->cached)
+        return pcEntry->sValue;
+    DOMNode *pcElem2 = pcEntry->element->getFirstChild();
+    if (pcElem2) {
+        pcEntry->sValue = StrXUTF8(pcElem2->getNodeValue()).c_str();
+        pcEntry->cached = true;
+        return pcEntry->sValue;
+    }
     else if (pPreset==0)
         return std::string("");
 
@@ -748,43 +826,58 @@ std::vector<std::pair<std::string,std::string> > ParameterGrp::GetASCIIMap(const
 
 void ParameterGrp::RemoveGrp(const char* Name)
 {
-    // remove group handle
-    _GroupMap.erase(Name);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // remove group handle
+        _GroupMap.erase(Name);
+        ++ParamGroupRevision;
+
+        // check if Element in group
+        DOMElement *pcElem = FindElement(_pGroupNode,"FCParamGroup",Name);
+        // if not return
+        if (!pcElem)
+            return;
+        else
+            _pGroupNode->removeChild(pcElem);
+    }
 
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCParamGroup",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
     // trigger observer
     Notify(Name);
 }
 
 void ParameterGrp::RemoveASCII(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCText",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // check if Element in group
+        ParamEntry *pcEntry = FindEntry(ParamText,Name);
+        // if not return
+        if (!pcEntry)
+            return;
+        else
+            _pGroupNode->removeChild(pcEntry->element);
+        // another element of the same name may become visible
+        ResetIndex();
+    }
+
     // trigger observer
     Notify(Name);
-
 }
 
 void ParameterGrp::RemoveBool(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCBool",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // check if Element in group
+        ParamEntry *pcEntry = FindEntry(ParamBool,Name);
+        // if not return
+        if (!pcEntry)
+            return;
+        else
+            _pGroupNode->removeChild(pcEntry->element);
+        // another element of the same name may become visible
+        ResetIndex();
+    }
 
     // trigger observer
     Notify(Name);
@@ -805,13 +898,18 @@ void ParameterGrp::RemoveBlob(const char* /*Name*/)
 
 void ParameterGrp::RemoveFloat(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCFloat",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // check if Element in group
+        ParamEntry *pcEntry = FindEntry(ParamFloat,Name);
+        // if not return
+        if (!pcEntry)
+            return;
+        else
+            _pGroupNode->removeChild(pcEntry->element);
+        // another element of the same name may become visible
+        ResetIndex();
+    }
 
     // trigger observer
     Notify(Name);
@@ -819,13 +917,18 @@ void ParameterGrp::RemoveFloat(const char* Name)
 
 void ParameterGrp::RemoveInt(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCInt",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // check if Element in group
+        ParamEntry *pcEntry = FindEntry(ParamInt,Name);
+        // if not return
+        if (!pcEntry)
+            return;
+        else
+            _pGroupNode->removeChild(pcEntry->element);
+        // another element of the same name may become visible
+        ResetIndex();
+    }
 
     // trigger observer
     Notify(Name);
@@ -833,13 +936,18 @@ void ParameterGrp::RemoveInt(const char* Name)
 
 void ParameterGrp::RemoveUnsigned(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCUInt",Name);
-    // if not return
-    if (!pcElem)
-        return;
-    else
-        _pGroupNode->removeChild(pcElem);
+    {
+        QMutexLocker locker(&ParamMutex());
+        // check if Element in group
+        ParamEntry *pcEntry = FindEntry(ParamUnsigned,Name);
+        // if not return
+        if (!pcEntry)
+            return;
+        else
+            _pGroupNode->removeChild(pcEntry->element);
+        // another element of the same name may become visible
+        ResetIndex();
+    }
 
     // trigger observer
     Notify(Name);
@@ -848,6 +956,7 @@ void ParameterGrp::RemoveUnsigned(const char* Name)
 void ParameterGrp::Clear(void)
 {
     std::vector<DOMNode*> vecNodes;
+    QMutexLocker locker(&ParamMutex());
 
     // checking on references
     std::map <std::string ,Base::Reference<ParameterGrp> >::iterator It1;
@@ -856,6 +965,7 @@ void ParameterGrp::Clear(void)
             Console().Warning("ParameterGrp::Clear(): Group clear with active references");
     // remove group handles
     _GroupMap.clear();
+    ++ParamGroupRevision;
 
     // searching all nodes
     for (DOMNode *clChild = _pGroupNode->getFirstChild(); clChild != 0;  clChild = clChild->getNextSibling()) {
@@ -863,12 +973,14 @@ void ParameterGrp::Clear(void)
     }
 
     // deleting the nodes
+    ResetIndex();
     DOMNode* pcTemp;
     for (std::vector<DOMNode*>::iterator It=vecNodes.begin();It!=vecNodes.end();++It) {
         pcTemp = _pGroupNode->removeChild(*It);
         //delete pcTemp;
         pcTemp->release();
     }
+    locker.unlock();
     // trigger observer
     Notify(0);
 }
@@ -929,6 +1041,78 @@ XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *ParameterGrp::FindOrCreateElement(XER
     return pcElem;
 }
 
+ParameterGrp::ParamEntry *ParameterGrp::FindEntry(ParamType Type, const char* Name) const
+{
+    if (!_Indexed) {
+        for (DOMNode *clChild = _pGroupNode->getFirstChild(); clChild != 0;  clChild = clChild->getNextSibling()) {
+            if (clChild->getNodeType() != DOMNode::ELEMENT_NODE)
+                continue;
+            std::string cType = StrX(clChild->getNodeName()).c_str();
+            for (int i=0; i<ParamTypeCount; i++) {
+                if (cType != ParamTypeNames[i])
+                    continue;
+                DOMNode *pcName = clChild->getAttributes()->getNamedItem(XStr("Name").unicodeForm());
+                if (pcName) {
+                    ParamEntry entry;
+                    entry.element = static_cast<DOMElement*>(clChild);
+                    entry.cached = false;
+                    // like FindElement() the first element of a name wins
+                    _EntryMap[i].insert(std::make_pair(std::string(StrX(pcName->getNodeValue()).c_str()), entry));
+                }
+                break;
+            }
+        }
+        _Indexed = true;
+    }
+
+    std::unordered_map<std::string, ParamEntry>::iterator it = _EntryMap[Type].find(Name);
+    if (it == _EntryMap[Type].end())
+        return 0;
+    return &it->second;
+}
+
+ParameterGrp::ParamEntry *ParameterGrp::FindOrCreateEntry(ParamType Type, const char* Name)
+{
+    // first try to find it
+    ParamEntry *pcEntry = FindEntry(Type,Name);
+
+    if (!pcEntry) {
+        XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *pDocument = _pGroupNode->getOwnerDocument();
+
+        ParamEntry entry;
+        entry.element = pDocument->createElement(XStr(ParamTypeNames[Type]).unicodeForm());
+        entry.element->setAttribute(XStr("Name").unicodeForm(), XStr(Name).unicodeForm());
+        entry.cached = false;
+        _pGroupNode->appendChild(entry.element);
+        pcEntry = &_EntryMap[Type].insert(std::make_pair(std::string(Name), entry)).first->second;
+    }
+
+    return pcEntry;
+}
+
+void ParameterGrp::ResetIndex(void)
+{
+    for (int i=0; i<ParamTypeCount; i++)
+        _EntryMap[i].clear();
+    _Indexed = false;
+    ++_Revision;
+}
+
+void ParameterGrp::RebindGroups(void)
+{
+    ResetIndex();
+    std::map <std::string ,Base::Reference<ParameterGrp> >::iterator It;
+    for (It = _GroupMap.begin(); It != _GroupMap.end(); ++It) {
+        It->second->_pGroupNode = FindOrCreateElement(_pGroupNode,"FCParamGroup",It->first.c_str());
+        It->second->RebindGroups();
+    }
+}
+
+unsigned long ParameterGrp::GetGroupRevision(void)
+{
+    return ParamGroupRevision.load(std::memory_order_acquire);
+}
+
 void ParameterGrp::NotifyAll()
 {
     // get all ints and notify
@@ -1238,6 +1422,10 @@ int ParameterManager::LoadDocument(const XERCES_CPP_NAMESPACE_QUALIFIER InputSou
     if (!_pGroupNode)
         throw XMLBaseException("Malformed Parameter document: Root group not found");
 
+    QMutexLocker locker(&ParamMutex());
+    RebindGroups();
+    ++ParamGroupRevision;
+
     return 1;
 }
 
@@ -1385,6 +1573,10 @@ void  ParameterManager::CreateDocument(void)
     _pGroupNode = _pDocument->createElement(XStr("FCParamGroup").unicodeForm());
     ((DOMElement*)_pGroupNode)->setAttribute(XStr("Name").unicodeForm(), XStr("Root").unicodeForm());
     rootElem->appendChild(_pGroupNode);
+
+    QMutexLocker locker(&ParamMutex());
+    RebindGroups();
+    ++ParamGroupRevision;
 }
 
 void  ParameterManager::CheckDocument() const
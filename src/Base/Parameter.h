@@ -51,7 +51,10 @@
 #include <sstream>
 #endif
 
+#include <atomic>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <xercesc/util/XercesDefs.hpp>
 
@@ -229,6 +232,19 @@ public:
      */
     void NotifyAll();
 
+    /** Returns the number of modifications of the entries of this group.
+     *  It can be used to cheaply find out whether a value read before is
+     *  still up to date, see ParameterValue.
+     */
+    unsigned long GetRevision(void) const {
+        return _Revision.load(std::memory_order_acquire);
+    }
+    /** Returns the number of changes of the group structure of all parameter sets.
+     *  It is increased whenever a group is removed or a set is loaded, i.e.
+     *  when a held group handle may not be part of its set any more.
+     */
+    static unsigned long GetGroupRevision(void);
+
 protected:
     /// constructor is protected (handle concept)
     ParameterGrp(XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *GroupNode=0L,const char* sName=0L);
@@ -254,6 +270,51 @@ protected:
      */
     XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *FindOrCreateElement(XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *Start, const char* Type, const char* Name) const;
 
+    /// types of the entries held in the index
+    enum ParamType {
+        ParamBool,
+        ParamInt,
+        ParamUnsigned,
+        ParamFloat,
+        ParamText,
+        ParamTypeCount
+    };
+
+    /// element of an entry, and its value once it has been read
+    struct ParamEntry {
+        XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *element;
+        bool cached;
+        union {
+            bool bValue;
+            long lValue;
+            unsigned long uValue;
+            double fValue;
+        };
+        std::string sValue;
+    };
+
+    /** Find the entry of Type with the attribute Name=Name
+     *  The first call indexes all entries of this group, so that further
+     *  calls only need a hash lookup. Returns NULL if there is no such entry.
+     *  The caller must hold the lock of the parameter cache.
+     */
+    ParamEntry *FindEntry(ParamType Type, const char* Name) const;
+
+    /** Find the entry of Type with the attribute Name=Name or create it if not found
+     *  The caller must hold the lock of the parameter cache.
+     */
+    ParamEntry *FindOrCreateEntry(ParamType Type, const char* Name);
+
+    /** Discard the index after the elements of this group were removed or replaced
+     *  The caller must hold the lock of the parameter cache.
+     */
+    void ResetIndex(void);
+    /** Bind the sub-groups to the elements of the same name below this group
+     *  after the document has been replaced, and discard their indexes.
+     *  The caller must hold the lock of the parameter cache.
+     */
+    void RebindGroups(void);
+
 
     /// DOM Node of the Base node of this group
     XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *_pGroupNode;
@@ -261,7 +322,106 @@ protected:
     std::string _cName;
     /// map of already exported groups
     std::map <std::string ,Base::Reference<ParameterGrp> > _GroupMap;
+    /// index of the entries of this group, by type and name
+    mutable std::unordered_map<std::string, ParamEntry> _EntryMap[ParamTypeCount];
+    /// true once _EntryMap holds all entries of this group
+    mutable bool _Indexed;
+    /// number of modifications of the entries
+    std::atomic<unsigned long> _Revision;
+
+};
+
+/** A handle to a single parameter that can be held by the caller
+ *  The value is only read again from the group after the group has been
+ *  modified. This makes it suitable for code that is run very often, e.g.
+ *  @code
+ *  static ParameterValue<bool> canAbort(App::GetApplication().GetUserParameter(),
+ *      "BaseApp/Preferences/Document", "CanAbortRecompute", true);
+ *  if (canAbort) ...
+ *  @endcode
+ *  The group is held by its path below a parameter set, which must outlive
+ *  the handle. If a group is removed or the set is loaded again the group
+ *  is looked up again, so the handle never refers to a detached group.
+ *  T can be bool, long, unsigned long, double or std::string. Unlike the
+ *  getters of ParameterGrp a handle must not be used from several threads.
+ */
+template <typename T>
+class ParameterValue
+{
+public:
+    ParameterValue(ParameterGrp &Root, const char* Path, const char* Name, const T &Preset)
+        : _pRoot(&Root), _cPath(Path), _cName(Name), _Preset(Preset), _Value(Preset)
+        , _Revision(0), _GroupRevision(0) {
+    }
 
+    /// returns the value of the parameter, or the preset if it is not set
+    const T &getValue(void) const {
+        const Base::Reference<ParameterGrp> &hGrp = getGroup();
+        unsigned long rev = hGrp->GetRevision();
+        if (rev != _Revision) {
+            _Value = Read(*hGrp, _cName.c_str(), _Preset);
+            _Revision = rev;
+        }
+        return _Value;
+    }
+    operator const T &() const {
+        return getValue();
+    }
+    /// sets the value of the parameter, and notifies the observers of the group
+    void setValue(const T &Value) {
+        Write(*getGroup(), _cName.c_str(), Value);
+    }
+    /// returns the group of the parameter
+    const Base::Reference<ParameterGrp> &getGroup(void) const {
+        unsigned long rev = ParameterGrp::GetGroupRevision();
+        if (rev != _GroupRevision || !_hGrp.isValid()) {
+            _hGrp = _pRoot->GetGroup(_cPath.c_str());
+            _GroupRevision = rev;
+            _Revision = 0;
+        }
+        return _hGrp;
+    }
+
+private:
+    static bool Read(const ParameterGrp &Grp, const char* Name, bool Preset) {
+        return Grp.GetBool(Name, Preset);
+    }
+    static long Read(const ParameterGrp &Grp, const char* Name, long Preset) {
+        return Grp.GetInt(Name, Preset);
+    }
+    static unsigned long Read(const ParameterGrp &Grp, const char* Name, unsigned long Preset) {
+        return Grp.GetUnsigned(Name, Preset);
+    }
+    static double Read(const ParameterGrp &Grp, const char* Name, double Preset) {
+        return Grp.GetFloat(Name, Preset);
+    }
+    static std::string Read(const ParameterGrp &Grp, const char* Name, const std::string &Preset) {
+        return Grp.GetASCII(Name, Preset.c_str());
+    }
+    static void Write(ParameterGrp &Grp, const char* Name, bool Value) {
+        Grp.SetBool(Name, Value);
+    }
+    static void Write(ParameterGrp &Grp, const char* Name, long Value) {
+        Grp.SetInt(Name, Value);
+    }
+    static void Write(ParameterGrp &Grp, const char* Name, unsigned long Value) {
+        Grp.SetUnsigned(Name, Value);
+    }
+    static void Write(ParameterGrp &Grp, const char* Name, double Value) {
+        Grp.SetFloat(Name, Value);
+    }
+    static void Write(ParameterGrp &Grp, const char* Name, const std::string &Value) {
+        Grp.SetASCII(Name, Value.c_str());
+    }
+
+    ParameterGrp *_pRoot;
+    std::string _cPath;
+    mutable Base::Reference<ParameterGrp> _hGrp;
+    std::string _cName;
+    T _Preset;
+    mutable T _Value;
+    mutable unsigned long _Revision;
+    mutable unsigned long _GroupRevision;
 };
 
 /** The parameter serializer class
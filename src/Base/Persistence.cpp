@@ -72,6 +72,35 @@ void Persistence::RestoreDocFile(Reader &/*reader*/)
 {
 }
 
+bool Persistence::hasConcurrentDocFile() const
+{
+    return false;
+}
+
+void Persistence::decodeDocFile(Reader &reader)
+{
+    RestoreDocFile(reader);
+}
+
+void Persistence::applyDocFile()
+{
+}
+
+bool Persistence::hasLazyDocFile() const
+{
+    return false;
+}
+
+void Persistence::setLazyDocFile(const std::shared_ptr<LazyDocFile>& file)
+{
+    file->decode(*this);
+    applyDocFile();
+}
+
+void Persistence::loadLazyDocFile()
+{
+}
+
 std::string Persistence::encodeAttribute(const std::string& str)
 {
     std::string tmp;
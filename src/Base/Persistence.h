@@ -28,6 +28,7 @@
 
 
 #include <assert.h>
+#include <memory>
 
 #include "BaseClass.h"
 
@@ -36,6 +37,7 @@ namespace Base
 class Reader;
 class Writer;
 class XMLReader;
+class LazyDocFile;
 
 /// Persistence class and root of the type system
 class BaseExport Persistence : public BaseClass
@@ -146,6 +148,38 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+
+    /** @name Concurrent handling of additional files
+     * Saving and restoring the files of large objects (shapes, meshes, ...)
+     * can be done in worker threads. A class supporting this re-implements
+     * hasConcurrentDocFile(), then SaveDocFile() may be called from a worker
+     * thread and restoring is split into decodeDocFile(), which is called in a
+     * worker thread, and applyDocFile(), which is called afterwards in the main
+     * thread. decodeDocFile() must not change anything but the object's own data,
+     * i.e. it must not trigger any notifications. The default implementation calls
+     * RestoreDocFile(), applyDocFile() does nothing by default.
+     * The files of such objects must not register further files.
+     */
+    //@{
+    virtual bool hasConcurrentDocFile() const;
+    virtual void decodeDocFile(Reader &reader);
+    virtual void applyDocFile();
+    //@}
+
+    /** @name Deferred reading of additional files
+     * If a class re-implements hasLazyDocFile() its file may not be read
+     * when restoring a document. Instead setLazyDocFile() is called with a
+     * reference to the file inside the archive. The class keeps it and reads
+     * the data with LazyDocFile::decode() once it is needed for the first
+     * time or when loadLazyDocFile() is called. The default implementation
+     * of setLazyDocFile() reads the file immediately.
+     */
+    //@{
+    virtual bool hasLazyDocFile() const;
+    virtual void setLazyDocFile(const std::shared_ptr<LazyDocFile>& file);
+    virtual void loadLazyDocFile();
+    //@}
+
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
@@ -42,6 +42,10 @@
 #endif // FC_OS_WIN32
 #include <cmath>
 #include <climits>
+#include <cctype>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
 
 #ifdef FC_OS_WIN32
 #include <direct.h>
@@ -30,7 +30,16 @@
 # include <xercesc/sax2/SAX2XMLReader.hpp>
 #endif
 
+#include <algorithm>
+#include <deque>
+#include <exception>
 #include <locale>
+#include <memory>
+#include <sstream>
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 #include "Reader.h"
@@ -40,6 +49,7 @@
 #include "InputSource.h"
 #include "Console.h"
 #include "Sequencer.h"
+#include "Tracing.h"
 
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
@@ -64,7 +74,7 @@ using namespace std;
 Base::XMLReader::XMLReader(const char* FileName, std::istream& str)
   : DocumentSchema(0), ProgramVersion(""), FileVersion(0), Level(0),
     CharacterCount(0), ReadType(None), _File(FileName), _valid(false),
-    _verbose(true)
+    _verbose(true), _concurrentFiles(false)
 {
 #ifdef _MSC_VER
     str.imbue(std::locale::empty());
@@ -302,6 +312,95 @@ void Base::XMLReader::readBinFile(const char* filename)
     to.close();
 }
 
+namespace {
+
+/*!
+  Calls decodeDocFile() of an object in a worker thread.
+ */
+class DecodeFileJob : public QRunnable
+{
+public:
+    DecodeFileJob(Base::Persistence* object, const std::string& name, int version)
+      : object(object), name(name), version(version), finished(false)
+    {
+        setAutoDelete(false);
+        data.imbue(std::locale::classic());
+    }
+
+    ~DecodeFileJob()
+    {
+        // the worker must not outlive the job
+        wait();
+    }
+
+    void run()
+    {
+        FC_TRACE_SPAN2("RestoreDocFile", name);
+        try {
+            Base::Reader reader(data, name, version);
+            object->decodeDocFile(reader);
+            if (reader.getLocalReader())
+                throw Base::RuntimeError("Nested files cannot be decoded concurrently");
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        // the inflated data is not needed any more
+        std::stringstream().swap(data);
+        done.release();
+    }
+
+    void wait()
+    {
+        if (!finished) {
+            done.acquire();
+            finished = true;
+        }
+    }
+
+    Base::Persistence* object;
+    std::string name;
+    std::string entryName;
+    int version;
+    std::stringstream data;
+    std::exception_ptr error;
+
+private:
+    bool finished;
+    QSemaphore done;
+};
+
+QThreadPool& zipReaderPool()
+{
+    static QThreadPool pool;
+    return pool;
+}
+
+void applyDecodedFile(DecodeFileJob* job)
+{
+    job->wait();
+    try {
+        if (job->error)
+            std::rethrow_exception(job->error);
+        job->object->applyDocFile();
+    }
+    catch(...) {
+        Base::Console().Error("Reading failed from embedded file: %s\n", job->entryName.c_str());
+    }
+}
+
+}
+
+void Base::XMLReader::setConcurrentFiles(bool on)
+{
+    _concurrentFiles = on;
+}
+
+void Base::XMLReader::setLazyFiles(const std::shared_ptr<zipios::ZipFile>& archive)
+{
+    _lazyArchive = archive;
+}
+
 void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
 {
     // It's possible that not all objects inside the document could be created, e.g. if a module
@@ -321,6 +420,9 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
         // project file was created without GUI
         return;
     }
+    // Every queued job holds its inflated file, so only a few of them are queued at a time
+    std::deque<std::unique_ptr<DecodeFileJob> > jobs;
+    const std::size_t maxJobs = 2 * std::max(zipReaderPool().maxThreadCount(), 1);
     std::vector<FileEntry>::const_iterator it = FileList.begin();
     Base::SequencerLauncher seq("Importing project files...", FileList.size());
     while (entry->isValid() && it != FileList.end()) {
@@ -331,8 +433,47 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
             ++jt;
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
-        if (jt != FileList.end()) {
+        if (jt != FileList.end() && _lazyArchive && jt->Object->hasLazyDocFile()) {
+            // The entry is skipped without inflating it
+            try {
+                jt->Object->setLazyDocFile(std::make_shared<LazyDocFile>(_lazyArchive, jt->FileName, FileVersion));
+            }
+            catch(...) {
+                Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+            }
+            it = jt + 1;
+        }
+        else if (jt != FileList.end() && _concurrentFiles && jt->Object->hasConcurrentDocFile()) {
+            // Inflating must be done here because the zip stream is read sequentially.
+            // The job is only created afterwards, so that a damaged entry cannot leave
+            // a job behind that is never started.
+            std::stringstream data;
+            bool inflated = false;
+            try {
+                char buffer[65536];
+                while (zipstream.read(buffer, sizeof(buffer)) || zipstream.gcount() > 0)
+                    data.write(buffer, zipstream.gcount());
+                inflated = true;
+            }
+            catch(...) {
+                Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+            }
+            if (inflated) {
+                if (jobs.size() >= maxJobs) {
+                    applyDecodedFile(jobs.front().get());
+                    jobs.pop_front();
+                }
+                std::unique_ptr<DecodeFileJob> job(new DecodeFileJob(jt->Object, jt->FileName, FileVersion));
+                job->entryName = entry->toString();
+                job->data.swap(data);
+                zipReaderPool().start(job.get());
+                jobs.push_back(std::move(job));
+            }
+            it = jt + 1;
+        }
+        else if (jt != FileList.end()) {
             try {
+                FC_TRACE_SPAN2("RestoreDocFile", jt->FileName);
                 Base::Reader reader(zipstream, jt->FileName, FileVersion);
                 jt->Object->RestoreDocFile(reader);
                 if (reader.getLocalReader())
@@ -361,6 +502,10 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
             break;
         }
     }
+
+    // The decoded data is handed over in the original order
+    for (std::deque<std::unique_ptr<DecodeFileJob> >::iterator jt = jobs.begin(); jt != jobs.end(); ++jt)
+        applyDecodedFile(jt->get());
 }
 
 const char *Base::XMLReader::addFile(const char* Name, Base::Persistence *Object)
@@ -591,3 +736,34 @@ std::shared_ptr<Base::XMLReader> Base::Reader::getLocalReader() const
 {
     return(this->localreader);
 }
+
+// ----------------------------------------------------------------------------
+
+Base::LazyDocFile::LazyDocFile(const std::shared_ptr<zipios::ZipFile>& archive,
+                               const std::string& name, int version)
+  : _archive(archive), _name(name), fileVersion(version)
+{
+}
+
+Base::LazyDocFile::~LazyDocFile()
+{
+}
+
+void Base::LazyDocFile::decode(Base::Persistence& object) const
+{
+    FC_TRACE_SPAN2("RestoreDocFile", _name);
+    std::unique_ptr<std::istream> str(_archive->getInputStream(_name));
+    if (!str)
+        throw Base::FileException("Embedded file not found in archive", _name.c_str());
+    str->imbue(std::locale::classic());
+
+    Base::Reader reader(*str, _name, fileVersion);
+    object.decodeDocFile(reader);
+    if (reader.getLocalReader())
+        throw Base::RuntimeError("Nested files cannot be read on demand");
+}
+
+std::string Base::LazyDocFile::getFileName() const
+{
+    return _name;
+}
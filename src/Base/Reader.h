@@ -38,6 +38,7 @@
 
 namespace zipios {
 class ZipInputStream;
+class ZipFile;
 }
 
 XERCES_CPP_NAMESPACE_BEGIN
@@ -182,6 +183,15 @@ public:
     const char *addFile(const char* Name, Base::Persistence *Object);
     /// process the requested file writes
     void readFiles(zipios::ZipInputStream &zipstream) const;
+    /** Don't read the files of objects that support it but pass them a
+     * reference into \a archive, see Persistence::hasLazyDocFile().
+     */
+    void setLazyFiles(const std::shared_ptr<zipios::ZipFile>& archive);
+    /** Decode the files of objects that support it in worker threads.
+     * The data is still inflated in the calling thread, only the parsing
+     * is done concurrently. See Persistence::hasConcurrentDocFile().
+     */
+    void setConcurrentFiles(bool on);
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence *Object) const;
@@ -286,6 +296,8 @@ protected:
     XERCES_CPP_NAMESPACE_QUALIFIER XMLPScanToken token;
     bool _valid;
     bool _verbose;
+    bool _concurrentFiles;
+    std::shared_ptr<zipios::ZipFile> _lazyArchive;
 
     std::vector<std::string> FileNames;
 
@@ -310,6 +322,25 @@ private:
     std::shared_ptr<Base::XMLReader> localreader;
 };
 
+/** Reference to a file inside a document archive that is read on demand.
+ * The archive is only opened again when the file is decoded.
+ * @see Persistence::setLazyDocFile()
+ */
+class BaseExport LazyDocFile
+{
+public:
+    LazyDocFile(const std::shared_ptr<zipios::ZipFile>& archive, const std::string& name, int version);
+    ~LazyDocFile();
+    /// read the file with decodeDocFile() of the given object
+    void decode(Base::Persistence& object) const;
+    std::string getFileName() const;
+
+private:
+    std::shared_ptr<zipios::ZipFile> _archive;
+    std::string _name;
+    int fileVersion;
+};
+
 }
 
 
@@ -26,6 +26,10 @@
 # include <sstream>
 # include <locale>
 # include <iostream>
+# include <cctype>
+# include <clocale>
+# include <cstdint>
+# include <cstdlib>
 #endif
 
 # include <QTime>
@@ -192,6 +196,107 @@ std::string Base::Tools::escapedUnicodeToUtf8(const std::string& s)
     return string;
 }
 
+namespace {
+const double PowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+}
+
+const char* Base::Tools::parseDouble(const char* begin, const char* end, double& value)
+{
+    // Up to 19 significant digits are collected as an integer. If it fits into the
+    // 53 bits of the mantissa and the exponent is within +-22 then both factors are
+    // exact doubles and the result is correctly rounded.
+    const char* p = begin;
+    bool negative = (p != end && *p == '-');
+    if (p != end && (*p == '-' || *p == '+'))
+        ++p;
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool found = false;
+    bool exact = true;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+        found = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+                ++digits;
+        }
+        else {
+            exact = false;
+        }
+    }
+    if (p != end && *p == '.') {
+        ++p;
+        for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+            found = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                    ++digits;
+                --exponent;
+            }
+            else {
+                exact = false;
+            }
+        }
+    }
+    if (found && p != end && (*p == 'e' || *p == 'E')) {
+        // without digits the 'e' doesn't belong to the number
+        const char* q = p + 1;
+        bool negativeExponent = (q != end && *q == '-');
+        if (q != end && (*q == '-' || *q == '+'))
+            ++q;
+        if (q != end && *q >= '0' && *q <= '9') {
+            int e = 0;
+            for (; q != end && *q >= '0' && *q <= '9'; ++q) {
+                if (e < 10000)
+                    e = e * 10 + (*q - '0');
+            }
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    if (found && exact && mantissa <= (uint64_t(1) << 53) &&
+        exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        if (exponent < 0)
+            result /= PowersOf10[-exponent];
+        else
+            result *= PowersOf10[exponent];
+        value = negative ? -result : result;
+        return p;
+    }
+
+    // long numbers and special values like nan or inf
+    if (begin == end || std::isspace(static_cast<unsigned char>(*begin)))
+        return begin;
+    std::string str(begin, end);
+    if (*localeconv()->decimal_point == '.') {
+        char* stop;
+        double result = strtod(str.c_str(), &stop);
+        if (stop == str.c_str())
+            return begin;
+        value = result;
+        return begin + (stop - str.c_str());
+    }
+
+    std::istringstream ss(str);
+    ss.imbue(std::locale::classic());
+    double result;
+    ss >> result;
+    if (ss.fail())
+        return begin;
+    value = result;
+    if (ss.eof())
+        return end;
+    return begin + static_cast<std::ptrdiff_t>(ss.tellg());
+}
+
 // ----------------------------------------------------------------------------
 
 using namespace Base;
@@ -284,6 +284,13 @@ struct BaseExport Tools
     static std::string narrow(const std::wstring& str);
     static std::string escapedUnicodeFromUtf8(const char *s);
     static std::string escapedUnicodeToUtf8(const std::string& s);
+    /**
+     * @brief parseDouble Convert the number at the start of [begin, end) independent of the locale.
+     * Leading blanks are not skipped.
+     * @param value Receives the number.
+     * @return The position after the number, or \a begin if the range doesn't start with a number.
+     */
+    static const char* parseDouble(const char* begin, const char* end, double& value);
 
     /**
      * @brief toStdString Convert a QString into a UTF-8 encoded std::string.
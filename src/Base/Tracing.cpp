@@ -0,0 +1,296 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <chrono>
+# include <cstring>
+# include <iomanip>
+# include <memory>
+# include <ostream>
+# include <vector>
+# include <QMutex>
+# include <QMutexLocker>
+#endif
+
+#include "Tracing.h"
+#include "Exception.h"
+#include "FileInfo.h"
+#include "Stream.h"
+
+using namespace Base;
+
+namespace {
+
+/// A recorded span, kept small and without allocations
+struct TraceEvent {
+    const char *name;
+    char detail[48];
+    int64_t start;
+    int64_t end;
+};
+
+/// The ring buffer of a thread
+struct TraceBuffer {
+    QMutex mutex; // only contended while exporting or clearing
+    std::vector<TraceEvent> events;
+    std::size_t next;
+    bool wrapped;
+    bool used;  // owned by a running thread
+    int thread;
+
+    TraceBuffer(int id, std::size_t capacity)
+        : events(capacity), next(0), wrapped(false), used(true), thread(id) {
+    }
+};
+
+struct TraceRegistry {
+    QMutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer> > buffers;
+    std::size_t capacity;
+
+    TraceRegistry() : capacity(65536) {
+    }
+};
+
+TraceRegistry &registry()
+{
+    static TraceRegistry reg;
+    return reg;
+}
+
+/// Hands the buffer back to the registry when the thread finishes
+struct TraceBufferOwner {
+    TraceBuffer *buffer;
+
+    TraceBufferOwner() : buffer(0) {
+    }
+    ~TraceBufferOwner() {
+        if (buffer) {
+            QMutexLocker locker(&registry().mutex);
+            buffer->used = false;
+        }
+    }
+};
+
+TraceBuffer *threadBuffer()
+{
+    // The registry owns the buffer, so the spans of a finished thread are kept.
+    // Thread pools retire idle threads and start new ones, so a new thread
+    // continues the buffer of a finished one, which bounds the number of
+    // buffers by the number of threads running at the same time.
+    static thread_local TraceBufferOwner owner;
+    if (!owner.buffer) {
+        TraceRegistry &reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        for (auto &buf : reg.buffers) {
+            if (!buf->used) {
+                buf->used = true;
+                owner.buffer = buf.get();
+                return owner.buffer;
+            }
+        }
+        std::shared_ptr<TraceBuffer> buf = std::make_shared<TraceBuffer>(
+                static_cast<int>(reg.buffers.size()) + 1, reg.capacity);
+        reg.buffers.push_back(buf);
+        owner.buffer = buf.get();
+    }
+    return owner.buffer;
+}
+
+void writeJsonString(std::ostream &out, const char *str)
+{
+    out << '"';
+    for (const char *c = str; *c; ++c) {
+        switch (*c) {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20)
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                    << static_cast<int>(*c) << std::dec << std::setfill(' ');
+            else
+                out << *c;
+            break;
+        }
+    }
+    out << '"';
+}
+
+}
+
+std::atomic<bool> Tracing::_enabled(false);
+
+void Tracing::setEnabled(bool on)
+{
+    // start the clock before the first span
+    now();
+    _enabled.store(on, std::memory_order_relaxed);
+}
+
+void Tracing::setCapacity(std::size_t count)
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.capacity = std::max<std::size_t>(count, 1);
+    for (auto &buf : reg.buffers) {
+        QMutexLocker bufLocker(&buf->mutex);
+        std::vector<TraceEvent>(reg.capacity).swap(buf->events);
+        buf->next = 0;
+        buf->wrapped = false;
+    }
+}
+
+std::size_t Tracing::getCapacity()
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.capacity;
+}
+
+void Tracing::clear()
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (auto &buf : reg.buffers) {
+        QMutexLocker bufLocker(&buf->mutex);
+        buf->next = 0;
+        buf->wrapped = false;
+    }
+}
+
+std::size_t Tracing::count()
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    std::size_t num = 0;
+    for (auto &buf : reg.buffers) {
+        QMutexLocker bufLocker(&buf->mutex);
+        num += buf->wrapped ? buf->events.size() : buf->next;
+    }
+    return num;
+}
+
+int64_t Tracing::now()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Tracing::addSpan(const char *name, const char *detail, int64_t start, int64_t end)
+{
+    TraceBuffer *buf = threadBuffer();
+    QMutexLocker locker(&buf->mutex);
+
+    TraceEvent &ev = buf->events[buf->next];
+    ev.name = name;
+    ev.start = start;
+    ev.end = end;
+    if (detail) {
+        strncpy(ev.detail, detail, sizeof(ev.detail) - 1);
+        ev.detail[sizeof(ev.detail) - 1] = 0;
+        if (strlen(ev.detail) == sizeof(ev.detail) - 1) {
+            // don't cut a UTF-8 sequence in half
+            std::size_t len = sizeof(ev.detail) - 1;
+            while (len > 0 && (ev.detail[len - 1] & 0xC0) == 0x80)
+                --len;
+            if (len > 0 && (ev.detail[len - 1] & 0xC0) == 0xC0)
+                ev.detail[len - 1] = 0;
+        }
+    }
+    else {
+        ev.detail[0] = 0;
+    }
+
+    if (++buf->next == buf->events.size()) {
+        buf->next = 0;
+        buf->wrapped = true;
+    }
+}
+
+void Tracing::exportChromeTrace(std::ostream &out)
+{
+    TraceRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto &buf : reg.buffers) {
+        QMutexLocker bufLocker(&buf->mutex);
+
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buf->thread << ",\"args\":{\"name\":\"Thread " << buf->thread << "\"}}";
+        first = false;
+
+        // oldest span first
+        std::size_t num = buf->wrapped ? buf->events.size() : buf->next;
+        std::size_t index = buf->wrapped ? buf->next : 0;
+        for (std::size_t i = 0; i < num; ++i, ++index) {
+            if (index == buf->events.size())
+                index = 0;
+            const TraceEvent &ev = buf->events[index];
+            out << ",\n{\"name\":";
+            writeJsonString(out, ev.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buf->thread
+                << std::fixed << std::setprecision(3)
+                << ",\"ts\":" << ev.start / 1000.0
+                << ",\"dur\":" << (ev.end - ev.start) / 1000.0;
+            if (ev.detail[0]) {
+                out << ",\"args\":{\"detail\":";
+                writeJsonString(out, ev.detail);
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Tracing::exportChromeTrace(const char *filename)
+{
+    Base::FileInfo fi(filename);
+    Base::ofstream str(fi, std::ios::out | std::ios::binary);
+    if (!str)
+        throw Base::FileException("Cannot open file", fi);
+    exportChromeTrace(str);
+    str.close();
+    if (!str)
+        throw Base::FileException("Failed to write file", fi);
+}
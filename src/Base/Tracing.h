@@ -0,0 +1,148 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef BASE_TRACING_H
+#define BASE_TRACING_H
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+#ifdef __GNUC__
+# include <stdint.h>
+#endif
+
+namespace Base
+{
+
+/** Recording of timed spans for performance analysis
+ *
+ * Spans are recorded with TraceScope, usually through the FC_TRACE_SPAN
+ * macros, and can be exported in the Chrome trace event format, which is
+ * read by chrome://tracing and https://ui.perfetto.dev. Recording is off
+ * by default, then a span costs a single flag test.
+ *
+ * Each thread records into its own ring buffer, so that recording does
+ * not contend between threads. If a buffer is full the oldest spans are
+ * overwritten. The buffer of a finished thread is taken over by the next
+ * thread that starts recording, so that short-lived pool threads don't
+ * add up.
+ *
+ * @code
+ * Base::Tracing::setEnabled(true);
+ * doc->recompute();
+ * Base::Tracing::setEnabled(false);
+ * Base::Tracing::exportChromeTrace("recompute.json");
+ * @endcode
+ */
+class BaseExport Tracing
+{
+public:
+    /// Starts or stops recording
+    static void setEnabled(bool on);
+    /// Returns true if spans are recorded
+    static bool isEnabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+    /** Sets the number of spans each thread keeps
+     * Already recorded spans are discarded.
+     */
+    static void setCapacity(std::size_t count);
+    /// Returns the number of spans each thread keeps
+    static std::size_t getCapacity();
+    /// Discards all recorded spans
+    static void clear();
+    /// Returns the number of recorded spans of all threads
+    static std::size_t count();
+
+    /// Returns the time in nanoseconds since the start of the session
+    static int64_t now();
+    /** Records a span of the calling thread
+     * @param name Name of the span, the string must outlive the recording,
+     * e.g. a string literal.
+     * @param detail Optional detail, e.g. an object name, is copied and
+     * may be truncated.
+     * @param start Start time, see now()
+     * @param end End time, see now()
+     */
+    static void addSpan(const char *name, const char *detail, int64_t start, int64_t end);
+
+    /// Writes the recorded spans as Chrome trace JSON
+    static void exportChromeTrace(std::ostream &out);
+    /// Writes the recorded spans as Chrome trace JSON to a file
+    static void exportChromeTrace(const char *filename);
+
+private:
+    static std::atomic<bool> _enabled;
+};
+
+/** Records the lifetime of the object as a span if tracing is enabled
+ */
+class BaseExport TraceScope
+{
+public:
+    TraceScope(const char *name, const char *detail = 0)
+        : _name(0), _start(0) {
+        if (Tracing::isEnabled()) {
+            _name = name;
+            if (detail)
+                _detail = detail;
+            _start = Tracing::now();
+        }
+    }
+    TraceScope(const char *name, const std::string &detail)
+        : _name(0), _start(0) {
+        if (Tracing::isEnabled()) {
+            _name = name;
+            _detail = detail;
+            _start = Tracing::now();
+        }
+    }
+    ~TraceScope() {
+        if (_name)
+            Tracing::addSpan(_name, _detail.c_str(), _start, Tracing::now());
+    }
+
+private:
+    TraceScope(const TraceScope&);
+    TraceScope& operator=(const TraceScope&);
+
+    const char *_name;
+    std::string _detail;
+    int64_t _start;
+};
+
+} //namespace Base
+
+#define _FC_TRACE_SPAN_NAME2(_line) _fc_trace_span##_line
+#define _FC_TRACE_SPAN_NAME(_line) _FC_TRACE_SPAN_NAME2(_line)
+
+/// Records the rest of the enclosing block as span \a _name
+#define FC_TRACE_SPAN(_name) \
+    Base::TraceScope _FC_TRACE_SPAN_NAME(__LINE__)(_name)
+/// Records the rest of the enclosing block as span \a _name with \a _detail, e.g. an object name
+#define FC_TRACE_SPAN2(_name,_detail) \
+    Base::TraceScope _FC_TRACE_SPAN_NAME(__LINE__)(_name,_detail)
+
+#endif // BASE_TRACING_H
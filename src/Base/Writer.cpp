@@ -34,10 +34,20 @@
 #include "FileInfo.h"
 #include "Stream.h"
 #include "Tools.h"
+#include "Tracing.h"
 
 #include <algorithm>
+#include <exception>
 #include <locale>
 #include <limits>
+#include <map>
+#include <memory>
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include <zipios++/deflateoutputstreambuf.h>
 
 using namespace Base;
 using namespace std;
@@ -241,7 +251,7 @@ void Writer::decInd(void)
 // ----------------------------------------------------------------------------
 
 ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+  : ZipStream(FileName), Level(6), ConcurrentFiles(false)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -254,7 +264,7 @@ ZipWriter::ZipWriter(const char* FileName)
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), Level(6), ConcurrentFiles(false)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -266,6 +276,146 @@ ZipWriter::ZipWriter(std::ostream& os)
     ZipStream.setf(ios::fixed,ios::floatfield);
 }
 
+#ifndef FC_USE_EXTERNAL_ZIPIOS
+namespace {
+
+/*!
+  Writer that compresses everything written to it with raw deflate into
+  memory, so that the result can be passed as pre-compressed zip entry.
+ */
+class DeflateWriter : public Writer
+{
+public:
+    DeflateWriter(const Writer& parent, const std::ostream& settings, int level)
+      : deflateBuf(&compressed), DeflateStream(&deflateBuf)
+    {
+        deflateBuf.init(level);
+        setModes(parent.getModes());
+        setFileVersion(parent.getFileVersion());
+        ObjectName = parent.ObjectName;
+        DeflateStream.imbue(settings.getloc());
+        DeflateStream.precision(settings.precision());
+        DeflateStream.flags(settings.flags());
+    }
+
+    virtual std::ostream &Stream(void){return DeflateStream;}
+    virtual void writeFiles(void){}
+
+    bool hasFiles() const {return !FileList.empty();}
+
+    std::stringbuf compressed;
+    zipios::DeflateOutputStreambuf deflateBuf;
+
+private:
+    std::ostream DeflateStream;
+};
+
+/*!
+  Calls SaveDocFile() of an object in a worker thread.
+ */
+class ZipEntryJob : public QRunnable
+{
+public:
+    ZipEntryJob(const Writer& parent, const std::ostream& settings,
+                const Base::Persistence* object, const std::string& name, int level)
+      : object(object), name(name), writer(parent, settings, level)
+    {
+        setAutoDelete(false);
+    }
+
+    void run()
+    {
+        FC_TRACE_SPAN2("SaveDocFile", name);
+        try {
+            object->SaveDocFile(writer);
+            writer.deflateBuf.closeStream();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        done.release();
+    }
+
+    void wait()
+    {
+        done.acquire();
+    }
+
+    const Base::Persistence* object;
+    std::string name;
+    DeflateWriter writer;
+    std::exception_ptr error;
+
+private:
+    QSemaphore done;
+};
+
+QThreadPool& zipWriterPool()
+{
+    static QThreadPool pool;
+    return pool;
+}
+
+}
+
+void ZipWriter::writeFiles(void)
+{
+    // The files of objects supporting it are written in worker threads but
+    // the entries are still stored in the order they were added. Every job
+    // holds its compressed file until it is stored, so only a few of them
+    // are scheduled at a time.
+    std::map<size_t, std::unique_ptr<ZipEntryJob> > jobs;
+    const size_t maxJobs = 2 * std::max(zipWriterPool().maxThreadCount(), 1);
+    size_t scheduled = 0;
+
+    try {
+        // use a while loop because it is possible that while
+        // processing the files new ones can be added
+        size_t index = 0;
+        while (index < FileList.size()) {
+            for (; ConcurrentFiles && scheduled < FileList.size() && jobs.size() < maxJobs; ++scheduled) {
+                const FileEntry& entry = FileList[scheduled];
+                if (entry.Object->hasConcurrentDocFile()) {
+                    ZipEntryJob* job = new ZipEntryJob(*this, ZipStream, entry.Object, entry.FileName, Level);
+                    jobs[scheduled].reset(job);
+                    zipWriterPool().start(job);
+                }
+            }
+
+            FileEntry entry = FileList.begin()[index];
+            auto it = jobs.find(index);
+            if (it == jobs.end()) {
+                FC_TRACE_SPAN2("SaveDocFile", entry.FileName);
+                ZipStream.putNextEntry(entry.FileName);
+                entry.Object->SaveDocFile(*this);
+            }
+            else {
+                std::unique_ptr<ZipEntryJob> job(std::move(it->second));
+                jobs.erase(it);
+                job->wait();
+                if (job->error)
+                    std::rethrow_exception(job->error);
+
+                std::vector<std::string> errors = job->writer.getErrors();
+                Errors.insert(Errors.end(), errors.begin(), errors.end());
+                if (job->writer.hasFiles())
+                    addError(std::string("Additional files of '") + entry.FileName + "' cannot be written");
+
+                const std::string& data = job->writer.compressed.str();
+                ZipStream.putDeflatedEntry(entry.FileName, data.c_str(), data.size(),
+                    job->writer.deflateBuf.getCount(), job->writer.deflateBuf.getCrc32());
+            }
+            index++;
+        }
+    }
+    catch (...) {
+        // the workers still access the objects
+        for (auto& it : jobs)
+            it.second->wait();
+        throw;
+    }
+}
+#else
 void ZipWriter::writeFiles(void)
 {
     // use a while loop because it is possible that while
@@ -273,11 +423,13 @@ void ZipWriter::writeFiles(void)
     size_t index = 0;
     while (index < FileList.size()) {
         FileEntry entry = FileList.begin()[index];
+        FC_TRACE_SPAN2("SaveDocFile", entry.FileName);
         ZipStream.putNextEntry(entry.FileName);
         entry.Object->SaveDocFile(*this);
         index++;
     }
 }
+#endif
 
 ZipWriter::~ZipWriter()
 {
@@ -325,6 +477,7 @@ void FileWriter::writeFiles(void)
             }
 
             std::string fileName = DirName + "/" + entry.FileName;
+            FC_TRACE_SPAN2("SaveDocFile", entry.FileName);
             this->FileStream.open(fileName.c_str(), std::ios::out | std::ios::binary);
             entry.Object->SaveDocFile(*this);
             this->FileStream.close();
@@ -155,11 +155,17 @@ public:
     virtual std::ostream &Stream(void){return ZipStream;}
 
     void setComment(const char* str){ZipStream.setComment(str);}
-    void setLevel(int level){ZipStream.setLevel( level );}
+    void setLevel(int level){ZipStream.setLevel( level ); Level = level;}
     void putNextEntry(const char* str){ZipStream.putNextEntry(str);}
+    /** Serialize and compress the files of objects supporting it in worker
+     * threads, see Persistence::hasConcurrentDocFile(). Off by default.
+     */
+    void setConcurrentFiles(bool on){ConcurrentFiles = on;}
 
 private:
     zipios::ZipOutputStream ZipStream;
+    int Level;
+    bool ConcurrentFiles;
 };
 
 /** The StringWriter class 
@@ -83,6 +83,8 @@ void DlgSettingsDocumentImp::saveSettings()
     prefAutoSaveEnabled->onSave();
     prefAutoSaveTimeout->onSave();
     prefCanAbortRecompute->onSave();
+    prefParallelRecompute->onSave();
+    prefParallelFileIO->onSave();
 
     int timeout = prefAutoSaveTimeout->value();
     if (!prefAutoSaveEnabled->isChecked())
@@ -114,6 +116,8 @@ void DlgSettingsDocumentImp::loadSettings()
     prefAutoSaveEnabled->onRestore();
     prefAutoSaveTimeout->onRestore();
     prefCanAbortRecompute->onRestore();
+    prefParallelRecompute->onRestore();
+    prefParallelFileIO->onRestore();
 }
 
 /**
@@ -24,8 +24,13 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cctype>
 # include <cstdlib>
+# include <cstring>
+# include <map>
 # include <memory>
+# include <unordered_set>
 # include <Bnd_Box.hxx>
 # include <BRep_Tool.hxx>
 # include <BRepBndLib.hxx>
@@ -567,6 +572,66 @@ std::set<long> FemMesh::getSurfaceNodes(long /*ElemId*/, short /*FaceId*/, float
     return result;
 }
 
+namespace {
+
+/// Returns true if all nodes of \a elem are in \a nodes
+bool hasAllNodesIn(const SMDS_MeshElement* elem, const std::unordered_set<int>& nodes)
+{
+    int numNodes = elem->NbNodes();
+    for (int i=0; i<numNodes; i++) {
+        if (nodes.find(elem->GetNode(i)->GetID()) == nodes.end())
+            return false;
+    }
+    return true;
+}
+
+/*! Returns the elements of \a type which have at least one node in \a nodes,
+ * sorted by their ID. The inverse connectivity of the nodes kept by SMDS is
+ * used, thus only the elements around the nodes are visited instead of the
+ * whole mesh.
+ */
+std::vector<const SMDS_MeshElement*> getElementsOfNodes(const SMESHDS_Mesh* meshds,
+                                                         const std::set<int>& nodes,
+                                                         SMDSAbs_ElementType type)
+{
+    std::vector<const SMDS_MeshElement*> result;
+    std::unordered_set<const SMDS_MeshElement*> visited;
+    for (std::set<int>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        const SMDS_MeshNode* node = meshds->FindNode(*it);
+        if (!node)
+            continue;
+        SMDS_ElemIteratorPtr elem_iter = node->GetInverseElementIterator(type);
+        while (elem_iter->more()) {
+            const SMDS_MeshElement* elem = elem_iter->next();
+            if (visited.insert(elem).second)
+                result.push_back(elem);
+        }
+    }
+    // the order of the inverse connectivity depends on the history of the mesh
+    std::sort(result.begin(), result.end(), [](const SMDS_MeshElement* a, const SMDS_MeshElement* b) {
+        return a->GetID() < b->GetID();
+    });
+    return result;
+}
+
+/// Returns true if an element of \a type contains all nodes of \a elem
+bool isPartOfElement(const SMDS_MeshElement* elem, SMDSAbs_ElementType type)
+{
+    int numNodes = elem->NbNodes();
+    SMDS_ElemIteratorPtr elem_iter = elem->GetNode(0)->GetInverseElementIterator(type);
+    while (elem_iter->more()) {
+        const SMDS_MeshElement* other = elem_iter->next();
+        int i = 1;
+        while (i < numNodes && other->GetNodeIndex(elem->GetNode(i)) >= 0)
+            i++;
+        if (i == numNodes)
+            return true;
+    }
+    return false;
+}
+
+}
+
 /*! That function returns map containing volume ID and face ID.
  */
 std::list<std::pair<int, int> > FemMesh::getVolumesByFace(const TopoDS_Face &face) const
@@ -574,27 +639,18 @@ std::list<std::pair<int, int> > FemMesh::getVolumesByFace(const TopoDS_Face &fac
     //TODO: This function is broken with SMESH7 as it is impossible to iterate volume faces
     std::list<std::pair<int, int> > result;
     std::set<int> nodes_on_face = getNodesByFace(face);
+    std::unordered_set<int> face_nodes(nodes_on_face.begin(), nodes_on_face.end());
 
-    SMDS_VolumeIteratorPtr vol_iter = myMesh->GetMeshDS()->volumesIterator();
-    while (vol_iter->more()) {
-        const SMDS_MeshVolume* vol = vol_iter->next();
+    // only volumes with a node on the face can contribute a face
+    std::vector<const SMDS_MeshElement*> volumes = getElementsOfNodes(myMesh->GetMeshDS(), nodes_on_face, SMDSAbs_Volume);
+    for (std::vector<const SMDS_MeshElement*>::iterator it = volumes.begin(); it != volumes.end(); ++it) {
+        const SMDS_MeshElement* vol = *it;
         SMDS_ElemIteratorPtr face_iter = vol->facesIterator();
 
         while (face_iter && face_iter->more()) {
-            const SMDS_MeshFace* face = static_cast<const SMDS_MeshFace*>(face_iter->next());
-            int numNodes = face->NbNodes();
-
-            std::set<int> face_nodes;
-            for (int i=0; i<numNodes; i++) {
-                face_nodes.insert(face->GetNode(i)->GetID());
-            }
-
-            std::vector<int> element_face_nodes;
-            std::set_intersection(nodes_on_face.begin(), nodes_on_face.end(), face_nodes.begin(), face_nodes.end(),
-                std::back_insert_iterator<std::vector<int> >(element_face_nodes));
-
+            const SMDS_MeshElement* face = face_iter->next();
             // For curved faces it is possible that a volume contributes more than one face
-            if (element_face_nodes.size() == static_cast<std::size_t>(numNodes)) {
+            if (hasAllNodesIn(face, face_nodes)) {
                 result.push_back(std::make_pair(vol->GetID(), face->GetID()));
             }
         }
@@ -608,27 +664,14 @@ std::list<std::pair<int, int> > FemMesh::getVolumesByFace(const TopoDS_Face &fac
  */
 std::list<int> FemMesh::getFacesByFace(const TopoDS_Face &face) const
 {
-    //TODO: This function is broken with SMESH7 as it is impossible to iterate volume faces
     std::list<int> result;
     std::set<int> nodes_on_face = getNodesByFace(face);
+    std::unordered_set<int> face_nodes(nodes_on_face.begin(), nodes_on_face.end());
 
-    SMDS_FaceIteratorPtr face_iter = myMesh->GetMeshDS()->facesIterator();
-    while (face_iter->more()) {
-        const SMDS_MeshFace* face = static_cast<const SMDS_MeshFace*>(face_iter->next());
-        int numNodes = face->NbNodes();
-
-        std::set<int> face_nodes;
-        for (int i=0; i<numNodes; i++) {
-            face_nodes.insert(face->GetNode(i)->GetID());
-        }
-
-        std::vector<int> element_face_nodes;
-        std::set_intersection(nodes_on_face.begin(), nodes_on_face.end(), face_nodes.begin(), face_nodes.end(),
-            std::back_insert_iterator<std::vector<int> >(element_face_nodes));
-
-        // For curved faces it is possible that a volume contributes more than one face
-        if (element_face_nodes.size() == static_cast<std::size_t>(numNodes)) {
-            result.push_back(face->GetID());
+    std::vector<const SMDS_MeshElement*> faces = getElementsOfNodes(myMesh->GetMeshDS(), nodes_on_face, SMDSAbs_Face);
+    for (std::vector<const SMDS_MeshElement*>::iterator it = faces.begin(); it != faces.end(); ++it) {
+        if (hasAllNodesIn(*it, face_nodes)) {
+            result.push_back((*it)->GetID());
         }
     }
 
@@ -640,23 +683,12 @@ std::list<int> FemMesh::getEdgesByEdge(const TopoDS_Edge &edge) const
 {
     std::list<int> result;
     std::set<int> nodes_on_edge = getNodesByEdge(edge);
+    std::unordered_set<int> edge_nodes(nodes_on_edge.begin(), nodes_on_edge.end());
 
-    SMDS_EdgeIteratorPtr edge_iter = myMesh->GetMeshDS()->edgesIterator();
-    while (edge_iter->more()) {
-        const SMDS_MeshEdge* edge = static_cast<const SMDS_MeshEdge*>(edge_iter->next());
-        int numNodes = edge->NbNodes();
-
-        std::set<int> edge_nodes;
-        for (int i=0; i<numNodes; i++) {
-            edge_nodes.insert(edge->GetNode(i)->GetID());
-        }
-
-        std::vector<int> element_edge_nodes;
-        std::set_intersection(nodes_on_edge.begin(), nodes_on_edge.end(), edge_nodes.begin(), edge_nodes.end(),
-            std::back_insert_iterator<std::vector<int> >(element_edge_nodes));
-
-        if (element_edge_nodes.size() == static_cast<std::size_t>(numNodes)) {
-            result.push_back(edge->GetID());
+    std::vector<const SMDS_MeshElement*> edges = getElementsOfNodes(myMesh->GetMeshDS(), nodes_on_edge, SMDSAbs_Edge);
+    for (std::vector<const SMDS_MeshElement*>::iterator it = edges.begin(); it != edges.end(); ++it) {
+        if (hasAllNodesIn(*it, edge_nodes)) {
+            result.push_back((*it)->GetID());
         }
     }
 
@@ -672,47 +704,31 @@ std::map<int, int> FemMesh::getccxVolumesByFace(const TopoDS_Face &face) const
 {
     std::map<int, int> result;
     std::set<int> nodes_on_face = getNodesByFace(face);
+    std::unordered_set<int> face_nodes(nodes_on_face.begin(), nodes_on_face.end());
 
-    static std::map<int, std::vector<int> > elem_order;
-    if (elem_order.empty()) {
-        std::vector<int> c3d4  = boost::assign::list_of(1)(0)(2)(3);
-        std::vector<int> c3d10 = boost::assign::list_of(1)(0)(2)(3)(4)(6)(5)(8)(7)(9);
+    // the corner nodes of C3D4 and C3D10 in CalculiX order
+    static const int ccx_corners[4] = {1, 0, 2, 3};
 
-        elem_order.insert(std::make_pair(c3d4.size(), c3d4));
-        elem_order.insert(std::make_pair(c3d10.size(), c3d10));
-    }
+    std::vector<const SMDS_MeshElement*> volumes = getElementsOfNodes(myMesh->GetMeshDS(), nodes_on_face, SMDSAbs_Volume);
+    for (std::vector<const SMDS_MeshElement*>::iterator it = volumes.begin(); it != volumes.end(); ++it) {
+        const SMDS_MeshElement* vol = *it;
+        int num_of_nodes = vol->NbNodes();
+        if (num_of_nodes != 4 && num_of_nodes != 10)
+            continue;
 
-    SMDS_VolumeIteratorPtr vol_iter = myMesh->GetMeshDS()->volumesIterator();
-    std::set<int> element_nodes;
-    int num_of_nodes;
-    while (vol_iter->more()) {
-        const SMDS_MeshVolume* vol = vol_iter->next();
-        num_of_nodes = vol->NbNodes();
-        std::pair<int, std::vector<int> > apair;
-        apair.first = vol->GetID();
-
-        std::map<int, std::vector<int> >::iterator it = elem_order.find(num_of_nodes);
-        if (it != elem_order.end()) {
-            const std::vector<int>& order = it->second;
-            for (std::vector<int>::const_iterator jt = order.begin(); jt != order.end(); ++jt) {
-                int vid = vol->GetNode(*jt)->GetID();
-                apair.second.push_back(vid);
-            }
+        // Get volume nodes on face
+        int num_on_face = 0;
+        for (int i=0; i<num_of_nodes; i++) {
+            if (face_nodes.find(vol->GetNode(i)->GetID()) != face_nodes.end())
+                num_on_face++;
         }
 
-        // Get volume nodes on face
-        std::vector<int> element_face_nodes;
-        std::set<int> element_nodes;
-        element_nodes.insert(apair.second.begin(), apair.second.end());
-        std::set_intersection(nodes_on_face.begin(), nodes_on_face.end(), element_nodes.begin(), element_nodes.end(),
-        std::back_insert_iterator<std::vector<int> >(element_face_nodes));
-
-        if ((element_face_nodes.size() == 3 && num_of_nodes == 4) ||
-            (element_face_nodes.size() == 6 && num_of_nodes == 10)) {
+        if ((num_on_face == 3 && num_of_nodes == 4) ||
+            (num_on_face == 6 && num_of_nodes == 10)) {
             int missing_node = 0;
             for (int i=0; i<4; i++) {
-                // search for the ID of the volume which is not part of 'element_face_nodes'
-                if (std::find(element_face_nodes.begin(), element_face_nodes.end(), apair.second[i]) == element_face_nodes.end()) {
+                // search for the corner of the volume which is not on the face
+                if (face_nodes.find(vol->GetNode(ccx_corners[i])->GetID()) == face_nodes.end()) {
                     missing_node = i + 1;
                     break;
                 }
@@ -740,7 +756,7 @@ std::map<int, int> FemMesh::getccxVolumesByFace(const TopoDS_Face &face) const
                 assert(false); // should never happen
                 break;
             }
-            result[apair.first] = face_ccx;
+            result[vol->GetID()] = face_ccx;
         }
     }
 
@@ -904,33 +920,11 @@ std::set<int> FemMesh::getEdgesOnly(void) const
 {
     std::set<int> resultIDs;
 
-    // edges
+    // an edge belongs to a face if a face around its first node contains all its nodes
     SMDS_EdgeIteratorPtr aEdgeIter = myMesh->GetMeshDS()->edgesIterator();
     while (aEdgeIter->more()) {
         const SMDS_MeshEdge* aEdge = aEdgeIter->next();
-        std::list<int> enodes = getElementNodes(aEdge->GetID());
-        std::set<int> aEdgeNodes(enodes.begin(), enodes.end());  // convert list to set
-        bool edgeBelongsToAFace = false;
-
-        // faces
-        SMDS_FaceIteratorPtr aFaceIter = myMesh->GetMeshDS()->facesIterator();
-        while (aFaceIter->more()) {
-            const SMDS_MeshFace* aFace = aFaceIter->next();
-            std::list<int> fnodes = getElementNodes(aFace->GetID());
-            std::set<int> aFaceNodes(fnodes.begin(), fnodes.end());  // convert list to set
-
-            // if aEdgeNodes is not a subset of any aFaceNodes --> aEdge does not belong to any Face
-            std::vector<int> inodes;
-            std::set_intersection(aFaceNodes.begin(), aFaceNodes.end(),
-                                  aEdgeNodes.begin(), aEdgeNodes.end(),
-                                  std::back_inserter(inodes));
-            std::set<int> intersection_nodes(inodes.begin(), inodes.end());  // convert vector to set
-            if (aEdgeNodes == intersection_nodes) {
-                edgeBelongsToAFace = true;
-                break;
-            }
-        }
-        if (edgeBelongsToAFace == false)
+        if (!isPartOfElement(aEdge, SMDSAbs_Face))
             resultIDs.insert(aEdge->GetID());
     }
 
@@ -939,57 +933,13 @@ std::set<int> FemMesh::getEdgesOnly(void) const
 
 std::set<int> FemMesh::getFacesOnly(void) const
 {
-    // How it works ATM:
-    // for each face
-    //     get the face nodes
-    //     for each volume
-    //         get the volume nodes
-    //         if the face nodes are a subset of the volume nodes
-    //             add the face to the volume faces and break
-    //     if face doesn't belong to a volume
-    //         add it to faces only
-    //
-    // This means it is iterated over a lot of volumes many times, this is quite expensive!
-    //
-    // TODO make this faster
-    // Idea:
-    // for each volume
-    //     get the faces and add them to the volume faces
-    // for each face
-    //     if not in volume faces
-    //     add it to the faces only
-    //
-    // but the volume faces do not seem to know their global mesh ID, I could not find any method in SMESH
-
     std::set<int> resultIDs;
 
-    // faces
+    // a face belongs to a volume if a volume around its first node contains all its nodes
     SMDS_FaceIteratorPtr aFaceIter = myMesh->GetMeshDS()->facesIterator();
     while (aFaceIter->more()) {
         const SMDS_MeshFace* aFace = aFaceIter->next();
-        std::list<int> fnodes = getElementNodes(aFace->GetID());
-        std::set<int> aFaceNodes(fnodes.begin(), fnodes.end());  // convert list to set
-        bool faceBelongsToAVolume = false;
-
-        // volumes
-        SMDS_VolumeIteratorPtr aVolIter = myMesh->GetMeshDS()->volumesIterator();
-        while (aVolIter->more()) {
-            const SMDS_MeshVolume* aVol = aVolIter->next();
-            std::list<int> vnodes = getElementNodes(aVol->GetID());
-            std::set<int> aVolNodes(vnodes.begin(), vnodes.end());  // convert list to set
-
-            // if aFaceNodes is not a subset of any aVolNodes --> aFace does not belong to any Volume
-            std::vector<int> inodes;
-            std::set_intersection(aVolNodes.begin(), aVolNodes.end(),
-                                  aFaceNodes.begin(), aFaceNodes.end(),
-                                  std::back_inserter(inodes));
-            std::set<int> intersection_nodes(inodes.begin(), inodes.end());  // convert vector to set
-            if (aFaceNodes == intersection_nodes) {
-                faceBelongsToAVolume = true;
-                break;
-            }
-        }
-        if (faceBelongsToAVolume == false)
+        if (!isPartOfElement(aFace, SMDSAbs_Volume))
             resultIDs.insert(aFace->GetID());
     }
 
@@ -1171,6 +1121,200 @@ void FemMesh::readNastran(const std::string &Filename)
 
 }
 
+namespace {
+
+/// An element type of the Abaqus/CalculiX inp format
+struct InpElementType
+{
+    int dimension;
+    int numNodes;
+    const int* order; // CalculiX node of each FreeCAD node, 0 if the order is the same
+};
+
+// switch from the CalculiX node numbering to the FreeCAD node numbering like
+// feminout.importInpMesh does, the FreeCAD node i is the CalculiX node order[i].
+// These are the same tables as in writeABAQUS() and not their inverse, which
+// only makes a difference for the hexa and penta orders as they are not self-inverse.
+const int inpOrderTetra4[]  = {1, 0, 2, 3};
+const int inpOrderTetra10[] = {1, 0, 2, 3, 4, 6, 5, 8, 7, 9};
+const int inpOrderHexa8[]   = {5, 6, 7, 4, 1, 2, 3, 0};
+const int inpOrderHexa20[]  = {5, 6, 7, 4, 1, 2, 3, 0, 13, 14, 15, 12, 9, 10, 11, 8, 17, 18, 19, 16};
+const int inpOrderPenta6[]  = {4, 5, 3, 1, 2, 0};
+const int inpOrderPenta15[] = {4, 5, 3, 1, 2, 0, 10, 11, 9, 7, 8, 6, 13, 14, 12};
+const int inpOrderSeg3[]    = {0, 2, 1};
+
+std::map<std::string, InpElementType> makeInpElementTypes()
+{
+    std::map<std::string, InpElementType> types;
+    const InpElementType seg2    = {1,  2, 0};
+    const InpElementType seg3    = {1,  3, inpOrderSeg3};
+    const InpElementType tria3   = {2,  3, 0};
+    const InpElementType tria6   = {2,  6, 0};
+    const InpElementType quad4   = {2,  4, 0};
+    const InpElementType quad8   = {2,  8, 0};
+    const InpElementType tetra4  = {3,  4, inpOrderTetra4};
+    const InpElementType tetra10 = {3, 10, inpOrderTetra10};
+    const InpElementType hexa8   = {3,  8, inpOrderHexa8};
+    const InpElementType hexa20  = {3, 20, inpOrderHexa20};
+    const InpElementType penta6  = {3,  6, inpOrderPenta6};
+    const InpElementType penta15 = {3, 15, inpOrderPenta15};
+
+    const char* seg2Names[] = {"B31", "B31R", "T3D2"};
+    const char* seg3Names[] = {"B32", "B32R", "T3D3"};
+    const char* tria3Names[] = {"S3", "CPS3", "CPE3", "CAX3"};
+    const char* tria6Names[] = {"S6", "CPS6", "CPE6", "CAX6"};
+    const char* quad4Names[] = {"S4", "S4R", "CPS4", "CPS4R", "CPE4", "CPE4R", "CAX4", "CAX4R"};
+    const char* quad8Names[] = {"S8", "S8R", "CPS8", "CPS8R", "CPE8", "CPE8R", "CAX8", "CAX8R"};
+    const char* hexa8Names[] = {"C3D8", "C3D8R", "C3D8I"};
+    const char* hexa20Names[] = {"C3D20", "C3D20R", "C3D20RI"};
+
+    for (const char* name : seg2Names)
+        types[name] = seg2;
+    for (const char* name : seg3Names)
+        types[name] = seg3;
+    for (const char* name : tria3Names)
+        types[name] = tria3;
+    for (const char* name : tria6Names)
+        types[name] = tria6;
+    for (const char* name : quad4Names)
+        types[name] = quad4;
+    for (const char* name : quad8Names)
+        types[name] = quad8;
+    for (const char* name : hexa8Names)
+        types[name] = hexa8;
+    for (const char* name : hexa20Names)
+        types[name] = hexa20;
+    types["C3D4"] = tetra4;
+    types["C3D10"] = tetra10;
+    types["C3D6"] = penta6;
+    types["C3D15"] = penta15;
+    return types;
+}
+
+const InpElementType* findInpElementType(const std::string& name)
+{
+    static const std::map<std::string, InpElementType> types = makeInpElementTypes();
+    std::map<std::string, InpElementType>::const_iterator it = types.find(name);
+    return it != types.end() ? &it->second : 0;
+}
+
+/// Returns true if the keyword line \a line starts with \a keyword, case insensitive
+bool isInpKeyword(const std::string& line, const char* keyword)
+{
+    std::size_t len = strlen(keyword);
+    if (line.size() < len)
+        return false;
+    for (std::size_t i = 0; i < len; ++i) {
+        if (toupper(static_cast<unsigned char>(line[i])) != keyword[i])
+            return false;
+    }
+    return true;
+}
+
+/// Returns the value of the parameter \a name of a keyword line, upper case and trimmed
+std::string getInpParameter(const std::string& line, const char* name)
+{
+    std::string upper(line);
+    for (std::string::iterator it = upper.begin(); it != upper.end(); ++it)
+        *it = toupper(static_cast<unsigned char>(*it));
+
+    std::size_t pos = upper.find(',');
+    while (pos != std::string::npos) {
+        std::size_t start = upper.find_first_not_of(" \t", pos + 1);
+        std::size_t next = upper.find(',', pos + 1);
+        if (start != std::string::npos && upper.compare(start, strlen(name), name) == 0) {
+            std::size_t eq = upper.find('=', start);
+            if (eq != std::string::npos && (next == std::string::npos || eq < next)) {
+                std::string value = upper.substr(eq + 1, next == std::string::npos ? std::string::npos : next - eq - 1);
+                std::size_t first = value.find_first_not_of(" \t\r\"");
+                std::size_t last = value.find_last_not_of(" \t\r\"");
+                return first == std::string::npos ? std::string() : value.substr(first, last - first + 1);
+            }
+        }
+        pos = next;
+    }
+    return std::string();
+}
+
+/// Appends the integers of a comma separated data line, empty fields are skipped
+void parseInpIntegers(const char* line, std::vector<int>& values)
+{
+    const char* pos = line;
+    while (*pos) {
+        char* end;
+        long value = strtol(pos, &end, 10);
+        if (end != pos)
+            values.push_back(static_cast<int>(value));
+        pos = strchr(end, ',');
+        if (!pos)
+            break;
+        ++pos;
+    }
+}
+
+/// Adds an element with its nodes given in CalculiX order, returns false if a node is missing
+bool addInpElement(SMESHDS_Mesh* meshds, const InpElementType& type, int id, const int* nodeIds)
+{
+    const SMDS_MeshNode* n[20];
+    for (int i = 0; i < type.numNodes; ++i) {
+        n[i] = meshds->FindNode(nodeIds[type.order ? type.order[i] : i]);
+        if (!n[i])
+            return false;
+    }
+
+    switch (type.numNodes) {
+    case 2:
+        meshds->AddEdgeWithID(n[0], n[1], id);
+        break;
+    case 3:
+        if (type.dimension == 1)
+            meshds->AddEdgeWithID(n[0], n[1], n[2], id);
+        else
+            meshds->AddFaceWithID(n[0], n[1], n[2], id);
+        break;
+    case 4:
+        if (type.dimension == 2)
+            meshds->AddFaceWithID(n[0], n[1], n[2], n[3], id);
+        else
+            meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], id);
+        break;
+    case 6:
+        if (type.dimension == 2)
+            meshds->AddFaceWithID(n[0], n[1], n[2], n[3], n[4], n[5], id);
+        else
+            meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], id);
+        break;
+    case 8:
+        if (type.dimension == 2)
+            meshds->AddFaceWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], id);
+        else
+            meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], id);
+        break;
+    case 10:
+        meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9], id);
+        break;
+    case 15:
+        meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9],
+                                n[10], n[11], n[12], n[13], n[14], id);
+        break;
+    case 20:
+        meshds->AddVolumeWithID(n[0], n[1], n[2], n[3], n[4], n[5], n[6], n[7], n[8], n[9],
+                                n[10], n[11], n[12], n[13], n[14], n[15], n[16], n[17], n[18], n[19], id);
+        break;
+    }
+    return true;
+}
+
+/// An element whose nodes are defined later in the file
+struct InpPendingElement
+{
+    const InpElementType* type;
+    int id;
+    std::vector<int> nodes;
+};
+
+}
+
 void FemMesh::readAbaqus(const std::string &FileName)
 {
     Base::TimeInfo Start;
@@ -1178,33 +1322,145 @@ void FemMesh::readAbaqus(const std::string &FileName)
 
     /*
     Python command to read Abaqus inp mesh file from test suite:
-    from feminout.importInpMesh import read as read_inp
-    femmesh = read_inp(FreeCAD.ConfigGet("AppHomePath") + 'Mod/Fem/femtest/testfiles/mesh/tetra10_mesh.inp')
+    femmesh = Fem.read(FreeCAD.ConfigGet("AppHomePath") + 'Mod/Fem/femtest/testfiles/mesh/tetra10_mesh.inp')
+
+    The nodes and elements are streamed directly into the SMESH data structure.
+    Only the model definition is read, i.e. nodes after *STEP are ignored. Element
+    data lines may be continued on the following line, as done by writeABAQUS()
+    for elements with more than 15 nodes.
     */
 
-    PyObject* module = PyImport_ImportModule("feminout.importInpMesh");
-    if (!module)
-        return;
-    try {
-        Py::Module abaqusmod(module, true);
-        Py::Callable method(abaqusmod.getAttr("read"));
-        Py::Tuple args(1);
-        args.setItem(0, Py::String(FileName));
-        Py::Object mesh(method.apply(args));
-        if (PyObject_TypeCheck(mesh.ptr(), &FemMeshPy::Type)) {
-            FemMeshPy* fempy = static_cast<FemMeshPy*>(mesh.ptr());
-            FemMesh* fem = fempy->getFemMeshPtr();
-            *this = *fem; // the deep copy should be avoided, a pointer swap method could be implemented
-                          // see https://forum.freecadweb.org/viewtopic.php?f=10&t=31999&start=10#p274241
+    Base::FileInfo fi(FileName);
+    // the stack of the opened *INCLUDE files
+    std::vector<std::unique_ptr<Base::ifstream> > files;
+    files.emplace_back(new Base::ifstream(fi, std::ios::in | std::ios::binary));
+    if (!*files.back())
+        throw Base::FileException("Cannot open file", fi);
+
+    SMESHDS_Mesh* meshds = this->myMesh->GetMeshDS();
+    meshds->ClearMesh();
+
+    enum { ReadNone, ReadNodes, ReadElements } mode = ReadNone;
+    bool modelDefinition = true;
+    const InpElementType* elemType = 0;
+    std::vector<int> elemNodes;
+    int elemId = 0;
+    bool elemOpen = false;
+    std::vector<InpPendingElement> pending;
+    unsigned long numNodes = 0, numElements = 0;
+    std::string line;
+
+    while (!files.empty()) {
+        if (!std::getline(*files.back(), line)) {
+            files.pop_back();
+            continue;
         }
-        else {
-            throw Base::FileException("Problems reading file");
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+
+        if (line[0] == '*') {
+            if (line.size() > 1 && line[1] == '*') // comment
+                continue;
+
+            if (elemOpen) {
+                Base::Console().Warning("FemMesh::readAbaqus(): element %d has too few nodes\n", elemId);
+                elemOpen = false;
+            }
+            mode = ReadNone;
+
+            if (isInpKeyword(line, "*INCLUDE")) {
+                std::size_t eq = line.find('=');
+                if (eq == std::string::npos)
+                    continue;
+                std::string name = line.substr(eq + 1);
+                std::size_t start = name.find_first_not_of(" \t\r\"");
+                std::size_t end = name.find_last_not_of(" \t\r\"");
+                name = start == std::string::npos ? std::string() : name.substr(start, end - start + 1);
+                Base::FileInfo inc(name);
+                if (!inc.isFile())
+                    inc.setFile(fi.dirPath() + "/" + name);
+                files.emplace_back(new Base::ifstream(inc, std::ios::in | std::ios::binary));
+                if (!*files.back())
+                    throw Base::FileException("Cannot open include file", inc);
+            }
+            else if (isInpKeyword(line, "*NODE") && modelDefinition) {
+                // *NODE PRINT, *NODE FILE and *NODE OUTPUT only exist in a step
+                mode = ReadNodes;
+            }
+            else if (isInpKeyword(line, "*ELEMENT") && modelDefinition) {
+                // *ELEMENT OUTPUT only exists in a step
+                std::string type = getInpParameter(line, "TYPE");
+                elemType = findInpElementType(type);
+                if (elemType)
+                    mode = ReadElements;
+                else
+                    Base::Console().Warning("FemMesh::readAbaqus(): element type '%s' is not supported\n", type.c_str());
+            }
+            else if (isInpKeyword(line, "*STEP")) {
+                modelDefinition = false;
+            }
+        }
+        else if (mode == ReadNodes) {
+            const char* pos = line.c_str();
+            char* end;
+            int id = static_cast<int>(strtol(pos, &end, 10));
+            double coords[3] = {0.0, 0.0, 0.0};
+            for (int i = 0; i < 3; ++i) {
+                pos = strchr(end, ',');
+                if (!pos)
+                    break;
+                coords[i] = strtod(pos + 1, &end);
+            }
+            meshds->AddNodeWithID(coords[0], coords[1], coords[2], id);
+            ++numNodes;
+        }
+        else if (mode == ReadElements) {
+            if (!elemOpen) {
+                elemNodes.clear();
+                parseInpIntegers(line.c_str(), elemNodes);
+                if (elemNodes.empty())
+                    continue;
+                elemId = elemNodes.front();
+                elemNodes.erase(elemNodes.begin());
+                elemOpen = true;
+            }
+            else {
+                parseInpIntegers(line.c_str(), elemNodes);
+            }
+
+            if (static_cast<int>(elemNodes.size()) >= elemType->numNodes) {
+                elemOpen = false;
+                if (!addInpElement(meshds, *elemType, elemId, &elemNodes[0])) {
+                    InpPendingElement elem;
+                    elem.type = elemType;
+                    elem.id = elemId;
+                    elem.nodes = elemNodes;
+                    pending.push_back(elem);
+                }
+                ++numElements;
+            }
         }
     }
-    catch (Py::Exception& e) {
-        e.clear();
+
+    if (elemOpen)
+        Base::Console().Warning("FemMesh::readAbaqus(): element %d has too few nodes\n", elemId);
+
+    // elements defined before their nodes
+    for (std::vector<InpPendingElement>::iterator it = pending.begin(); it != pending.end(); ++it) {
+        if (!addInpElement(meshds, *it->type, it->id, &it->nodes[0])) {
+            Base::Console().Warning("FemMesh::readAbaqus(): element %d refers to an undefined node\n", it->id);
+            --numElements;
+        }
     }
-    Base::Console().Log("    %f: Done \n",Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()));
+
+    if (numNodes == 0)
+        Base::Console().Error("No Nodes found!\n");
+    else if (numElements == 0)
+        Base::Console().Error("No Elements found!\n");
+
+    Base::Console().Log("    %f: Done, %lu nodes, %lu elements\n",
+        Base::TimeInfo::diffTimeF(Start,Base::TimeInfo()), numNodes, numElements);
 }
 
 void FemMesh::readZ88(const std::string &FileName)
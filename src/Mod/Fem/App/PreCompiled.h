@@ -57,8 +57,11 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <unordered_set>
 #include <bitset>
 #include <cstdlib>
+#include <cstring>
+#include <cctype>
 #include <memory>
 #include <cmath>
 
@@ -212,6 +212,80 @@ class TestMeshCommon(unittest.TestCase):
             )
         )
 
+    # ********************************************************************************************
+    def test_read_abaqus(
+        self
+    ):
+        # the native inp reader used by Fem.read has to return the same mesh
+        # as the Python inp reader, with *INCLUDE, continuation lines and a step
+        tmp_dir = testtools.get_fem_test_tmp_dir()
+        nodes_file = join(tmp_dir, "mixed_nodes.inp")
+        inp_file = join(tmp_dir, "mixed_mesh.inp")
+        f = open(nodes_file, "w")
+        f.write("*Node, NSET=Nall\n")
+        for i in range(1, 21):
+            f.write("{}, {}, {}, {}\n".format(i, 0.5 * i, -0.25 * i, i * 1e-3))
+        f.close()
+        f = open(inp_file, "w")
+        f.write("** mixed mesh\n*INCLUDE, INPUT=mixed_nodes.inp\n\n")
+        f.write("*Element, TYPE=C3D20, ELSET=Evolumes\n")
+        f.write("1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,\n16, 17, 18, 19, 20, \n")
+        f.write("*Element, TYPE=C3D15, ELSET=Evolumes\n")
+        f.write("2, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15\n")
+        f.write("*element, type=c3d4, elset=Evolumes\n3, 4, 3, 2, 1\n")
+        f.write("*Element, TYPE=S6, ELSET=Efaces\n4, 1, 2, 3, 4, 5, 6\n")
+        f.write("*Element, TYPE=S4R, ELSET=Efaces\n5, 7, 8, 9, 10\n")
+        f.write("*Element, TYPE=B31, ELSET=Eedges\n6, 11, 12\n")
+        f.write("*STEP\n*STATIC\n*NODE PRINT, NSET=Nall\nU\n")
+        f.write("*ELEMENT OUTPUT, ELSET=Evolumes\nS\n*END STEP\n")
+        f.close()
+
+        from feminout.importInpMesh import read as read_inp
+        femmesh_python = read_inp(inp_file)
+        femmesh_native = Fem.read(inp_file)
+
+        self.assertEqual(femmesh_native.Nodes, femmesh_python.Nodes)
+        self.assertEqual(
+            (femmesh_native.VolumeCount, femmesh_native.FaceCount, femmesh_native.EdgeCount),
+            (3, 2, 1)
+        )
+        for elem in range(1, 7):
+            self.assertEqual(
+                femmesh_native.getElementNodes(elem),
+                femmesh_python.getElementNodes(elem),
+                "Nodes of element {} are different".format(elem)
+            )
+
+    # ********************************************************************************************
+    def test_elements_by_face(
+        self
+    ):
+        # two tetra4 sharing the face 1, 2, 3 which lies on the bottom face of a box
+        import Part
+        box = Part.makeBox(1, 1, 1)
+        bottom = box.Faces[4]
+        femmesh = Fem.FemMesh()
+        femmesh.addNode(0, 0, 0, 1)
+        femmesh.addNode(1, 0, 0, 2)
+        femmesh.addNode(0, 1, 0, 3)
+        femmesh.addNode(0, 0, 1, 4)
+        femmesh.addNode(1, 1, 1, 5)
+        femmesh.addNode(1, 1, 0, 6)
+        femmesh.addVolume([1, 2, 3, 4], 10)
+        femmesh.addVolume([2, 1, 3, 5], 11)
+        femmesh.addFace([1, 2, 3], 20)
+        femmesh.addFace([1, 4, 5], 21)
+        femmesh.addFace([2, 6, 3], 15)
+        femmesh.addEdge([1, 2], 30)
+        femmesh.addEdge([4, 5], 31)
+        femmesh.addEdge([2, 5], 32)
+
+        # the IDs are sorted, not in the order the elements were added
+        self.assertEqual(femmesh.getFacesByFace(bottom), [15, 20])
+        self.assertEqual(femmesh.getccxVolumesByFace(bottom), [(10, 1), (11, 1)])
+        self.assertEqual(femmesh.FacesOnly, (15, 21))
+        self.assertEqual(femmesh.EdgesOnly, (32,))
+
     # ********************************************************************************************
     def tearDown(
         self
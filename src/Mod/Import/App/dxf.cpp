@@ -9,12 +9,16 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
 #include <iomanip>
 
 #include <Build/Version.h>
 #include <Base/Console.h>
 #include <Base/FileInfo.h>
 #include <Base/Parameter.h>
+#include <Base/Tools.h>
 #include <Base/Vector3D.h>
 #include "dxf.h"
 
@@ -1660,11 +1664,92 @@ void CDxfWrite::writeObjectsSection(void)
     (*m_ofs) << getPlateFile(fileSpec);
 }
 
+namespace {
+
+// the file is read in blocks of this size, a line must fit into a block
+const size_t DxfReadBlockSize = 1 << 20;
+
+// the start of a binary DXF, including the terminating zero
+const char DxfBinarySentinel[] = "AutoCAD Binary DXF\r\n\x1a";
+
+enum DxfBinaryType {
+    dbString,
+    dbDouble,
+    dbInt16,
+    dbInt32,
+    dbInt64,
+    dbBool,
+    dbChunk
+};
+
+// the type of the value of a group code in a binary DXF
+DxfBinaryType binaryValueType(int code)
+{
+    if ((code >= 10 && code <= 59) || (code >= 110 && code <= 149) ||
+        (code >= 210 && code <= 239) || (code >= 460 && code <= 469) ||
+        (code >= 1010 && code <= 1059))
+        return dbDouble;
+    if ((code >= 60 && code <= 79) || (code >= 170 && code <= 179) ||
+        (code >= 270 && code <= 289) || (code >= 370 && code <= 389) ||
+        (code >= 400 && code <= 409) || (code >= 1060 && code <= 1070))
+        return dbInt16;
+    if ((code >= 90 && code <= 99) || (code >= 420 && code <= 429) ||
+        (code >= 440 && code <= 459) || code == 1071)
+        return dbInt32;
+    if (code >= 160 && code <= 169)
+        return dbInt64;
+    if (code >= 290 && code <= 299)
+        return dbBool;
+    if ((code >= 310 && code <= 319) || code == 1004)
+        return dbChunk;
+    return dbString;
+}
+
+uint64_t fromLittleEndian(const unsigned char* bytes, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; i--)
+        value = (value << 8) | bytes[i - 1];
+    return value;
+}
+
+// Parses an integer like sscanf("%d")
+bool parseInt(const char* str, int& value)
+{
+    const char* p = str;
+    while (*p == ' ' || *p == '\t')
+        ++p;
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        ++p;
+    if (*p < '0' || *p > '9')
+        return false;
+    long long result = 0;
+    for (; *p >= '0' && *p <= '9'; ++p) {
+        result = result * 10 + (*p - '0');
+        if (result > INT_MAX)
+            return false;
+    }
+    value = static_cast<int>(negative ? -result : result);
+    return true;
+}
+
+}
+
 CDxfRead::CDxfRead(const char* filepath)
 {
     // start the file
-    memset( m_str, '\0', sizeof(m_str) );
+    memset( m_line, '\0', sizeof(m_line) );
     memset( m_unused_line, '\0', sizeof(m_unused_line) );
+    m_str = m_line;
+    m_buffer_pos = 0;
+    m_buffer_end = 0;
+    m_eof = false;
+    m_binary = false;
+    m_binary_short_codes = false;
+    m_binary_code = -1;
+    m_has_double = false;
+    m_double = 0.0;
     m_fail = false;
     m_aci = 0;
     m_eUnits = eMillimeters;
@@ -1674,14 +1759,24 @@ CDxfRead::CDxfRead(const char* filepath)
     memset( m_block_name, '\0', sizeof(m_block_name) );
     m_ignore_errors = true;
 
-    m_ifs = new ifstream(filepath);
+    m_ifs = new ifstream(filepath, ios::in | ios::binary);
     if(!(*m_ifs)){
         m_fail = true;
+        m_eof = true;
         printf("DXF file didn't load\n");
         return;
     }
-    m_ifs->imbue(std::locale("C"));
 
+    m_buffer.resize(DxfReadBlockSize + 1);   // room to terminate the last line
+    fill_buffer();
+    if (m_buffer_end >= sizeof(DxfBinarySentinel) &&
+        memcmp(&m_buffer[0], DxfBinarySentinel, sizeof(DxfBinarySentinel)) == 0) {
+        m_binary = true;
+        m_buffer_pos = sizeof(DxfBinarySentinel);
+        // the first group is 0 SECTION, its code takes one byte before R13 and two since
+        if (m_buffer_end > m_buffer_pos + 1)
+            m_binary_short_codes = (m_buffer[m_buffer_pos + 1] != '\0');
+    }
 }
 
 CDxfRead::~CDxfRead()
@@ -1730,19 +1825,17 @@ bool CDxfRead::ReadLine()
     double e[3] = {0, 0, 0};
     bool hidden = false;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadLine() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with line
@@ -1764,37 +1857,43 @@ bool CDxfRead::ReadLine()
             case 10:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!parse_value(s[0])) return false;
+                s[0] = mm(s[0]);
                 break;
             case 20:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!parse_value(s[1])) return false;
+                s[1] = mm(s[1]);
                 break;
             case 30:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!parse_value(s[2])) return false;
+                s[2] = mm(s[2]);
                 break;
             case 11:
                 // end x
                 get_line();
-                ss.str(m_str); ss >> e[0]; e[0] = mm(e[0]); if(ss.fail()) return false;
+                if(!parse_value(e[0])) return false;
+                e[0] = mm(e[0]);
                 break;
             case 21:
                 // end y
                 get_line();
-                ss.str(m_str); ss >> e[1]; e[1] = mm(e[1]); if(ss.fail()) return false;
+                if(!parse_value(e[1])) return false;
+                e[1] = mm(e[1]);
                 break;
             case 31:
                 // end z
                 get_line();
-                ss.str(m_str); ss >> e[2]; e[2] = mm(e[2]); if(ss.fail()) return false;
+                if(!parse_value(e[2])) return false;
+                e[2] = mm(e[2]);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
 
             case 100:
@@ -1828,19 +1927,17 @@ bool CDxfRead::ReadPoint()
 {
     double s[3] = {0, 0, 0};
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadPoint() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with line
@@ -1856,23 +1953,26 @@ bool CDxfRead::ReadPoint()
             case 10:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!parse_value(s[0])) return false;
+                s[0] = mm(s[0]);
                 break;
             case 20:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!parse_value(s[1])) return false;
+                s[1] = mm(s[1]);
                 break;
             case 30:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!parse_value(s[2])) return false;
+                s[2] = mm(s[2]);
                 break;
 
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
 
             case 100:
@@ -1912,18 +2012,16 @@ bool CDxfRead::ReadArc()
     double z_extrusion_dir = 1.0;
     bool hidden = false;
     
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadArc() Failed to read integer from '%s'\n", m_str);
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with arc
@@ -1945,37 +2043,41 @@ bool CDxfRead::ReadArc()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!parse_value(c[0])) return false;
+                c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!parse_value(c[1])) return false;
+                c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!parse_value(c[2])) return false;
+                c[2] = mm(c[2]);
                 break;
             case 40:
                 // radius
                 get_line();
-                ss.str(m_str); ss >> radius; radius = mm(radius); if(ss.fail()) return false;
+                if(!parse_value(radius)) return false;
+                radius = mm(radius);
                 break;
             case 50:
                 // start angle
                 get_line();
-                ss.str(m_str); ss >> start_angle; if(ss.fail()) return false;
+                if(!parse_value(start_angle)) return false;
                 break;
             case 51:
                 // end angle
                 get_line();
-                ss.str(m_str); ss >> end_angle; if(ss.fail()) return false;
+                if(!parse_value(end_angle)) return false;
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
 
 
@@ -1990,7 +2092,7 @@ bool CDxfRead::ReadArc()
             case 230:
                 //Z extrusion direction for arc 
                 get_line();
-                ss.str(m_str); ss >> z_extrusion_dir; if(ss.fail()) return false;                                
+                if(!parse_value(z_extrusion_dir)) return false;                                
                 break;
 
             default:
@@ -2018,17 +2120,15 @@ bool CDxfRead::ReadSpline()
 
     double temp_double;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadSpline() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Spline
@@ -2042,130 +2142,144 @@ bool CDxfRead::ReadSpline()
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             case 210:
                 // normal x
                 get_line();
-                ss.str(m_str); ss >> sd.norm[0]; if(ss.fail()) return false;
+                if(!parse_value(sd.norm[0])) return false;
                 break;
             case 220:
                 // normal y
                 get_line();
-                ss.str(m_str); ss >> sd.norm[1]; if(ss.fail()) return false;
+                if(!parse_value(sd.norm[1])) return false;
                 break;
             case 230:
                 // normal z
                 get_line();
-                ss.str(m_str); ss >> sd.norm[2]; if(ss.fail()) return false;
+                if(!parse_value(sd.norm[2])) return false;
                 break;
             case 70:
                 // flag
                 get_line();
-                ss.str(m_str); ss >> sd.flag; if(ss.fail()) return false;
+                if(!parse_value(sd.flag)) return false;
                 break;
             case 71:
                 // degree
                 get_line();
-                ss.str(m_str); ss >> sd.degree; if(ss.fail()) return false;
+                if(!parse_value(sd.degree)) return false;
                 break;
             case 72:
                 // knots
                 get_line();
-                ss.str(m_str); ss >> sd.knots; if(ss.fail()) return false;
+                if(!parse_value(sd.knots)) return false;
                 break;
             case 73:
                 // control points
                 get_line();
-                ss.str(m_str); ss >> sd.control_points; if(ss.fail()) return false;
+                if(!parse_value(sd.control_points)) return false;
                 break;
             case 74:
                 // fit points
                 get_line();
-                ss.str(m_str); ss >> sd.fit_points; if(ss.fail()) return false;
+                if(!parse_value(sd.fit_points)) return false;
                 break;
             case 12:
                 // starttan x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.starttanx.push_back(temp_double);
                 break;
             case 22:
                 // starttan y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.starttany.push_back(temp_double);
                 break;
             case 32:
                 // starttan z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.starttanz.push_back(temp_double);
                 break;
             case 13:
                 // endtan x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.endtanx.push_back(temp_double);
                 break;
             case 23:
                 // endtan y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.endtany.push_back(temp_double);
                 break;
             case 33:
                 // endtan z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.endtanz.push_back(temp_double);
                 break;
             case 40:
                 // knot
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.knot.push_back(temp_double);
                 break;
             case 41:
                 // weight
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.weight.push_back(temp_double);
                 break;
             case 10:
                 // control x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.controlx.push_back(temp_double);
                 break;
             case 20:
                 // control y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.controly.push_back(temp_double);
                 break;
             case 30:
                 // control z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.controlz.push_back(temp_double);
                 break;
             case 11:
                 // fit x
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.fitx.push_back(temp_double);
                 break;
             case 21:
                 // fit y
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.fity.push_back(temp_double);
                 break;
             case 31:
                 // fit z
                 get_line();
-                ss.str(m_str); ss >> temp_double; temp_double = mm(temp_double); if(ss.fail()) return false;
+                if(!parse_value(temp_double)) return false;
+                temp_double = mm(temp_double);
                 sd.fitz.push_back(temp_double);
                 break;
             case 42:
@@ -2192,17 +2306,15 @@ bool CDxfRead::ReadCircle()
     double c[3] = {0,0,0}; // centre
     bool hidden = false;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadCircle() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Circle
@@ -2224,27 +2336,31 @@ bool CDxfRead::ReadCircle()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!parse_value(c[0])) return false;
+                c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!parse_value(c[1])) return false;
+                c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!parse_value(c[2])) return false;
+                c[2] = mm(c[2]);
                 break;
             case 40:
                 // radius
                 get_line();
-                ss.str(m_str); ss >> radius; radius = mm(radius); if(ss.fail()) return false;
+                if(!parse_value(radius)) return false;
+                radius = mm(radius);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
 
             case 100:
@@ -2274,17 +2390,15 @@ bool CDxfRead::ReadText()
 
     memset( c, 0, sizeof(c) );
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadText() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 return false;
@@ -2296,22 +2410,26 @@ bool CDxfRead::ReadText()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!parse_value(c[0])) return false;
+                c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!parse_value(c[1])) return false;
+                c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!parse_value(c[2])) return false;
+                c[2] = mm(c[2]);
                 break;
             case 40:
                 // text height
                 get_line();
-                ss.str(m_str); ss >> height; height = mm(height); if(ss.fail()) return false;
+                if(!parse_value(height)) return false;
+                height = mm(height);
                 break;
             case 1:
                 // text
@@ -2323,7 +2441,7 @@ bool CDxfRead::ReadText()
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
 
             case 100:
@@ -2353,17 +2471,15 @@ bool CDxfRead::ReadEllipse()
     double start=0; //start of arc
     double end=0;  // end of arc
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadEllipse() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found, so finish with Ellipse
@@ -2378,52 +2494,58 @@ bool CDxfRead::ReadEllipse()
             case 10:
                 // centre x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!parse_value(c[0])) return false;
+                c[0] = mm(c[0]);
                 break;
             case 20:
                 // centre y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!parse_value(c[1])) return false;
+                c[1] = mm(c[1]);
                 break;
             case 30:
                 // centre z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!parse_value(c[2])) return false;
+                c[2] = mm(c[2]);
                 break;
             case 11:
                 // major x
                 get_line();
-                ss.str(m_str); ss >> m[0]; m[0] = mm(m[0]); if(ss.fail()) return false;
+                if(!parse_value(m[0])) return false;
+                m[0] = mm(m[0]);
                 break;
             case 21:
                 // major y
                 get_line();
-                ss.str(m_str); ss >> m[1]; m[1] = mm(m[1]); if(ss.fail()) return false;
+                if(!parse_value(m[1])) return false;
+                m[1] = mm(m[1]);
                 break;
             case 31:
                 // major z
                 get_line();
-                ss.str(m_str); ss >> m[2]; m[2] = mm(m[2]); if(ss.fail()) return false;
+                if(!parse_value(m[2])) return false;
+                m[2] = mm(m[2]);
                 break;
             case 40:
                 // ratio
                 get_line();
-                ss.str(m_str); ss >> ratio; if(ss.fail()) return false;
+                if(!parse_value(ratio)) return false;
                 break;
             case 41:
                 // start
                 get_line();
-                ss.str(m_str); ss >> start; if(ss.fail()) return false;
+                if(!parse_value(start)) return false;
                 break;
             case 42:
                 // end
                 get_line();
-                ss.str(m_str); ss >> end; if(ss.fail()) return false;
+                if(!parse_value(end)) return false;
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             case 100:
             case 210:
@@ -2523,17 +2645,15 @@ bool CDxfRead::ReadLwPolyLine()
     int flags;
     bool next_item_found = false;
 
-    while(!((*m_ifs).eof()) && !next_item_found)
+    while(!m_eof && !next_item_found)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadLwPolyLine() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -2562,36 +2682,39 @@ bool CDxfRead::ReadLwPolyLine()
                     x_found = false;
                     y_found = false;
                 }
-                ss.str(m_str); ss >> x; x = mm(x); if(ss.fail()) return false;
+                if(!parse_value(x)) return false;
+                x = mm(x);
                 x_found = true;
                 break;
             case 20:
                 // y
                 get_line();
-                ss.str(m_str); ss >> y; y = mm(y); if(ss.fail()) return false;
+                if(!parse_value(y)) return false;
+                y = mm(y);
                 y_found = true;
                 break;
             case 38: 
                 // elevation
                 get_line();
-                ss.str(m_str); ss >> z; z = mm(z); if(ss.fail()) return false;
+                if(!parse_value(z)) return false;
+                z = mm(z);
                 break;
             case 42:
                 // bulge
                 get_line();
-                ss.str(m_str); ss >> bulge; if(ss.fail()) return false;
+                if(!parse_value(bulge)) return false;
                 bulge_found = true;
                 break;
             case 70:
                 // flags
                 get_line();
-                if(sscanf(m_str, "%d", &flags) != 1)return false;
+                if(!parse_value(flags))return false;
                 closed = ((flags & 1) != 0);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             default:
                 // skip the next line
@@ -2630,15 +2753,13 @@ bool CDxfRead::ReadVertex(double *pVertex, bool *bulge_found, double *bulge)
     pVertex[1] = 0.0;
     pVertex[2] = 0.0;
 
-    while(!(*m_ifs).eof()) {
+    while(!m_eof) {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1) {
+        if(!parse_value(n)) {
             printf("CDxfRead::ReadVertex() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
         case 0:
         DerefACI();
@@ -2654,30 +2775,33 @@ bool CDxfRead::ReadVertex(double *pVertex, bool *bulge_found, double *bulge)
         case 10:
             // x
             get_line();
-            ss.str(m_str); ss >> x; pVertex[0] = mm(x); if(ss.fail()) return false;
+            if(!parse_value(x)) return false;
+            pVertex[0] = mm(x);
             x_found = true;
             break;
         case 20:
             // y
             get_line();
-            ss.str(m_str); ss >> y; pVertex[1] = mm(y); if(ss.fail()) return false;
+            if(!parse_value(y)) return false;
+            pVertex[1] = mm(y);
             y_found = true;
             break;
         case 30:
             // z
             get_line();
-            ss.str(m_str); ss >> z; pVertex[2] = mm(z); if(ss.fail()) return false;
+            if(!parse_value(z)) return false;
+            pVertex[2] = mm(z);
             break;
 
         case 42:
             get_line();
             *bulge_found = true;
-            ss.str(m_str); ss >> *bulge; if(ss.fail()) return false;
+            if(!parse_value(*bulge)) return false;
             break;
     case 62:
         // color index
         get_line();
-        ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+        if(!parse_value(m_aci)) return false;
         break;
 
         default:
@@ -2703,17 +2827,15 @@ bool CDxfRead::ReadPolyLine()
     bool bulge_found;
     double bulge;
 
-    while(!(*m_ifs).eof())
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadPolyLine() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0:
                 // next item found
@@ -2745,13 +2867,13 @@ bool CDxfRead::ReadPolyLine()
             case 70:
                 // flags
                 get_line();
-                if(sscanf(m_str, "%d", &flags) != 1)return false;
+                if(!parse_value(flags))return false;
                 closed = ((flags & 1) != 0);
                 break;
                 case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             default:
                 // skip the next line
@@ -2825,17 +2947,15 @@ bool CDxfRead::ReadInsert()
     double rot = 0.0; // rotation
     char name[1024] = {0};
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadInsert() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0: 
                 // next item found
@@ -2850,37 +2970,40 @@ bool CDxfRead::ReadInsert()
             case 10:
                 // coord x
                 get_line();
-                ss.str(m_str); ss >> c[0]; c[0] = mm(c[0]); if(ss.fail()) return false;
+                if(!parse_value(c[0])) return false;
+                c[0] = mm(c[0]);
                 break;
             case 20:
                 // coord y
                 get_line();
-                ss.str(m_str); ss >> c[1]; c[1] = mm(c[1]); if(ss.fail()) return false;
+                if(!parse_value(c[1])) return false;
+                c[1] = mm(c[1]);
                 break;
             case 30:
                 // coord z
                 get_line();
-                ss.str(m_str); ss >> c[2]; c[2] = mm(c[2]); if(ss.fail()) return false;
+                if(!parse_value(c[2])) return false;
+                c[2] = mm(c[2]);
                 break;
             case 41:
                 // scale x
                 get_line();
-                ss.str(m_str); ss >> s[0]; if(ss.fail()) return false;
+                if(!parse_value(s[0])) return false;
                 break;
             case 42:
                 // scale y
                 get_line();
-                ss.str(m_str); ss >> s[1]; if(ss.fail()) return false;
+                if(!parse_value(s[1])) return false;
                 break;
             case 43:
                 // scale z
                 get_line();
-                ss.str(m_str); ss >> s[2]; if(ss.fail()) return false;
+                if(!parse_value(s[2])) return false;
                 break;
             case 50:
                 // rotation
                 get_line();
-                ss.str(m_str); ss >> rot; if(ss.fail()) return false;
+                if(!parse_value(rot)) return false;
                 break;
             case 2:
                 // block name
@@ -2890,7 +3013,7 @@ bool CDxfRead::ReadInsert()
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             case 100:
             case 39:
@@ -2917,17 +3040,15 @@ bool CDxfRead::ReadDimension()
     double p[3] = {0,0,0}; // dimpoint
     double rot = -1.0; // rotation
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadInsert() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0: 
                 // next item found
@@ -2942,57 +3063,66 @@ bool CDxfRead::ReadDimension()
             case 13:
                 // start x
                 get_line();
-                ss.str(m_str); ss >> s[0]; s[0] = mm(s[0]); if(ss.fail()) return false;
+                if(!parse_value(s[0])) return false;
+                s[0] = mm(s[0]);
                 break;
             case 23:
                 // start y
                 get_line();
-                ss.str(m_str); ss >> s[1]; s[1] = mm(s[1]); if(ss.fail()) return false;
+                if(!parse_value(s[1])) return false;
+                s[1] = mm(s[1]);
                 break;
             case 33:
                 // start z
                 get_line();
-                ss.str(m_str); ss >> s[2]; s[2] = mm(s[2]); if(ss.fail()) return false;
+                if(!parse_value(s[2])) return false;
+                s[2] = mm(s[2]);
                 break;
             case 14:
                 // end x
                 get_line();
-                ss.str(m_str); ss >> e[0]; e[0] = mm(e[0]); if(ss.fail()) return false;
+                if(!parse_value(e[0])) return false;
+                e[0] = mm(e[0]);
                 break;
             case 24:
                 // end y
                 get_line();
-                ss.str(m_str); ss >> e[1]; e[1] = mm(e[1]); if(ss.fail()) return false;
+                if(!parse_value(e[1])) return false;
+                e[1] = mm(e[1]);
                 break;
             case 34:
                 // end z
                 get_line();
-                ss.str(m_str); ss >> e[2]; e[2] = mm(e[2]); if(ss.fail()) return false;
+                if(!parse_value(e[2])) return false;
+                e[2] = mm(e[2]);
                 break;
             case 10:
                 // dimline x
                 get_line();
-                ss.str(m_str); ss >> p[0]; p[0] = mm(p[0]); if(ss.fail()) return false;
+                if(!parse_value(p[0])) return false;
+                p[0] = mm(p[0]);
                 break;
             case 20:
                 // dimline y
                 get_line();
-                ss.str(m_str); ss >> p[1]; p[1] = mm(p[1]); if(ss.fail()) return false;
+                if(!parse_value(p[1])) return false;
+                p[1] = mm(p[1]);
                 break;
             case 30:
                 // dimline z
                 get_line();
-                ss.str(m_str); ss >> p[2]; p[2] = mm(p[2]); if(ss.fail()) return false;
+                if(!parse_value(p[2])) return false;
+                p[2] = mm(p[2]);
                 break;
             case 50:
                 // rotation
                 get_line();
-                ss.str(m_str); ss >> rot; if(ss.fail()) return false;
+                if(!parse_value(rot)) return false;
                 break;
             case 62:
                 // color index
                 get_line();
-                ss.str(m_str); ss >> m_aci; if(ss.fail()) return false;
+                if(!parse_value(m_aci)) return false;
                 break;
             case 100:
             case 39:
@@ -3014,17 +3144,15 @@ bool CDxfRead::ReadDimension()
 
 bool CDxfRead::ReadBlockInfo()
 {
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadBlockInfo() Failed to read integer from '%s'\n", m_str);
             return false;
         }
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 2:
                 // block name
@@ -3046,32 +3174,176 @@ bool CDxfRead::ReadBlockInfo()
 }
 
 
+// moves the unread rest of the block to its start and fills the block from the file
+bool CDxfRead::fill_buffer()
+{
+    if (m_buffer_pos > 0) {
+        if (m_buffer_end > m_buffer_pos)
+            memmove(&m_buffer[0], &m_buffer[m_buffer_pos], m_buffer_end - m_buffer_pos);
+        m_buffer_end -= m_buffer_pos;
+        m_buffer_pos = 0;
+    }
+    if (m_buffer_end == DxfReadBlockSize || !(*m_ifs))
+        return false;
+    m_ifs->read(&m_buffer[m_buffer_end], DxfReadBlockSize - m_buffer_end);
+    size_t count = static_cast<size_t>(m_ifs->gcount());
+    m_buffer_end += count;
+    return count > 0;
+}
+
+// returns the text up to the terminator, which is replaced by a zero in the block
+char* CDxfRead::next_token(char terminator, size_t& len)
+{
+    size_t searched = 0;
+    for (;;) {
+        char* begin = &m_buffer[m_buffer_pos];
+        size_t available = m_buffer_end - m_buffer_pos;
+        char* found = static_cast<char*>(memchr(begin + searched, terminator, available - searched));
+        if (found) {
+            *found = '\0';
+            len = found - begin;
+            m_buffer_pos += len + 1;
+            return begin;
+        }
+        searched = available;
+        if (!fill_buffer()) {
+            // the end of the file, or a line which doesn't fit into the block
+            begin = &m_buffer[m_buffer_pos];
+            len = m_buffer_end - m_buffer_pos;
+            m_buffer[m_buffer_end] = '\0';
+            m_eof = (len < DxfReadBlockSize);
+            m_buffer_pos = m_buffer_end;
+            return begin;
+        }
+    }
+}
+
+bool CDxfRead::read_binary(void* data, size_t size)
+{
+    if (m_buffer_end - m_buffer_pos < size)
+        fill_buffer();
+    if (m_buffer_end - m_buffer_pos < size) {
+        m_buffer_pos = m_buffer_end;
+        m_eof = true;
+        return false;
+    }
+    memcpy(data, &m_buffer[m_buffer_pos], size);
+    m_buffer_pos += size;
+    return true;
+}
+
+// reads the next group code or value of a binary DXF as the line of an ASCII DXF,
+// except for floating point values, which are not written as text
+void CDxfRead::get_binary_line()
+{
+    unsigned char bytes[255];
+    m_line[0] = '\0';
+    m_str = m_line;
+
+    if (m_binary_code < 0) {
+        int code = 0;
+        if (m_binary_short_codes) {
+            if (!read_binary(bytes, 1))
+                return;
+            code = bytes[0];
+            if (code == 255) {
+                if (!read_binary(bytes, 2))
+                    return;
+                code = static_cast<int16_t>(fromLittleEndian(bytes, 2));
+            }
+        }
+        else {
+            if (!read_binary(bytes, 2))
+                return;
+            code = static_cast<int16_t>(fromLittleEndian(bytes, 2));
+        }
+        m_binary_code = code;
+        snprintf(m_line, sizeof(m_line), "%d", code);
+        return;
+    }
+
+    int code = m_binary_code;
+    m_binary_code = -1;
+    switch (binaryValueType(code)) {
+    case dbDouble:
+        // kept as number only, see parse_value()
+        if (read_binary(bytes, 8)) {
+            uint64_t bits = fromLittleEndian(bytes, 8);
+            memcpy(&m_double, &bits, sizeof(m_double));
+            m_has_double = true;
+        }
+        break;
+    case dbInt16:
+        if (read_binary(bytes, 2))
+            snprintf(m_line, sizeof(m_line), "%d", static_cast<int16_t>(fromLittleEndian(bytes, 2)));
+        break;
+    case dbInt32:
+        if (read_binary(bytes, 4))
+            snprintf(m_line, sizeof(m_line), "%d", static_cast<int32_t>(fromLittleEndian(bytes, 4)));
+        break;
+    case dbInt64:
+        if (read_binary(bytes, 8))
+            snprintf(m_line, sizeof(m_line), "%lld", static_cast<long long>(fromLittleEndian(bytes, 8)));
+        break;
+    case dbBool:
+        if (read_binary(bytes, 1))
+            snprintf(m_line, sizeof(m_line), "%d", bytes[0]);
+        break;
+    case dbChunk:
+        // written as hex digits like in an ASCII DXF
+        if (read_binary(bytes, 1)) {
+            size_t size = bytes[0];
+            if (read_binary(bytes, size)) {
+                static const char hex[] = "0123456789ABCDEF";
+                for (size_t i = 0; i < size; i++) {
+                    m_line[2 * i] = hex[bytes[i] >> 4];
+                    m_line[2 * i + 1] = hex[bytes[i] & 0xf];
+                }
+                m_line[2 * size] = '\0';
+            }
+        }
+        break;
+    default:
+        {
+            size_t len = 0;
+            char* str = next_token('\0', len);
+            if (len >= sizeof(m_line))
+                str[sizeof(m_line) - 1] = '\0';
+            m_str = str;
+        }
+        break;
+    }
+}
+
 void CDxfRead::get_line()
 {
+    m_has_double = false;
     if (m_unused_line[0] != '\0')
     {
-        strcpy(m_str, m_unused_line);
+        strcpy(m_line, m_unused_line);
         memset( m_unused_line, '\0', sizeof(m_unused_line));
+        m_str = m_line;
         return;
     }
 
-    m_ifs->getline(m_str, 1024);
+    if (m_binary) {
+        get_binary_line();
+        return;
+    }
 
-    char str[1024];
-    size_t len = strlen(m_str);
-    int j = 0;
-    bool non_white_found = false;
-    for(size_t i = 0; i<len; i++){
-        if(non_white_found || (m_str[i] != ' ' && m_str[i] != '\t')){
-            if(m_str[i] != '\r')
-            {
-                str[j] = m_str[i]; j++;
-            }
-            non_white_found = true;
-        }
+    // the line is used where it is in the block, without the leading white space
+    // and the carriage return of DOS line ends
+    size_t len = 0;
+    char* str = next_token('\n', len);
+    while (len > 0 && (*str == ' ' || *str == '\t')) {
+        ++str;
+        --len;
     }
-    str[j] = 0;
-    strcpy(m_str, str);
+    while (len > 0 && str[len - 1] == '\r')
+        str[--len] = '\0';
+    if (len >= sizeof(m_line))
+        str[sizeof(m_line) - 1] = '\0';
+    m_str = str;
 }
 
 void CDxfRead::put_line(const char *value)
@@ -3079,13 +3351,36 @@ void CDxfRead::put_line(const char *value)
     strcpy( m_unused_line, value );
 }
 
+bool CDxfRead::parse_value(double& value) const
+{
+    if (m_has_double) {
+        value = m_double;
+        return true;
+    }
+    // like istream >> double the number may be followed by other characters
+    const char* begin = m_str;
+    while (*begin == ' ' || *begin == '\t')
+        ++begin;
+    const char* end = begin + strlen(begin);
+    return Base::Tools::parseDouble(begin, end, value) != begin;
+}
+
+bool CDxfRead::parse_value(int& value) const
+{
+    if (m_has_double) {
+        value = static_cast<int>(m_double);
+        return true;
+    }
+    return parseInt(m_str, value);
+}
+
 
 bool CDxfRead::ReadUnits()
 {
     get_line(); // Skip to next line.
     get_line(); // Skip to next line.
     int n = 0;
-    if(sscanf(m_str, "%d", &n) == 1)
+    if(parse_value(n))
     {
         m_eUnits = eDxfUnits_t( n );
         return(true);
@@ -3103,19 +3398,17 @@ bool CDxfRead::ReadLayer()
     std::string layername;
     int aci = -1;
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         get_line();
         int n;
 
-        if(sscanf(m_str, "%d", &n) != 1)
+        if(!parse_value(n))
         {
             printf("CDxfRead::ReadLayer() Failed to read integer from '%s'\n", m_str );
             return false;
         }
 
-        std::istringstream ss;
-        ss.imbue(std::locale("C"));
         switch(n){
             case 0: // next item found, so finish with line
                     if (layername.empty())
@@ -3134,7 +3427,7 @@ bool CDxfRead::ReadLayer()
             case 62:
                 // layer color ; if negative, layer is off
                 get_line();
-                if(sscanf(m_str, "%d", &aci) != 1)return false;
+                if(!parse_value(aci))return false;
                 break;
 
             case 6: // linetype name
@@ -3162,7 +3455,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
 
     get_line();
 
-    while(!((*m_ifs).eof()))
+    while(!m_eof)
     {
         if (!strcmp( m_str, "$INSUNITS" )){
             if (!ReadUnits())return;
@@ -3173,7 +3466,7 @@ void CDxfRead::DoRead(const bool ignore_errors /* = false */ )
             get_line();
             get_line();
             int n = 1;
-            if(sscanf(m_str, "%d", &n) == 1)
+            if(parse_value(n))
             {
                 if(n == 0)m_measurement_inch = true;
             }
@@ -243,9 +243,19 @@ public:
 class ImportExport CDxfRead{
 private:
     std::ifstream* m_ifs;
+    std::vector<char> m_buffer;     // a block of the file, lines are terminated in place
+    size_t m_buffer_pos;
+    size_t m_buffer_end;
+    bool m_eof;
+    bool m_binary;                  // binary DXF
+    bool m_binary_short_codes;      // binary DXF before R13 with 1 byte group codes
+    int m_binary_code;              // group code of the next binary value, -1 if a group code is next
+    bool m_has_double;              // m_double holds the value of a binary line
+    double m_double;
 
     bool m_fail;
-    char m_str[1024];
+    const char* m_str;              // the current line, valid until the next get_line()
+    char m_line[1024];
     char m_unused_line[1024];
     eDxfUnits_t m_eUnits;
     bool m_measurement_inch;
@@ -277,8 +287,14 @@ private:
     bool ReadDimension();
     bool ReadBlockInfo();
 
+    bool fill_buffer();
+    char* next_token(char terminator, size_t& len);
+    bool read_binary(void* data, size_t size);
+    void get_binary_line();
     void get_line();
     void put_line(const char *value);
+    bool parse_value(double& value) const;
+    bool parse_value(int& value) const;
     void DerefACI();
 
 protected:
@@ -35,6 +35,8 @@ FreeCAD.addImportType("PLMXML files (*.plmxml)","PlmXmlParser")
 FreeCAD.addImportType("STEPZ Zip File Type (*.stpZ *.stpz)","stepZ") 
 FreeCAD.addExportType("STEPZ zip File Type (*.stpZ *.stpz)","stepZ") 
 
+FreeCAD.__unit_test__ += [ "TestImportApp" ]
+
 # Add initial parameters value if they are not set
 
 paramGetV = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Import/hSTEP")
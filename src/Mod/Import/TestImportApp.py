@@ -0,0 +1,74 @@
+#   (c) The FreeCAD project 2020      LGPL
+
+import FreeCAD, os, unittest, struct, math
+import Import
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Import module
+#---------------------------------------------------------------------------
+
+# two lines, a circle, an arc and a point, as (group code, value) pairs
+DxfEntities = [
+    (0, "LINE"), (8, "0"), (10, 0.0), (20, 0.0), (30, 0.0), (11, 10.0), (21, 0.0), (31, 0.0),
+    (0, "LINE"), (8, "0"), (62, 1), (10, 10.0), (20, 0.0), (30, 0.0), (11, 10.0), (21, 5.0), (31, 0.0),
+    (0, "CIRCLE"), (8, "0"), (10, 20.0), (20, 0.0), (30, 0.0), (40, 2.0),
+    (0, "ARC"), (8, "0"), (10, 30.0), (20, 0.0), (30, 0.0), (40, 3.0), (50, 0.0), (51, 90.0),
+    (0, "POINT"), (8, "0"), (10, 40.0), (20, 1.0), (30, 0.0),
+]
+
+def dxfGroups():
+    return [(0, "SECTION"), (2, "ENTITIES")] + DxfEntities + [(0, "ENDSEC"), (0, "EOF")]
+
+def writeAsciiDxf(filename):
+    with open(filename, "w") as f:
+        for code, value in dxfGroups():
+            f.write("{:>3}\n{}\n".format(code, value))
+
+def writeBinaryDxf(filename):
+    with open(filename, "wb") as f:
+        f.write(b"AutoCAD Binary DXF\r\n\x1a\x00")
+        for code, value in dxfGroups():
+            f.write(struct.pack("<h", code))
+            if isinstance(value, str):
+                f.write(value.encode("ascii") + b"\x00")
+            elif isinstance(value, float):
+                f.write(struct.pack("<d", value))
+            else:
+                f.write(struct.pack("<h", value))
+
+
+class DxfImportCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("DxfImportTest")
+        self.fileName = os.path.join(FreeCAD.getTempPath(), "DxfImportTest.dxf")
+
+    def checkEntities(self):
+        shapes = [o.Shape for o in self.Doc.Objects if o.isDerivedFrom("Part::Feature")]
+        self.assertEqual(len(shapes), 5)
+        self.assertEqual(sum(len(s.Edges) for s in shapes), 4)
+        self.assertEqual(sum(len(s.Vertexes) for s in shapes if not s.Edges), 1)
+        length = sum(s.Length for s in shapes)
+        self.assertAlmostEqual(length, 15.0 + 4.0 * math.pi + 1.5 * math.pi, 6)
+
+    def testAsciiDxf(self):
+        writeAsciiDxf(self.fileName)
+        Import.readDXF(self.fileName, self.Doc.Name)
+        self.checkEntities()
+
+    def testDosAsciiDxf(self):
+        # DOS line ends and indented group codes
+        with open(self.fileName, "w", newline="\r\n") as f:
+            for code, value in dxfGroups():
+                f.write("  {}\n{}\n".format(code, value))
+        Import.readDXF(self.fileName, self.Doc.Name)
+        self.checkEntities()
+
+    def testBinaryDxf(self):
+        writeBinaryDxf(self.fileName)
+        Import.readDXF(self.fileName, self.Doc.Name)
+        self.checkEntities()
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
+        if os.path.exists(self.fileName):
+            os.remove(self.fileName)
@@ -23,23 +23,24 @@
 
 #include "PreCompiled.h"
 #include <gp_Pnt.hxx>
+#include <Standard_Version.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepGProp_Face.hxx>
+#include <Standard_Failure.hxx>
 #include <TopoDS.hxx>
 #include <TopoDS_Vertex.hxx>
 
-#include <QEventLoop>
 #include <QFuture>
-#include <QFutureWatcher>
+#include <QMutexLocker>
+#include <QThread>
 #include <QtConcurrentMap>
 
 #include <boost/bind.hpp>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
-#include <Base/FutureWatcherProgress.h>
 #include <Base/Parameter.h>
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
@@ -76,8 +77,10 @@ unsigned long InspectActualMesh::countPoints() const
 
 Base::Vector3f InspectActualMesh::getPoint(unsigned long index)
 {
-    _iter.Set(index);
-    return *_iter;
+    // use a copy of the iterator to be thread-safe
+    MeshCore::MeshPointIterator iter(_iter);
+    iter.Set(index);
+    return *iter;
 }
 
 // ----------------------------------------------------------------
@@ -295,14 +298,16 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point)
         indices.insert(indices.begin(), inds.begin(), inds.end());
     }
 
+    // use a copy of the iterator to be thread-safe
+    MeshCore::MeshFacetIterator iter(_iter);
     float fMinDist=FLT_MAX;
     bool positive = true;
     for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
+        iter.Set(*it);
+        float fDist = iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
             fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
+            positive = point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) > 0;
         }
     }
 
@@ -368,14 +373,16 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point)
         _pGrid->GetHull(ulX, ulY, ulZ, ulLevel, indices);
 #endif
 
+    // use a copy of the iterator to be thread-safe
+    MeshCore::MeshFacetIterator iter(_iter);
     float fMinDist=FLT_MAX;
     bool positive = true;
     for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
+        iter.Set(*it);
+        float fDist = iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
             fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
+            positive = point.DistanceToPlane(iter->_aclPoints[0], iter->GetNormal()) > 0;
         }
     }
 
@@ -425,69 +432,101 @@ InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radi
     : _rShape(shape)
     , isSolid(false)
 {
-    distss = new BRepExtrema_DistShapeShape();
-    distss->LoadS1(_rShape);
-
     // When having a solid then use its shell because otherwise the distance
     // for inner points will always be zero
     if (!_rShape.IsNull() && _rShape.ShapeType() == TopAbs_SOLID) {
         TopExp_Explorer xp;
         xp.Init(_rShape, TopAbs_SHELL);
-        if (xp.More()) {
-           distss->LoadS1(xp.Current());
-           isSolid = true;
-        }
-
+        isSolid = xp.More();
     }
-    //distss->SetDeflection(radius);
+
+    releaseDistance(acquireDistance());
 }
 
 InspectNominalShape::~InspectNominalShape()
 {
-    delete distss;
+    for (std::vector<BRepExtrema_DistShapeShape*>::iterator it = distss.begin(); it != distss.end(); ++it)
+        delete *it;
+}
+
+BRepExtrema_DistShapeShape* InspectNominalShape::acquireDistance()
+{
+    QMutexLocker lock(&mutex);
+    if (!distss.empty()) {
+        BRepExtrema_DistShapeShape* dist = distss.back();
+        distss.pop_back();
+        return dist;
+    }
+
+    BRepExtrema_DistShapeShape* dist = new BRepExtrema_DistShapeShape();
+    if (isSolid) {
+        TopExp_Explorer xp;
+        xp.Init(_rShape, TopAbs_SHELL);
+        dist->LoadS1(xp.Current());
+    }
+    else {
+        dist->LoadS1(_rShape);
+    }
+    //dist->SetDeflection(radius);
+    return dist;
+}
+
+void InspectNominalShape::releaseDistance(BRepExtrema_DistShapeShape* dist)
+{
+    QMutexLocker lock(&mutex);
+    distss.push_back(dist);
 }
 
 float InspectNominalShape::getDistance(const Base::Vector3f& point)
 {
     gp_Pnt pnt3d(point.x,point.y,point.z);
     BRepBuilderAPI_MakeVertex mkVert(pnt3d);
-    distss->LoadS2(mkVert.Vertex());
+    BRepExtrema_DistShapeShape* distss = acquireDistance();
 
     float fMinDist=FLT_MAX;
-    if (distss->Perform() && distss->NbSolution() > 0) {
-        fMinDist = (float)distss->Value();
-        // the shape is a solid, check if the vertex is inside
-        if (isSolid) {
-            const Standard_Real tol = 0.001;
-            BRepClass3d_SolidClassifier classifier(_rShape);
-            classifier.Perform(pnt3d, tol);
-            if (classifier.State() == TopAbs_IN) {
-                fMinDist = -fMinDist;
-            }
+    try {
+        distss->LoadS2(mkVert.Vertex());
+        if (distss->Perform() && distss->NbSolution() > 0) {
+            fMinDist = (float)distss->Value();
+            // the shape is a solid, check if the vertex is inside
+            if (isSolid) {
+                const Standard_Real tol = 0.001;
+                BRepClass3d_SolidClassifier classifier(_rShape);
+                classifier.Perform(pnt3d, tol);
+                if (classifier.State() == TopAbs_IN) {
+                    fMinDist = -fMinDist;
+                }
 
-        }
-        else if (fMinDist > 0) {
-            // check if the distance was compued from a face
-            for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-                if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-                    TopoDS_Shape face = distss->SupportOnShape1(index);
-                    Standard_Real u, v;
-                    distss->ParOnFaceS1(index, u, v);
-                    //gp_Pnt pnt = distss->PointOnShape1(index);
-                    BRepGProp_Face props(TopoDS::Face(face));
-                    gp_Vec normal;
-                    gp_Pnt center;
-                    props.Normal(u, v, center, normal);
-                    gp_Vec dir(center, pnt3d);
-                    Standard_Real scalar = normal.Dot(dir);
-                    if (scalar < 0) {
-                        fMinDist = -fMinDist;
+            }
+            else if (fMinDist > 0) {
+                // check if the distance was compued from a face
+                for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
+                    if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
+                        TopoDS_Shape face = distss->SupportOnShape1(index);
+                        Standard_Real u, v;
+                        distss->ParOnFaceS1(index, u, v);
+                        //gp_Pnt pnt = distss->PointOnShape1(index);
+                        BRepGProp_Face props(TopoDS::Face(face));
+                        gp_Vec normal;
+                        gp_Pnt center;
+                        props.Normal(u, v, center, normal);
+                        gp_Vec dir(center, pnt3d);
+                        Standard_Real scalar = normal.Dot(dir);
+                        if (scalar < 0) {
+                            fMinDist = -fMinDist;
+                        }
+                        break;
                     }
-                    break;
                 }
             }
         }
     }
+    catch (...) {
+        releaseDistance(distss);
+        throw;
+    }
+
+    releaseDistance(distss);
     return fMinDist;
 }
 
@@ -641,6 +680,12 @@ unsigned int PropertyDistanceList::getMemSize (void) const
 // helper class to use Qt's concurrent framework
 struct DistanceInspection
 {
+    /// Half-open range of point indices that is checked as a whole by one thread
+    typedef std::pair<unsigned long, unsigned long> Range;
+    struct Result {
+        std::vector<float> distances;
+        std::string error;
+    };
 
     DistanceInspection(float radius, InspectActualGeometry*  a,
                        std::vector<InspectNominalGeometry*> n)
@@ -665,6 +710,30 @@ struct DistanceInspection
 
         return fMinDist;
     }
+    Result mappedRange(const Range& range)
+    {
+        // exceptions must not leave the worker thread, they are
+        // re-thrown by the caller
+        Result result;
+        try {
+            result.distances.reserve(range.second - range.first);
+            for (unsigned long index = range.first; index < range.second; index++)
+                result.distances.push_back(mapped(index));
+        }
+        catch (const Base::Exception& e) {
+            result.error = e.what();
+        }
+        catch (const Standard_Failure& e) {
+            result.error = e.GetMessageString();
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        catch (...) {
+            result.error = "Unknown exception";
+        }
+        return result;
+    }
 
     float radius;
     InspectActualGeometry*  actual;
@@ -744,52 +813,60 @@ App::DocumentObjectExecReturn* Feature::execute(void)
             inspectNominal.push_back(nominal);
     }
 
-#if 0 // test with some huge data sets
+#if OCC_VERSION_HEX < 0x070000
     Standard::SetReentrant(Standard_True);
-    std::vector<unsigned long> index(actual->countPoints());
-    std::generate(index.begin(), index.end(), Base::iotaGen<unsigned long>(0));
-    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
-    QFuture<float> future = QtConcurrent::mapped
-        (index, boost::bind(&DistanceInspection::mapped, &check, _1));
-    //future.waitForFinished(); // blocks the GUI
-    Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-    QFutureWatcher<float> watcher;
-    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
-                     &progress, SLOT(progressValueChanged(int)));
-    watcher.setFuture(future);
-
-    // keep it responsive during computation
-    QEventLoop loop;
-    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
-    loop.exec();
+#endif
 
-    std::vector<float> vals;
-    vals.insert(vals.end(), future.begin(), future.end());
-#else
+    // The points are split into ranges that are checked in parallel. To give the
+    // user the chance to cancel the sequencer is updated after each batch of ranges.
     unsigned long count = actual->countPoints();
+    const unsigned long rangeSize = 1024;
+    std::vector<DistanceInspection::Range> ranges;
+    for (unsigned long index = 0; index < count; index += rangeSize)
+        ranges.push_back(std::make_pair(index, std::min<unsigned long>(index + rangeSize, count)));
+
     std::stringstream str;
     str << "Inspecting " << this->Label.getValue() << "...";
-    Base::SequencerLauncher seq(str.str().c_str(), count);
+    Base::SequencerLauncher seq(str.str().c_str(), ranges.size());
 
-    std::vector<float> vals(count);
-    for (unsigned long index = 0; index < count; index++) {
-        Base::Vector3f pnt = actual->getPoint(index);
+    // the ranges can also be checked in this thread, e.g. to compare the results
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Inspection");
+    bool parallel = hGrp->GetBool("ParallelInspection", true);
 
-        float fMinDist=FLT_MAX;
-        for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
-        }
+    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
+    std::size_t batch = 4 * static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    std::vector<float> vals;
+    vals.reserve(count);
+    try {
+        for (std::size_t pos = 0; pos < ranges.size(); pos += batch) {
+            std::vector<DistanceInspection::Range>::const_iterator begin = ranges.begin() + pos;
+            std::vector<DistanceInspection::Range>::const_iterator end = ranges.begin() + std::min(pos + batch, ranges.size());
+            QList<DistanceInspection::Result> results;
+            if (parallel) {
+                QFuture<DistanceInspection::Result> future = QtConcurrent::mapped
+                    (begin, end, boost::bind(&DistanceInspection::mappedRange, &check, _1));
+                results = future.results();
+            }
+            else {
+                for (std::vector<DistanceInspection::Range>::const_iterator it = begin; it != end; ++it)
+                    results.push_back(check.mappedRange(*it));
+            }
 
-        if (fMinDist > this->SearchRadius.getValue())
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->SearchRadius.getValue())
-            fMinDist = -FLT_MAX;
-        vals[index] = fMinDist;
-        seq.next();
+            for (QList<DistanceInspection::Result>::const_iterator it = results.constBegin(); it != results.constEnd(); ++it) {
+                if (!it->error.empty())
+                    throw Base::RuntimeError(it->error);
+                vals.insert(vals.end(), it->distances.begin(), it->distances.end());
+                seq.next(true);
+            }
+        }
+    }
+    catch (...) {
+        delete actual;
+        for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it)
+            delete *it;
+        throw;
     }
-#endif
 
     Distances.setValues(vals);
 
@@ -24,6 +24,8 @@
 #ifndef INSPECTION_FEATURE_H
 #define INSPECTION_FEATURE_H
 
+#include <QMutex>
+
 #include <App/DocumentObject.h>
 #include <App/PropertyLinks.h>
 #include <App/DocumentObjectGroup.h>
@@ -46,7 +48,9 @@ namespace Part   { class TopoShape;  }
 namespace Inspection
 {
 
-/** Delivers the number of points to be checked and returns the appropriate point to an index. */
+/** Delivers the number of points to be checked and returns the appropriate point to an index.
+ * \note getPoint() is called from several threads at the same time.
+ */
 class InspectionExport InspectActualGeometry
 {
 public:
@@ -93,7 +97,9 @@ private:
     std::vector<Base::Vector3d> points;
 };
 
-/** Calculates the shortest distance of the underlying geometry to a given point. */
+/** Calculates the shortest distance of the underlying geometry to a given point.
+ * \note getDistance() is called from several threads at the same time.
+ */
 class InspectionExport InspectNominalGeometry
 {
 public:
@@ -149,7 +155,13 @@ public:
     virtual float getDistance(const Base::Vector3f&);
 
 private:
-    BRepExtrema_DistShapeShape* distss;
+    BRepExtrema_DistShapeShape* acquireDistance();
+    void releaseDistance(BRepExtrema_DistShapeShape*);
+
+private:
+    /// BRepExtrema_DistShapeShape is not re-entrant, so each thread gets its own instance
+    std::vector<BRepExtrema_DistShapeShape*> distss;
+    QMutex mutex;
     const TopoDS_Shape& _rShape;
     bool isSolid;
 };
@@ -0,0 +1,46 @@
+#   (c) The FreeCAD project 2020      LGPL
+
+import FreeCAD, unittest
+import Mesh, Part
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Inspection module
+#---------------------------------------------------------------------------
+
+
+class InspectionDistanceCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("InspectionTest")
+        self.grp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Inspection")
+        self.parallel = self.grp.GetBool("ParallelInspection", True)
+
+        # the vertices of the mesh are 0.1 inside of the nominal sphere
+        mesh = self.Doc.addObject("Mesh::Feature", "Actual")
+        mesh.Mesh = Mesh.createSphere(5.0, 60)
+        shape = self.Doc.addObject("Part::Feature", "Nominal")
+        shape.Shape = Part.makeSphere(5.1)
+        self.inspection = self.Doc.addObject("Inspection::Feature", "Inspection")
+        self.inspection.Actual = mesh
+        self.inspection.Nominals = [shape]
+        self.inspection.SearchRadius = 1.0
+
+    def distances(self, parallel):
+        self.grp.SetBool("ParallelInspection", parallel)
+        self.inspection.touch()
+        self.Doc.recompute()
+        return self.inspection.Distances
+
+    def testParallelDistances(self):
+        serial = self.distances(False)
+        parallel = self.distances(True)
+        # more points than one range of 1024 points
+        self.assertGreater(len(serial), 2048)
+        self.assertEqual(len(serial), self.inspection.Actual.Mesh.CountPoints)
+        self.assertEqual(len(parallel), len(serial))
+        for s, p in zip(serial, parallel):
+            self.assertAlmostEqual(s, p, 5)
+            self.assertAlmostEqual(abs(s), 0.1, 2)
+
+    def tearDown(self):
+        self.grp.SetBool("ParallelInspection", self.parallel)
+        FreeCAD.closeDocument(self.Doc.Name)
@@ -25,11 +25,13 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <atomic>
 #endif
 
 #include "Algorithm.h"
 #include "Approximation.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "Grid.h"
 #include "Triangulation.h"
@@ -643,7 +645,7 @@ void MeshAlgorithm::SplitBoundaryLoops(const std::vector<unsigned long>& rBound,
 bool MeshAlgorithm::FillupHole(const std::vector<unsigned long>& boundary, 
                                AbstractPolygonTriangulator& cTria, 
                                MeshFacetArray& rFaces, MeshPointArray& rPoints,
-                               int level, const MeshRefPointToFacets* pP2FStructure) const
+                               int level, const MeshCompactPointToFacets* pP2FStructure) const
 {
     if (boundary.front() == boundary.back()) {
         // first and last vertex are identical
@@ -660,8 +662,8 @@ bool MeshAlgorithm::FillupHole(const std::vector<unsigned long>& boundary,
     unsigned long refPoint0 = *(boundary.begin());
     unsigned long refPoint1 = *(boundary.begin()+1);
     if (pP2FStructure) {
-        const std::set<unsigned long>& ring1 = (*pP2FStructure)[refPoint0];
-        const std::set<unsigned long>& ring2 = (*pP2FStructure)[refPoint1];
+        MeshIndexRange ring1 = (*pP2FStructure)[refPoint0];
+        MeshIndexRange ring2 = (*pP2FStructure)[refPoint1];
         std::vector<unsigned long> f_int;
         std::set_intersection(ring1.begin(), ring1.end(), ring2.begin(), ring2.end(),
             std::back_insert_iterator<std::vector<unsigned long> >(f_int));
@@ -2044,3 +2046,377 @@ MeshRefNormalToPoints::operator[] (unsigned long pos) const
 {
     return _norm[pos];
 }
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+typedef std::vector<std::atomic<unsigned long> > AtomicCounters;
+
+int adjacencyThreads(unsigned long count)
+{
+    // for small meshes the threads cost more than they save
+    if (count < 100000)
+        return 1;
+    return std::max(1, QThread::idealThreadCount());
+}
+
+// Returns false if the point at the corner already appears at a previous corner of a degenerated facet
+inline bool isFirstCorner(const MeshFacet& face, int corner)
+{
+    for (int i = 0; i < corner; i++) {
+        if (face._aulPoints[i] == face._aulPoints[corner])
+            return false;
+    }
+    return true;
+}
+
+struct PointFacetCounter
+{
+    PointFacetCounter(const MeshFacetArray& f, AtomicCounters& c)
+      : facets(f), counters(c)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long index = begin; index < end; index++) {
+            const MeshFacet& face = facets[index];
+            for (int i = 0; i < 3; i++) {
+                if (isFirstCorner(face, i))
+                    counters[face._aulPoints[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    const MeshFacetArray& facets;
+    AtomicCounters& counters;
+};
+
+struct PointFacetFiller
+{
+    PointFacetFiller(const MeshFacetArray& f, AtomicCounters& c, std::vector<unsigned long>& i)
+      : facets(f), cursors(c), indices(i)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long index = begin; index < end; index++) {
+            const MeshFacet& face = facets[index];
+            for (int i = 0; i < 3; i++) {
+                if (isFirstCorner(face, i))
+                    indices[cursors[face._aulPoints[i]].fetch_add(1, std::memory_order_relaxed)] = index;
+            }
+        }
+    }
+    const MeshFacetArray& facets;
+    AtomicCounters& cursors;
+    std::vector<unsigned long>& indices;
+};
+
+struct RowSorter
+{
+    RowSorter(const std::vector<unsigned long>& o, std::vector<unsigned long>& i)
+      : offsets(o), indices(i)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long index = begin; index < end; index++)
+            std::sort(indices.begin() + offsets[index], indices.begin() + offsets[index + 1]);
+    }
+    const std::vector<unsigned long>& offsets;
+    std::vector<unsigned long>& indices;
+};
+
+// Collects the facets sharing a point with a facet
+struct FacetNeighbourGather
+{
+    FacetNeighbourGather(const MeshFacetArray& f, const MeshCompactPointToFacets& p)
+      : facets(f), pointFacets(p)
+    {
+    }
+    void operator()(unsigned long index, std::vector<unsigned long>& row) const
+    {
+        for (int i = 0; i < 3; i++) {
+            MeshIndexRange faces = pointFacets[facets[index]._aulPoints[i]];
+            row.insert(row.end(), faces.begin(), faces.end());
+        }
+    }
+    const MeshFacetArray& facets;
+    const MeshCompactPointToFacets& pointFacets;
+};
+
+// Collects the points sharing an edge with a point
+struct PointNeighbourGather
+{
+    PointNeighbourGather(const MeshFacetArray& f, const MeshCompactPointToFacets& p)
+      : facets(f), pointFacets(p)
+    {
+    }
+    void operator()(unsigned long index, std::vector<unsigned long>& row) const
+    {
+        MeshIndexRange faces = pointFacets[index];
+        for (MeshIndexRange::const_iterator it = faces.begin(); it != faces.end(); ++it) {
+            for (int i = 0; i < 3; i++) {
+                unsigned long point = facets[*it]._aulPoints[i];
+                if (point != index)
+                    row.push_back(point);
+            }
+        }
+    }
+    const MeshFacetArray& facets;
+    const MeshCompactPointToFacets& pointFacets;
+};
+
+// Counts or, if the offsets are known, fills the distinct indices of the rows
+template <class Gather>
+struct RowBuilder
+{
+    RowBuilder(const Gather& g, std::vector<unsigned long>& o, std::vector<unsigned long>& i, bool f)
+      : gather(g), offsets(o), indices(i), fill(f)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        std::vector<unsigned long> row;
+        for (unsigned long index = begin; index < end; index++) {
+            row.clear();
+            gather(index, row);
+            std::sort(row.begin(), row.end());
+            std::vector<unsigned long>::iterator last = std::unique(row.begin(), row.end());
+            if (fill)
+                std::copy(row.begin(), last, indices.begin() + offsets[index]);
+            else
+                offsets[index + 1] = static_cast<unsigned long>(last - row.begin());
+        }
+    }
+    const Gather& gather;
+    std::vector<unsigned long>& offsets;
+    std::vector<unsigned long>& indices;
+    bool fill;
+};
+
+template <class Gather>
+void buildCompactRows(unsigned long count, const Gather& gather,
+                      std::vector<unsigned long>& offsets, std::vector<unsigned long>& indices)
+{
+    int threads = adjacencyThreads(count);
+    offsets.assign(count + 1, 0);
+    indices.clear();
+    parallel_for(count, RowBuilder<Gather>(gather, offsets, indices, false), threads);
+
+    for (unsigned long i = 0; i < count; i++)
+        offsets[i + 1] += offsets[i];
+
+    indices.resize(offsets[count]);
+    parallel_for(count, RowBuilder<Gather>(gather, offsets, indices, true), threads);
+}
+
+}
+
+void MeshCompactPointToFacets::Rebuild (void)
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    unsigned long countPoints = _rclMesh.CountPoints();
+    unsigned long countFacets = _rclMesh.CountFacets();
+    int threads = adjacencyThreads(countFacets);
+
+    // counting sort of the facets by their points
+    AtomicCounters counters(countPoints);
+    for (AtomicCounters::iterator it = counters.begin(); it != counters.end(); ++it)
+        it->store(0, std::memory_order_relaxed);
+    parallel_for(countFacets, PointFacetCounter(rFacets, counters), threads);
+
+    _offsets.assign(countPoints + 1, 0);
+    for (unsigned long i = 0; i < countPoints; i++) {
+        _offsets[i + 1] = _offsets[i] + counters[i].load(std::memory_order_relaxed);
+        counters[i].store(_offsets[i], std::memory_order_relaxed);
+    }
+
+    _indices.clear();
+    _indices.resize(_offsets[countPoints]);
+    parallel_for(countFacets, PointFacetFiller(rFacets, counters, _indices), threads);
+
+    // concurrently added facets are in arbitrary order
+    if (threads > 1)
+        parallel_for(countPoints, RowSorter(_offsets, _indices), threads);
+}
+
+Base::Vector3f MeshCompactPointToFacets::GetNormal(unsigned long pos) const
+{
+    MeshIndexRange n = (*this)[pos];
+    Base::Vector3f normal;
+    MeshGeomFacet f;
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
+        f = _rclMesh.GetFacet(*it);
+        normal += f.Area() * f.GetNormal();
+    }
+
+    normal.Normalize();
+    return normal;
+}
+
+std::set<unsigned long> MeshCompactPointToFacets::NeighbourPoints(const std::vector<unsigned long>& pt, int level) const
+{
+    std::set<unsigned long> cp,nb,lp;
+    cp.insert(pt.begin(), pt.end());
+    lp.insert(pt.begin(), pt.end());
+    MeshFacetArray::_TConstIterator f_it = _rclMesh.GetFacets().begin();
+    for (int i=0; i < level; i++) {
+        std::set<unsigned long> cur;
+        for (std::set<unsigned long>::iterator it = lp.begin(); it != lp.end(); ++it) {
+            MeshIndexRange ft = (*this)[*it];
+            for (MeshIndexRange::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
+                for (int j = 0; j < 3; j++) {
+                    unsigned long index = f_it[*jt]._aulPoints[j];
+                    if (cp.find(index) == cp.end() && nb.find(index) == nb.end()) {
+                        nb.insert(index);
+                        cur.insert(index);
+                    }
+                }
+            }
+        }
+
+        lp = cur;
+        if (lp.empty())
+            break;
+    }
+    return nb;
+}
+
+std::set<unsigned long> MeshCompactPointToFacets::NeighbourPoints(unsigned long pos) const
+{
+    std::set<unsigned long> p;
+    MeshIndexRange vf = (*this)[pos];
+    for (MeshIndexRange::const_iterator it = vf.begin(); it != vf.end(); ++it) {
+        unsigned long p1, p2, p3;
+        _rclMesh.GetFacetPoints(*it, p1, p2, p3);
+        if (p1 != pos)
+            p.insert(p1);
+        if (p2 != pos)
+            p.insert(p2);
+        if (p3 != pos)
+            p.insert(p3);
+    }
+
+    return p;
+}
+
+void MeshCompactPointToFacets::Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const
+{
+    // an explicit stack because with a large distance the recursion of MeshRefPointToFacets
+    // may overflow the call stack
+    std::set<unsigned long> visited;
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    Base::Vector3f clCenter = _rclMesh.GetFacet(ulFacetInd).GetGravityPoint();
+    float fMaxDist2 = fMaxDist * fMaxDist;
+
+    std::vector<unsigned long> stack;
+    stack.push_back(ulFacetInd);
+    while (!stack.empty()) {
+        unsigned long index = stack.back();
+        stack.pop_back();
+        if (visited.find(index) != visited.end())
+            continue;
+
+        const MeshFacet& face = rFacets[index];
+        if (Base::DistanceP2(clCenter, _rclMesh.GetFacet(face).GetGravityPoint()) > fMaxDist2)
+            continue;
+
+        visited.insert(index);
+        collect.Append(_rclMesh, index);
+        for (int i = 2; i >= 0; i--) {
+            MeshIndexRange f = (*this)[face._aulPoints[i]];
+            for (MeshIndexRange::const_iterator j = f.end(); j != f.begin();) {
+                --j;
+                if (visited.find(*j) == visited.end())
+                    stack.push_back(*j);
+            }
+        }
+    }
+}
+
+MeshFacetArray::_TConstIterator
+MeshCompactPointToFacets::GetFacet (unsigned long index) const
+{
+    return _rclMesh.GetFacets().begin() + index;
+}
+
+std::vector<unsigned long>
+MeshCompactPointToFacets::GetIndices(unsigned long pos1, unsigned long pos2) const
+{
+    std::vector<unsigned long> intersection;
+    std::back_insert_iterator<std::vector<unsigned long> > result(intersection);
+    MeshIndexRange set1 = (*this)[pos1];
+    MeshIndexRange set2 = (*this)[pos2];
+    std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), result);
+    return intersection;
+}
+
+std::vector<unsigned long>
+MeshCompactPointToFacets::GetIndices(unsigned long pos1, unsigned long pos2, unsigned long pos3) const
+{
+    std::vector<unsigned long> intersection;
+    std::back_insert_iterator<std::vector<unsigned long> > result(intersection);
+    std::vector<unsigned long> set1 = GetIndices(pos1, pos2);
+    MeshIndexRange set2 = (*this)[pos3];
+    std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), result);
+    return intersection;
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactFacetToFacets::Rebuild (void)
+{
+    MeshCompactPointToFacets vertexFace(_rclMesh);
+    FacetNeighbourGather gather(_rclMesh.GetFacets(), vertexFace);
+    buildCompactRows(_rclMesh.CountFacets(), gather, _offsets, _indices);
+}
+
+std::vector<unsigned long>
+MeshCompactFacetToFacets::GetIndices(unsigned long pos1, unsigned long pos2) const
+{
+    std::vector<unsigned long> intersection;
+    std::back_insert_iterator<std::vector<unsigned long> > result(intersection);
+    MeshIndexRange set1 = (*this)[pos1];
+    MeshIndexRange set2 = (*this)[pos2];
+    std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), result);
+    return intersection;
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactPointToPoints::Rebuild (void)
+{
+    MeshCompactPointToFacets vertexFace(_rclMesh);
+    PointNeighbourGather gather(_rclMesh.GetFacets(), vertexFace);
+    buildCompactRows(_rclMesh.CountPoints(), gather, _offsets, _indices);
+}
+
+Base::Vector3f MeshCompactPointToPoints::GetNormal(unsigned long pos) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    MeshCore::PlaneFit pf;
+    pf.AddPoint(rPoints[pos]);
+    MeshIndexRange cv = (*this)[pos];
+    for (MeshIndexRange::const_iterator cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
+        pf.AddPoint(rPoints[*cv_it]);
+    }
+
+    pf.Fit();
+
+    Base::Vector3f normal = pf.GetNormal();
+    normal.Normalize();
+    return normal;
+}
+
+float MeshCompactPointToPoints::GetAverageEdgeLength(unsigned long index) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    float len=0.0f;
+    MeshIndexRange n = (*this)[index];
+    const Base::Vector3f& p = rPoints[index];
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
+        len += Base::Distance(p, rPoints[*it]);
+    }
+    return (len/n.size());
+}
@@ -24,6 +24,7 @@
 #ifndef MESHALGORITHM_H
 #define MESHALGORITHM_H
 
+#include <algorithm>
 #include <set>
 #include <vector>
 #include <map>
@@ -46,7 +47,7 @@ class MeshGeomEdge;
 class MeshKernel;
 class MeshFacetGrid;
 class MeshFacetArray;
-class MeshRefPointToFacets;
+class MeshCompactPointToFacets;
 class AbstractPolygonTriangulator;
 
 /**
@@ -175,7 +176,7 @@ public:
   bool FillupHole(const std::vector<unsigned long>& boundary,
                   AbstractPolygonTriangulator& cTria,
                   MeshFacetArray& rFaces, MeshPointArray& rPoints,
-                  int level, const MeshRefPointToFacets* pP2FStructure=0) const;
+                  int level, const MeshCompactPointToFacets* pP2FStructure=0) const;
   /** Sets to all facets in \a raulInds the properties in raulProps. 
    * \note Both arrays must have the same size.
    */
@@ -523,6 +524,135 @@ protected:
     std::vector<Base::Vector3f> _norm;
 };
 
+/**
+ * The MeshIndexRange gives access to the sorted indices that an element of a
+ * MeshCompactAdjacency structure refers to. It offers the read-only part of
+ * the interface of std::set.
+ */
+class MeshIndexRange
+{
+public:
+    typedef const unsigned long* const_iterator;
+    typedef const unsigned long* iterator;
+
+    MeshIndexRange (const unsigned long* first, const unsigned long* last)
+      : _first(first), _last(last)
+    { }
+
+    const_iterator begin (void) const
+    { return _first; }
+    const_iterator end (void) const
+    { return _last; }
+    std::size_t size (void) const
+    { return static_cast<std::size_t>(_last - _first); }
+    bool empty (void) const
+    { return _first == _last; }
+    /// Returns the position of \a index or end() if it's not in the range.
+    const_iterator find (unsigned long index) const
+    {
+        const_iterator it = std::lower_bound(_first, _last, index);
+        return (it != _last && *it == index) ? it : _last;
+    }
+    std::size_t count (unsigned long index) const
+    { return find(index) != _last ? 1 : 0; }
+
+private:
+    const unsigned long* _first;
+    const unsigned long* _last;
+};
+
+/**
+ * The MeshCompactAdjacency is the base class of the read-only counterparts of the
+ * MeshRefPointToFacets, MeshRefFacetToFacets and MeshRefPointToPoints structures.
+ * Instead of a std::set per element it keeps the sorted indices of all elements in
+ * one array and the start of each element in a second array (compressed sparse row).
+ * This needs a fraction of the memory and the structure is built in parallel.
+ * \note If the underlying mesh kernel gets changed this structure becomes invalid and
+ * must be rebuilt.
+ */
+class MeshExport MeshCompactAdjacency
+{
+public:
+    /// Returns the number of elements
+    unsigned long Size (void) const
+    { return _offsets.empty() ? 0 : static_cast<unsigned long>(_offsets.size() - 1); }
+    /// Returns the sorted indices of the element \a pos
+    MeshIndexRange operator[] (unsigned long pos) const
+    {
+        const unsigned long* data = _indices.data();
+        return MeshIndexRange(data + _offsets[pos], data + _offsets[pos + 1]);
+    }
+
+protected:
+    MeshCompactAdjacency (const MeshKernel &rclM) : _rclMesh(rclM)
+    { }
+    ~MeshCompactAdjacency (void)
+    { }
+
+protected:
+    const MeshKernel  &_rclMesh; /**< The mesh kernel. */
+    std::vector<unsigned long> _offsets; /**< The start of each element in _indices. */
+    std::vector<unsigned long> _indices; /**< The indices of all elements. */
+};
+
+/**
+ * The MeshCompactPointToFacets builds up a structure to have access to all facets
+ * indexing a point. It provides the query methods of MeshRefPointToFacets.
+ */
+class MeshExport MeshCompactPointToFacets : public MeshCompactAdjacency
+{
+public:
+    /// Construction
+    MeshCompactPointToFacets (const MeshKernel &rclM) : MeshCompactAdjacency(rclM)
+    { Rebuild(); }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    std::vector<unsigned long> GetIndices(unsigned long, unsigned long) const;
+    std::vector<unsigned long> GetIndices(unsigned long, unsigned long, unsigned long) const;
+    MeshFacetArray::_TConstIterator GetFacet (unsigned long) const;
+    std::set<unsigned long> NeighbourPoints(const std::vector<unsigned long>& , int level) const;
+    std::set<unsigned long> NeighbourPoints(unsigned long) const;
+    void Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const;
+    Base::Vector3f GetNormal(unsigned long) const;
+};
+
+/**
+ * The MeshCompactFacetToFacets builds up a structure to have access to all facets
+ * sharing at least one point with a facet. It provides the query methods of
+ * MeshRefFacetToFacets.
+ */
+class MeshExport MeshCompactFacetToFacets : public MeshCompactAdjacency
+{
+public:
+    /// Construction
+    MeshCompactFacetToFacets (const MeshKernel &rclM) : MeshCompactAdjacency(rclM)
+    { Rebuild(); }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    /// Returns an array of common facets of the passed facet indexes.
+    std::vector<unsigned long> GetIndices(unsigned long, unsigned long) const;
+};
+
+/**
+ * The MeshCompactPointToPoints builds up a structure to have access to all
+ * neighbour points of a point. It provides the query methods of
+ * MeshRefPointToPoints.
+ */
+class MeshExport MeshCompactPointToPoints : public MeshCompactAdjacency
+{
+public:
+    /// Construction
+    MeshCompactPointToPoints (const MeshKernel &rclM) : MeshCompactAdjacency(rclM)
+    { Rebuild(); }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    Base::Vector3f GetNormal(unsigned long) const;
+    float GetAverageEdgeLength(unsigned long) const;
+};
+
 } // namespace MeshCore 
 
 #endif  // MESH_ALGORITHM_H 
@@ -41,6 +41,7 @@
 #include "Curvature.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "MeshKernel.h"
 #include "Iterator.h"
 #include "Tools.h"
@@ -51,6 +52,7 @@ using namespace MeshCore;
 
 MeshCurvature::MeshCurvature(const MeshKernel& kernel)
   : myKernel(kernel), myMinPoints(20), myRadius(0.5f)
+  , myThreads(std::max(1, QThread::idealThreadCount()))
 {
     mySegment.resize(kernel.CountFacets());
     std::generate(mySegment.begin(), mySegment.end(), Base::iotaGen<unsigned long>(0));
@@ -58,6 +60,7 @@ MeshCurvature::MeshCurvature(const MeshKernel& kernel)
 
 MeshCurvature::MeshCurvature(const MeshKernel& kernel, const std::vector<unsigned long>& segm)
   : myKernel(kernel), myMinPoints(20), myRadius(0.5f), mySegment(segm)
+  , myThreads(std::max(1, QThread::idealThreadCount()))
 {
 }
 
@@ -66,7 +69,7 @@ void MeshCurvature::ComputePerFace(bool parallel)
     Base::Vector3f rkDir0, rkDir1, rkPnt;
     Base::Vector3f rkNormal;
     myCurvature.clear();
-    MeshRefPointToFacets search(myKernel);
+    MeshCompactPointToFacets search(myKernel);
     FacetCurvature face(myKernel, search, myRadius, myMinPoints);
 
     if (!parallel) {
@@ -126,8 +129,8 @@ void MeshCurvature::ComputePerVertex()
     // get all points
     const MeshPointArray& pts = myKernel.GetPoints();
 
-    MeshCore::MeshRefPointToFacets pt2f(myKernel);
-    MeshCore::MeshRefPointToPoints pt2p(myKernel);
+    MeshCore::MeshCompactPointToFacets pt2f(myKernel);
+    MeshCore::MeshCompactPointToPoints pt2p(myKernel);
     unsigned long numPoints = myKernel.CountPoints();
 
     myCurvature.clear();
@@ -161,8 +164,8 @@ void MeshCurvature::ComputePerVertex()
 
         int iV0 = i;
         int iV1;
-        const std::set<unsigned long>& nb = pt2p[i];
-        for (std::set<unsigned long>::const_iterator it = nb.begin(); it != nb.end(); ++it) {
+        MeshCore::MeshIndexRange nb = pt2p[i];
+        for (MeshCore::MeshIndexRange::const_iterator it = nb.begin(); it != nb.end(); ++it) {
             iV1 = *it;
 
             // Compute edge from V0 to V1, project to tangent plane of vertex,
@@ -288,10 +291,193 @@ void MeshCurvature::ComputePerVertex()
     }
 }
 #else
+namespace {
+
+// Computes the same normals as Wm4::MeshCurvature but gathers the facets of each point. The facets
+// are added in the same order, so the points can be handled concurrently with identical results.
+class VertexNormals
+{
+public:
+    VertexNormals(const std::vector< Wm4::Vector3<double> >& v, const MeshFacetArray& f,
+                  const MeshCompactPointToFacets& pf, std::vector< Wm4::Vector3<double> >& n)
+      : vertices(v), facets(f), pointFacets(pf), normals(n)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long i = begin; i < end; i++) {
+            Wm4::Vector3<double> normal(0.0, 0.0, 0.0);
+            MeshIndexRange faces = pointFacets[i];
+            for (MeshIndexRange::const_iterator it = faces.begin(); it != faces.end(); ++it) {
+                const MeshFacet& face = facets[*it];
+
+                // compute the normal (length provides a weighted sum)
+                Wm4::Vector3<double> kEdge1 = vertices[face._aulPoints[1]] - vertices[face._aulPoints[0]];
+                Wm4::Vector3<double> kEdge2 = vertices[face._aulPoints[2]] - vertices[face._aulPoints[0]];
+                Wm4::Vector3<double> kNormal = kEdge1.Cross(kEdge2);
+                for (int j = 0; j < 3; j++) {
+                    if (face._aulPoints[j] == i)
+                        normal += kNormal;
+                }
+            }
+            normal.Normalize();
+            normals[i] = normal;
+        }
+    }
+
+private:
+    const std::vector< Wm4::Vector3<double> >& vertices;
+    const MeshFacetArray& facets;
+    const MeshCompactPointToFacets& pointFacets;
+    std::vector< Wm4::Vector3<double> >& normals;
+};
+
+// Computes the curvature of each point like Wm4::MeshCurvature
+class VertexCurvature
+{
+public:
+    VertexCurvature(const std::vector< Wm4::Vector3<double> >& v, const std::vector< Wm4::Vector3<double> >& n,
+                    const MeshFacetArray& f, const MeshCompactPointToFacets& pf, std::vector<CurvatureInfo>& c)
+      : vertices(v), normals(n), facets(f), pointFacets(pf), curvature(c)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long i = begin; i < end; i++)
+            curvature[i] = Compute(i);
+    }
+
+private:
+    CurvatureInfo Compute(unsigned long i) const
+    {
+        typedef Wm4::Vector3<double> Vector3;
+        typedef Wm4::Vector2<double> Vector2;
+        typedef Wm4::Matrix3<double> Matrix3;
+        typedef Wm4::Matrix2<double> Matrix2;
+
+        // compute the matrix of normal derivatives
+        Matrix3 kWWTrn(true);
+        Matrix3 kDWTrn(true);
+        int iRow, iCol;
+        MeshIndexRange faces = pointFacets[i];
+        for (MeshIndexRange::const_iterator it = faces.begin(); it != faces.end(); ++it) {
+            const MeshFacet& face = facets[*it];
+            for (int j = 0; j < 3; j++) {
+                if (face._aulPoints[j] != i)
+                    continue;
+                unsigned long iV0 = face._aulPoints[j];
+                unsigned long iV1 = face._aulPoints[(j+1)%3];
+                unsigned long iV2 = face._aulPoints[(j+2)%3];
+
+                // Compute edge from V0 to V1, project to tangent plane of vertex,
+                // and compute difference of adjacent normals.
+                Vector3 kE = vertices[iV1] - vertices[iV0];
+                Vector3 kW = kE - (kE.Dot(normals[iV0]))*normals[iV0];
+                Vector3 kD = normals[iV1] - normals[iV0];
+                for (iRow = 0; iRow < 3; iRow++) {
+                    for (iCol = 0; iCol < 3; iCol++) {
+                        kWWTrn[iRow][iCol] += kW[iRow]*kW[iCol];
+                        kDWTrn[iRow][iCol] += kD[iRow]*kW[iCol];
+                    }
+                }
+
+                // Compute edge from V0 to V2, project to tangent plane of vertex,
+                // and compute difference of adjacent normals.
+                kE = vertices[iV2] - vertices[iV0];
+                kW = kE - (kE.Dot(normals[iV0]))*normals[iV0];
+                kD = normals[iV2] - normals[iV0];
+                for (iRow = 0; iRow < 3; iRow++) {
+                    for (iCol = 0; iCol < 3; iCol++) {
+                        kWWTrn[iRow][iCol] += kW[iRow]*kW[iCol];
+                        kDWTrn[iRow][iCol] += kD[iRow]*kW[iCol];
+                    }
+                }
+            }
+        }
+
+        // Add in N*N^T to W*W^T for numerical stability.
+        const Vector3& kN = normals[i];
+        for (iRow = 0; iRow < 3; iRow++) {
+            for (iCol = 0; iCol < 3; iCol++) {
+                kWWTrn[iRow][iCol] = 0.5*kWWTrn[iRow][iCol] + kN[iRow]*kN[iCol];
+                kDWTrn[iRow][iCol] *= 0.5;
+            }
+        }
+
+        Matrix3 kDNormal = kDWTrn*kWWTrn.Inverse();
+
+        // compute U and V given N
+        Vector3 kU, kV;
+        Vector3::GenerateComplementBasis(kU,kV,kN);
+
+        // Compute S = J^T * dN/dX * J, see Wm4::MeshCurvature
+        double fS01 = kU.Dot(kDNormal*kV);
+        double fS10 = kV.Dot(kDNormal*kU);
+        double fSAvr = 0.5*(fS01+fS10);
+        Matrix2 kS
+        (
+            kU.Dot(kDNormal*kU), fSAvr,
+            fSAvr, kV.Dot(kDNormal*kV)
+        );
+
+        // compute the eigenvalues of S (min and max curvatures)
+        double fTrace = kS[0][0] + kS[1][1];
+        double fDet = kS[0][0]*kS[1][1] - kS[0][1]*kS[1][0];
+        double fDiscr = fTrace*fTrace - 4.0*fDet;
+        double fRootDiscr = Wm4::Math<double>::Sqrt(Wm4::Math<double>::FAbs(fDiscr));
+        double fMinCurvature = 0.5*(fTrace - fRootDiscr);
+        double fMaxCurvature = 0.5*(fTrace + fRootDiscr);
+
+        // compute the eigenvectors of S
+        Vector3 kMinDirection, kMaxDirection;
+        Vector2 kW0(kS[0][1],fMinCurvature-kS[0][0]);
+        Vector2 kW1(fMinCurvature-kS[1][1],kS[1][0]);
+        if (kW0.SquaredLength() >= kW1.SquaredLength()) {
+            kW0.Normalize();
+            kMinDirection = kW0.X()*kU + kW0.Y()*kV;
+        }
+        else {
+            kW1.Normalize();
+            kMinDirection = kW1.X()*kU + kW1.Y()*kV;
+        }
+
+        kW0 = Vector2(kS[0][1],fMaxCurvature-kS[0][0]);
+        kW1 = Vector2(fMaxCurvature-kS[1][1],kS[1][0]);
+        if (kW0.SquaredLength() >= kW1.SquaredLength()) {
+            kW0.Normalize();
+            kMaxDirection = kW0.X()*kU + kW0.Y()*kV;
+        }
+        else {
+            kW1.Normalize();
+            kMaxDirection = kW1.X()*kU + kW1.Y()*kV;
+        }
+
+        CurvatureInfo ci;
+        ci.cMaxCurvDir = Base::Vector3f((float)kMaxDirection.X(), (float)kMaxDirection.Y(), (float)kMaxDirection.Z());
+        ci.cMinCurvDir = Base::Vector3f((float)kMinDirection.X(), (float)kMinDirection.Y(), (float)kMinDirection.Z());
+        ci.fMaxCurvature = (float)fMaxCurvature;
+        ci.fMinCurvature = (float)fMinCurvature;
+        return ci;
+    }
+
+private:
+    const std::vector< Wm4::Vector3<double> >& vertices;
+    const std::vector< Wm4::Vector3<double> >& normals;
+    const MeshFacetArray& facets;
+    const MeshCompactPointToFacets& pointFacets;
+    std::vector<CurvatureInfo>& curvature;
+};
+
+}
+
 void MeshCurvature::ComputePerVertex()
 {
     myCurvature.clear();
 
+    // in case of an empty mesh no curvature can be calculated
+    if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0)
+        return;
+
     // get all points
     std::vector< Wm4::Vector3<double> > aPnts;
     aPnts.reserve(myKernel.CountPoints());
@@ -301,38 +487,17 @@ void MeshCurvature::ComputePerVertex()
         aPnts.push_back(cP);
     }
 
-    // get all point connections
-    std::vector<int> aIdx;
-    aIdx.reserve(3*myKernel.CountFacets());
+    // Does the same as Wm4::MeshCurvature, but point by point. So, all points are computed in
+    // parallel and the result doesn't depend on the number of threads.
+    unsigned long numPoints = myKernel.CountPoints();
     const MeshFacetArray& raFts = myKernel.GetFacets();
-    for (MeshFacetArray::const_iterator jt = raFts.begin(); jt != raFts.end(); ++jt) {
-        for (int i=0; i<3; i++) {
-            aIdx.push_back((int)jt->_aulPoints[i]);
-        }
-    }
+    MeshCompactPointToFacets pt2f(myKernel);
 
-    // in case of an empty mesh no curvature can be calculated
-    if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0)
-        return;
-
-    // compute vertex based curvatures
-    Wm4::MeshCurvature<double> meshCurv(myKernel.CountPoints(), &(aPnts[0]), myKernel.CountFacets(), &(aIdx[0]));
+    std::vector< Wm4::Vector3<double> > aNormals(numPoints);
+    parallel_for(numPoints, VertexNormals(aPnts, raFts, pt2f, aNormals), myThreads);
 
-    // get curvature information now
-    const Wm4::Vector3<double>* aMaxCurvDir = meshCurv.GetMaxDirections();
-    const Wm4::Vector3<double>* aMinCurvDir = meshCurv.GetMinDirections();
-    const double* aMaxCurv = meshCurv.GetMaxCurvatures();
-    const double* aMinCurv = meshCurv.GetMinCurvatures();
-
-    myCurvature.reserve(myKernel.CountPoints());
-    for (unsigned long i=0; i<myKernel.CountPoints(); i++) {
-        CurvatureInfo ci;
-        ci.cMaxCurvDir = Base::Vector3f((float)aMaxCurvDir[i].X(), (float)aMaxCurvDir[i].Y(), (float)aMaxCurvDir[i].Z());
-        ci.cMinCurvDir = Base::Vector3f((float)aMinCurvDir[i].X(), (float)aMinCurvDir[i].Y(), (float)aMinCurvDir[i].Z());
-        ci.fMaxCurvature = (float)aMaxCurv[i];
-        ci.fMinCurvature = (float)aMinCurv[i];
-        myCurvature.push_back(ci);
-    }
+    myCurvature.resize(numPoints);
+    parallel_for(numPoints, VertexCurvature(aPnts, aNormals, raFts, pt2f, myCurvature), myThreads);
 }
 #endif // OPTIMIZE_CURVATURE
 
@@ -359,7 +524,7 @@ private:
 
 // --------------------------------------------------------
 
-FacetCurvature::FacetCurvature(const MeshKernel& kernel, const MeshRefPointToFacets& search, float r, unsigned long pt)
+FacetCurvature::FacetCurvature(const MeshKernel& kernel, const MeshCompactPointToFacets& search, float r, unsigned long pt)
   : myKernel(kernel), mySearch(search), myMinPoints(pt), myRadius(r)
 {
 }
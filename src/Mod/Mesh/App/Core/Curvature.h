@@ -29,7 +29,7 @@
 namespace MeshCore {
 
 class MeshKernel;
-class MeshRefPointToFacets;
+class MeshCompactPointToFacets;
 
 /** Curvature information. */
 struct MeshExport CurvatureInfo
@@ -41,12 +41,12 @@ struct MeshExport CurvatureInfo
 class MeshExport FacetCurvature
 {
 public:
-    FacetCurvature(const MeshKernel& kernel, const MeshRefPointToFacets& search, float, unsigned long);
+    FacetCurvature(const MeshKernel& kernel, const MeshCompactPointToFacets& search, float, unsigned long);
     CurvatureInfo Compute(unsigned long index) const;
 
 private:
     const MeshKernel& myKernel;
-    const MeshRefPointToFacets& mySearch;
+    const MeshCompactPointToFacets& mySearch;
     unsigned long myMinPoints;
     float myRadius;
 };
@@ -61,6 +61,10 @@ public:
     void ComputePerFace(bool parallel);
     void ComputePerVertex();
     const std::vector<CurvatureInfo>& GetCurvature() const { return myCurvature; }
+    /** Sets the number of threads of ComputePerVertex(). The result is the same for any
+     * number of threads. The default is the number of processor cores.
+     */
+    void SetThreads(int t) { myThreads = t > 1 ? t : 1; }
 
 private:
     const MeshKernel& myKernel;
@@ -68,6 +72,7 @@ private:
     float myRadius;
     std::vector<unsigned long> mySegment;
     std::vector<CurvatureInfo> myCurvature;
+    int myThreads;
 };
 
 } // MeshCore
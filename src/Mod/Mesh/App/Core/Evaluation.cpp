@@ -28,6 +28,11 @@
 # include <vector>
 #endif
 
+#include <QFuture>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <boost/bind.hpp>
+
 #include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
@@ -591,76 +596,296 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
-bool MeshEvalSelfIntersection::Evaluate ()
+namespace MeshCore {
+namespace SelfIntersection {
+
+typedef std::pair<unsigned long, unsigned long> FacetPair;
+typedef std::vector<FacetPair> FacetPairs;
+typedef std::pair<unsigned long, unsigned long> FacetRange;
+
+/**
+ * Bounding volume hierarchy over the facet boxes. Nodes are split at the median
+ * of the facet centers along their longest axis which keeps the tree balanced
+ * even if the facet sizes vary a lot, where a uniform grid degenerates.
+ */
+class FacetBoxTree
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
+public:
+    FacetBoxTree(const std::vector<Base::BoundBox3f>& boxes)
+      : _boxes(boxes)
+    {
+        _indices.resize(boxes.size());
+        for (unsigned long i = 0; i < _indices.size(); i++)
+            _indices[i] = i;
+        if (!_indices.empty()) {
+            _nodes.reserve(2 * (_indices.size() / LeafSize + 1));
+            Build(0, _indices.size());
+        }
+    }
 
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
+    /// Appends the index of every facet whose box overlaps \a box
+    void Overlaps(const Base::BoundBox3f& box, std::vector<unsigned long>& result) const
+    {
+        if (_nodes.empty())
+            return;
+        std::vector<unsigned long> stack;
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (!(node.box && box))
+                continue;
+            if (node.count > 0) {
+                for (unsigned long i = node.first; i < node.first + node.count; i++) {
+                    if (_boxes[_indices[i]] && box)
+                        result.push_back(_indices[i]);
+                }
+            }
+            else {
+                stack.push_back(node.left);
+                stack.push_back(node.right);
+            }
+        }
+    }
 
-    MeshFacetIterator cMFI(_rclMesh);
-    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
+private:
+    static const unsigned long LeafSize = 8;
+
+    struct Node {
+        Base::BoundBox3f box;
+        unsigned long first, count;
+        unsigned long left, right;
+    };
+
+    struct CenterLess {
+        CenterLess(const std::vector<Base::BoundBox3f>& b, int a) : boxes(b), axis(a) {}
+        bool operator()(unsigned long i, unsigned long j) const {
+            return boxes[i].GetCenter()[axis] < boxes[j].GetCenter()[axis];
+        }
+        const std::vector<Base::BoundBox3f>& boxes;
+        int axis;
+    };
+
+    unsigned long Build(unsigned long first, unsigned long last)
+    {
+        unsigned long index = _nodes.size();
+        _nodes.push_back(Node());
+
+        Base::BoundBox3f box;
+        for (unsigned long i = first; i < last; i++)
+            box.Add(_boxes[_indices[i]]);
+        _nodes[index].box = box;
+
+        if (last - first <= LeafSize) {
+            _nodes[index].first = first;
+            _nodes[index].count = last - first;
+            return index;
+        }
+
+        int axis = 0;
+        if (box.LengthY() > box.LengthX())
+            axis = 1;
+        if (box.LengthZ() > std::max(box.LengthX(), box.LengthY()))
+            axis = 2;
+
+        unsigned long mid = first + (last - first) / 2;
+        std::nth_element(_indices.begin() + first, _indices.begin() + mid,
+                         _indices.begin() + last, CenterLess(_boxes, axis));
+
+        unsigned long left = Build(first, mid);
+        unsigned long right = Build(mid, last);
+        _nodes[index].first = first;
+        _nodes[index].count = 0;
+        _nodes[index].left = left;
+        _nodes[index].right = right;
+        return index;
     }
 
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
+private:
+    const std::vector<Base::BoundBox3f>& _boxes;
+    std::vector<unsigned long> _indices;
+    std::vector<Node> _nodes;
+};
 
-        seq.next();
-        if (aulGridElements.size()==0)
-            continue;
+/**
+ * Performs the narrow phase for a unit of work. All methods are const and only
+ * read the mesh so that several units can be processed at the same time.
+ */
+class FacetPairTest
+{
+public:
+    FacetPairTest(const MeshKernel& kernel, const std::vector<Base::BoundBox3f>& boxes,
+                  const FacetBoxTree* tree, bool firstOnly)
+      : _kernel(kernel), _facets(kernel.GetFacets()), _boxes(boxes), _tree(tree), _firstOnly(firstOnly)
+    {
+    }
+
+    bool Intersect(const MeshGeomFacet& facet1, unsigned long index1, unsigned long index2) const
+    {
+        // If the facets share a common vertex we do not check for self-intersections because they
+        // could but usually do not intersect each other and the algorithm below would detect false-positives,
+        // otherwise
+        const MeshFacet& rface1 = _facets[index1];
+        const MeshFacet& rface2 = _facets[index2];
+        for (int i = 0; i < 3; i++) {
+            if (rface1._aulPoints[i] == rface2._aulPoints[0] ||
+                rface1._aulPoints[i] == rface2._aulPoints[1] ||
+                rface1._aulPoints[i] == rface2._aulPoints[2])
+                return false; // ignore facets sharing a common vertex
+        }
+
+        if (!(_boxes[index1] && _boxes[index2]))
+            return false;
 
-        MeshGeomFacet facet1, facet2;
         Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
+        MeshGeomFacet facet2 = _kernel.GetFacet(index2);
+        return facet1.IntersectWithFacet(facet2, pt1, pt2) == 2;
+    }
+
+    /// Tests all facet pairs of one grid cell
+    FacetPairs TestCell(const std::vector<unsigned long>& elements) const
+    {
+        FacetPairs result;
+        for (std::vector<unsigned long>::const_iterator it = elements.begin(); it != elements.end(); ++it) {
+            MeshGeomFacet facet1 = _kernel.GetFacet(*it);
+            for (std::vector<unsigned long>::const_iterator jt = it + 1; jt != elements.end(); ++jt) {
+                if (Intersect(facet1, *it, *jt)) {
+                    result.push_back(std::make_pair(*it, *jt));
+                    if (_firstOnly)
+                        return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    /// Tests the facets of the given range against all facets with a higher index
+    FacetPairs TestRange(const FacetRange& range) const
+    {
+        FacetPairs result;
+        std::vector<unsigned long> candidates;
+        for (unsigned long index = range.first; index < range.second; index++) {
+            candidates.clear();
+            _tree->Overlaps(_boxes[index], candidates);
+            std::sort(candidates.begin(), candidates.end());
+
+            MeshGeomFacet facet1 = _kernel.GetFacet(index);
+            for (std::vector<unsigned long>::iterator jt = candidates.begin(); jt != candidates.end(); ++jt) {
+                if (*jt <= index)
                     continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        // abort after the first detected self-intersection
-                        return false;
-                    }
+                if (Intersect(facet1, index, *jt)) {
+                    result.push_back(std::make_pair(index, *jt));
+                    if (_firstOnly)
+                        return result;
                 }
             }
         }
+        return result;
     }
 
-    return true;
+private:
+    const MeshKernel& _kernel;
+    const MeshFacetArray& _facets;
+    const std::vector<Base::BoundBox3f>& _boxes;
+    const FacetBoxTree* _tree;
+    bool _firstOnly;
+};
+
+/**
+ * Processes the units of work in batches. In parallel mode a batch is mapped onto the
+ * global thread pool and the results are appended in the order of the units afterwards,
+ * so that the output is identical to the one of the sequential mode.
+ */
+template <class Unit, class Functor>
+void Process(const std::vector<Unit>& units, Functor func, bool parallel,
+             bool firstOnly, bool canAbort, FacetPairs& intersection)
+{
+    std::size_t batch = 1;
+    if (parallel)
+        batch = 16 * static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+
+    Base::SequencerLauncher seq("Checking for self-intersections...", units.size());
+    for (std::size_t pos = 0; pos < units.size(); pos += batch) {
+        typename std::vector<Unit>::const_iterator begin = units.begin() + pos;
+        typename std::vector<Unit>::const_iterator end = units.begin() + std::min(pos + batch, units.size());
+
+        std::vector<FacetPairs> results;
+        if (parallel) {
+            QFuture<FacetPairs> future = QtConcurrent::mapped(begin, end, func);
+            future.waitForFinished();
+            QList<FacetPairs> list = future.results();
+            results.assign(list.begin(), list.end());
+        }
+        else {
+            for (typename std::vector<Unit>::const_iterator it = begin; it != end; ++it)
+                results.push_back(func(*it));
+        }
+
+        for (std::vector<FacetPairs>::iterator it = results.begin(); it != results.end(); ++it) {
+            seq.next(canAbort);
+            intersection.insert(intersection.end(), it->begin(), it->end());
+            if (firstOnly && !intersection.empty())
+                return;
+        }
+    }
+}
+
+} // namespace SelfIntersection
+} // namespace MeshCore
+
+void MeshEvalSelfIntersection::FindIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection,
+                                                 bool firstOnly, bool canAbort) const
+{
+    using namespace SelfIntersection;
+
+    // Contains bounding boxes for every facet
+    std::vector<Base::BoundBox3f> boxes;
+    boxes.reserve(_rclMesh.CountFacets());
+    MeshFacetIterator cMFI(_rclMesh);
+    for (cMFI.Begin(); cMFI.More(); cMFI.Next()) {
+        boxes.push_back((*cMFI).GetBoundBox());
+    }
+
+    if (_broadPhase == BoundingVolumes) {
+        FacetBoxTree tree(boxes);
+        FacetPairTest test(_rclMesh, boxes, &tree, firstOnly);
+
+        // Splits the facets into ranges of equal size
+        const unsigned long rangeSize = 1024;
+        std::vector<FacetRange> ranges;
+        for (unsigned long index = 0; index < boxes.size(); index += rangeSize) {
+            ranges.push_back(std::make_pair(index, std::min<unsigned long>(index + rangeSize, boxes.size())));
+        }
+
+        Process(ranges, boost::bind(&FacetPairTest::TestRange, &test, _1),
+                _parallel, firstOnly, canAbort, intersection);
+    }
+    else {
+        FacetPairTest test(_rclMesh, boxes, 0, firstOnly);
+
+        // Splits the mesh using grid for speeding up the calculation
+        MeshFacetGrid cMeshFacetGrid(_rclMesh);
+        MeshGridIterator clGridIter(cMeshFacetGrid);
+        std::vector<std::vector<unsigned long> > cells;
+        for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
+            //Get the facet indices, belonging to the current grid unit
+            std::vector<unsigned long> aulGridElements;
+            clGridIter.GetElements(aulGridElements);
+            if (aulGridElements.size() > 1)
+                cells.push_back(aulGridElements);
+        }
+
+        Process(cells, boost::bind(&FacetPairTest::TestCell, &test, _1),
+                _parallel, firstOnly, canAbort, intersection);
+    }
+}
+
+bool MeshEvalSelfIntersection::Evaluate ()
+{
+    // abort after the first detected self-intersection
+    std::vector<std::pair<unsigned long, unsigned long> > intersection;
+    FindIntersections(intersection, true, false);
+    return intersection.empty();
 }
 
 void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsigned long, unsigned long> >& indices,
@@ -689,72 +914,7 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
 
 void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
-    // Contains bounding boxes for every facet 
-    std::vector<Base::BoundBox3f> boxes;
-    //intersection.clear();
-
-    // Splits the mesh using grid for speeding up the calculation
-    MeshFacetGrid cMeshFacetGrid(_rclMesh);
-    const MeshFacetArray& rFaces = _rclMesh.GetFacets();
-    MeshGridIterator clGridIter(cMeshFacetGrid);
-    unsigned long ulGridX, ulGridY, ulGridZ;
-    cMeshFacetGrid.GetCtGrids(ulGridX, ulGridY, ulGridZ);
-
-    MeshFacetIterator cMFI(_rclMesh);
-    for(cMFI.Begin(); cMFI.More(); cMFI.Next()) {
-        boxes.push_back((*cMFI).GetBoundBox());
-    }
-
-    // Calculates the intersections
-    Base::SequencerLauncher seq("Checking for self-intersections...", ulGridX*ulGridY*ulGridZ);
-    for (clGridIter.Init(); clGridIter.More(); clGridIter.Next()) {
-        //Get the facet indices, belonging to the current grid unit
-        std::vector<unsigned long> aulGridElements;
-        clGridIter.GetElements(aulGridElements);
-
-        seq.next(true);
-        if (aulGridElements.size()==0)
-            continue;
-
-        MeshGeomFacet facet1, facet2;
-        Base::Vector3f pt1, pt2;
-        for (std::vector<unsigned long>::iterator it = aulGridElements.begin(); it != aulGridElements.end(); ++it) {
-            const Base::BoundBox3f& box1 = boxes[*it];
-            cMFI.Set(*it);
-            facet1 = *cMFI;
-            const MeshFacet& rface1 = rFaces[*it];
-            for (std::vector<unsigned long>::iterator jt = it; jt != aulGridElements.end(); ++jt) {
-                if (jt == it) // the identical facet
-                    continue;
-                // If the facets share a common vertex we do not check for self-intersections because they 
-                // could but usually do not intersect each other and the algorithm below would detect false-positives,
-                // otherwise
-                const MeshFacet& rface2 = rFaces[*jt];
-                if (rface1._aulPoints[0] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[0] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[0] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[1] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[1] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[1] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-                if (rface1._aulPoints[2] == rface2._aulPoints[0] || 
-                    rface1._aulPoints[2] == rface2._aulPoints[1] ||
-                    rface1._aulPoints[2] == rface2._aulPoints[2])
-                    continue; // ignore facets sharing a common vertex
-
-                const Base::BoundBox3f& box2 = boxes[*jt];
-                if (box1 && box2) {
-                    cMFI.Set(*jt);
-                    facet2 = *cMFI;
-                    int ret = facet1.IntersectWithFacet(facet2, pt1, pt2);
-                    if (ret == 2) {
-                        intersection.push_back(std::make_pair (*it,*jt));
-                    }
-                }
-            }
-        }
-    }
+    FindIntersections(intersection, false, true);
 }
 
 std::vector<unsigned long> MeshFixSelfIntersection::GetFacets() const
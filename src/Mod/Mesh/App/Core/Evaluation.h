@@ -288,7 +288,14 @@ protected:
 class MeshExport MeshEvalSelfIntersection : public MeshEvaluation
 {
 public:
-    MeshEvalSelfIntersection (const MeshKernel &rclB) : MeshEvaluation(rclB) {}
+    /// Method to find the facet pairs to be tested for intersection
+    enum BroadPhase {
+        UniformGrid,    /**< Facets sorted into a uniform grid, pairs are tested per grid cell */
+        BoundingVolumes /**< Bounding volume hierarchy, better suited for strongly varying facet sizes */
+    };
+
+    MeshEvalSelfIntersection (const MeshKernel &rclB)
+      : MeshEvaluation(rclB), _broadPhase(UniformGrid), _parallel(true) {}
     virtual ~MeshEvalSelfIntersection () {}
     /// Evaluate the mesh and return if true if there are self intersections
     bool Evaluate ();
@@ -297,6 +304,21 @@ public:
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+    /// Distribute the intersection tests over several threads (default: on).
+    /// The result is identical to the one of the sequential run.
+    void SetParallel(bool on) { _parallel = on; }
+    bool IsParallel() const { return _parallel; }
+    /// Set the method to find the candidate pairs (default: UniformGrid)
+    void SetBroadPhase(BroadPhase bp) { _broadPhase = bp; }
+    BroadPhase GetBroadPhase() const { return _broadPhase; }
+
+private:
+    void FindIntersections(std::vector<std::pair<unsigned long, unsigned long> >&,
+                           bool firstOnly, bool canAbort) const;
+
+private:
+    BroadPhase _broadPhase;
+    bool _parallel;
 };
 
 /**
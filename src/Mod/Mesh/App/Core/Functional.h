@@ -25,6 +25,7 @@
 #define MESH_FUNCTIONAL_H
 
 #include <algorithm>
+#include <vector>
 #include <QtConcurrentRun>
 #include <QFuture>
 #include <QThread>
@@ -58,6 +59,40 @@ namespace MeshCore
         }
     }
 
+    template <class Func>
+    struct parallel_range_task
+    {
+        typedef void result_type;
+        parallel_range_task(const Func& f) : func(f) {}
+        void operator()(unsigned long begin, unsigned long end) const
+        {
+            func(begin, end);
+        }
+        const Func& func;
+    };
+
+    /// Calls \a func(begin, end) for consecutive ranges of [0, count) in parallel
+    template <class Func>
+    static void parallel_for(unsigned long count, const Func& func, int threads)
+    {
+        unsigned long chunks = std::min<unsigned long>(static_cast<unsigned long>(std::max(threads, 1)), count);
+        if (chunks < 2)
+        {
+            func(0, count);
+        }
+        else
+        {
+            std::vector<QFuture<void> > futures;
+            unsigned long step = count / chunks;
+            unsigned long begin = 0;
+            for (unsigned long i = 1; i < chunks; i++, begin += step)
+                futures.push_back(QtConcurrent::run(parallel_range_task<Func>(func), begin, begin + step));
+            func(begin, count);
+            for (std::vector<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+                it->waitForFinished();
+        }
+    }
+
 } // namespace MeshCore
 
 
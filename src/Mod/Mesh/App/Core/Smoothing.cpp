@@ -23,12 +23,14 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 #endif
 
 #include "Smoothing.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "Approximation.h"
 
@@ -69,7 +71,7 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
     MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
     MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
 
     for (unsigned int i=0; i<iterations; i++) {
@@ -78,11 +80,11 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
             MeshCore::PlaneFit pf;
             pf.AddPoint(*v_it);
             center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
+            MeshCore::MeshIndexRange cv = vv_it[v_it.Position()];
             if (cv.size() < 3)
                 continue;
 
-            std::set<unsigned long>::const_iterator cv_it;
+            MeshCore::MeshIndexRange::const_iterator cv_it;
             for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
                 pf.AddPoint(v_beg[*cv_it]);
                 center += v_beg[*cv_it];
@@ -122,7 +124,7 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
     MeshCore::MeshPointArray PointArray = kernel.GetPoints();
 
     MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
     MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
 
     for (unsigned int i=0; i<iterations; i++) {
@@ -132,11 +134,11 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
             MeshCore::PlaneFit pf;
             pf.AddPoint(*v_it);
             center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
+            MeshCore::MeshIndexRange cv = vv_it[v_it.Position()];
             if (cv.size() < 3)
                 continue;
 
-            std::set<unsigned long>::const_iterator cv_it;
+            MeshCore::MeshIndexRange::const_iterator cv_it;
             for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
                 pf.AddPoint(v_beg[*cv_it]);
                 center += v_beg[*cv_it];
@@ -170,30 +172,38 @@ void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<
     }
 }
 
-LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
-  : AbstractSmoothing(m), lambda(0.6307)
-{
-}
-
-LaplaceSmoothing::~LaplaceSmoothing()
-{
-}
+namespace {
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+// Computes the umbrella operator into a separate buffer, so that all points of an
+// iteration are moved with the positions of the previous iteration and the result
+// doesn't depend on the order in which the points are handled
+class UmbrellaOperator
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
+public:
+    UmbrellaOperator(const MeshPointArray& p, const MeshCompactPointToPoints& vv,
+                     const MeshCompactPointToFacets& vf, double s,
+                     const std::vector<unsigned long>* ind, std::vector<Base::Vector3f>& res)
+      : points(p), vv_it(vv), vf_it(vf), stepsize(s), indices(ind), result(res)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long i = begin; i < end; i++) {
+            unsigned long pos = indices ? (*indices)[i] : i;
+            result[i] = Move(pos);
+        }
+    }
 
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
+private:
+    Base::Vector3f Move(unsigned long pos) const
+    {
+        const MeshPoint& pnt = points[pos];
+        MeshIndexRange cv = vv_it[pos];
         if (cv.size() < 3)
-            continue;
+            return pnt;
         if (cv.size() != vf_it[pos].size()) {
             // do nothing for border points
-            continue;
+            return pnt;
         }
 
         size_t n_count = cv.size();
@@ -201,59 +211,69 @@ void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
         w=1.0/double(n_count);
 
         double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
+        MeshIndexRange::const_iterator cv_it;
         for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*static_cast<double>((v_beg[*cv_it]).x-v_it->x);
-            dely += w*static_cast<double>((v_beg[*cv_it]).y-v_it->y);
-            delz += w*static_cast<double>((v_beg[*cv_it]).z-v_it->z);
+            delx += w*static_cast<double>(points[*cv_it].x-pnt.x);
+            dely += w*static_cast<double>(points[*cv_it].y-pnt.y);
+            delz += w*static_cast<double>(points[*cv_it].z-pnt.z);
         }
 
-        float x = static_cast<float>(static_cast<double>(v_it->x)+stepsize*delx);
-        float y = static_cast<float>(static_cast<double>(v_it->y)+stepsize*dely);
-        float z = static_cast<float>(static_cast<double>(v_it->z)+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
+        float x = static_cast<float>(static_cast<double>(pnt.x)+stepsize*delx);
+        float y = static_cast<float>(static_cast<double>(pnt.y)+stepsize*dely);
+        float z = static_cast<float>(static_cast<double>(pnt.z)+stepsize*delz);
+        return Base::Vector3f(x,y,z);
     }
+
+private:
+    const MeshPointArray& points;
+    const MeshCompactPointToPoints& vv_it;
+    const MeshCompactPointToFacets& vf_it;
+    double stepsize;
+    const std::vector<unsigned long>* indices;
+    std::vector<Base::Vector3f>& result;
+};
+
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
+LaplaceSmoothing::LaplaceSmoothing(MeshKernel& m)
+  : AbstractSmoothing(m), lambda(0.6307)
+  , threads(std::max(1, QThread::idealThreadCount()))
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
+}
 
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
-        }
+LaplaceSmoothing::~LaplaceSmoothing()
+{
+}
 
-        size_t n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+void LaplaceSmoothing::Umbrella(const MeshCompactPointToPoints& vv_it,
+                                const MeshCompactPointToFacets& vf_it, double stepsize)
+{
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    unsigned long countPoints = points.size();
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*static_cast<double>((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*static_cast<double>((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*static_cast<double>((v_beg[*cv_it]).z-(v_beg[*pos]).z);
-        }
+    std::vector<Base::Vector3f> moved(countPoints);
+    parallel_for(countPoints, UmbrellaOperator(points, vv_it, vf_it, stepsize, 0, moved), threads);
+    for (unsigned long pos = 0; pos < countPoints; pos++)
+        kernel.SetPoint(pos, moved[pos]);
+}
 
-        float x = static_cast<float>(static_cast<double>((v_beg[*pos]).x)+stepsize*delx);
-        float y = static_cast<float>(static_cast<double>((v_beg[*pos]).y)+stepsize*dely);
-        float z = static_cast<float>(static_cast<double>((v_beg[*pos]).z)+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
-    }
+void LaplaceSmoothing::Umbrella(const MeshCompactPointToPoints& vv_it,
+                                const MeshCompactPointToFacets& vf_it, double stepsize,
+                                const std::vector<unsigned long>& point_indices)
+{
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    unsigned long countPoints = point_indices.size();
+
+    std::vector<Base::Vector3f> moved(countPoints);
+    parallel_for(countPoints, UmbrellaOperator(points, vv_it, vf_it, stepsize, &point_indices, moved), threads);
+    for (unsigned long i = 0; i < countPoints; i++)
+        kernel.SetPoint(point_indices[i], moved[i]);
 }
 
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
 
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda);
@@ -262,8 +282,8 @@ void LaplaceSmoothing::Smooth(unsigned int iterations)
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
 
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda, point_indices);
@@ -281,8 +301,8 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
@@ -294,8 +314,8 @@ void TaubinSmoothing::Smooth(unsigned int iterations)
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
@@ -24,13 +24,14 @@
 #ifndef MESH_SMOOTHING_H
 #define MESH_SMOOTHING_H
 
+#include <algorithm>
 #include <vector>
 
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
+class MeshCompactPointToPoints;
+class MeshCompactPointToFacets;
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -81,16 +82,21 @@ public:
     void Smooth(unsigned int);
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
     void SetLambda(double l) { lambda = l;}
+    /** Sets the number of threads. The result is the same for any number of threads.
+     * The default is the number of processor cores.
+     */
+    void SetThreads(int t) { threads = std::max(1, t);}
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
+    void Umbrella(const MeshCompactPointToPoints&,
+                  const MeshCompactPointToFacets&, double);
+    void Umbrella(const MeshCompactPointToPoints&,
+                  const MeshCompactPointToFacets&, double,
                   const std::vector<unsigned long>&);
 
 protected:
     double lambda;
+    int threads;
 };
 
 class MeshExport TaubinSmoothing : public LaplaceSmoothing
@@ -427,7 +427,7 @@ void PropertyCurvatureList::Paste(const App::Property &from)
 // ----------------------------------------------------------------------------
 
 PropertyMeshKernel::PropertyMeshKernel()
-  : _meshObject(new MeshObject()), meshPyObject(0)
+  : _meshObject(new MeshObject()), _pendingLoad(false), meshPyObject(0)
 {
     // Note: Normally this property is a member of a document object, i.e. the setValue()
     // method gets called in the constructor of a sublcass of DocumentObject, e.g. Mesh::Feature.
@@ -443,6 +443,7 @@ PropertyMeshKernel::~PropertyMeshKernel()
         meshPyObject->parentProperty = 0;
         Py_DECREF(meshPyObject);
     }
+    releaseCopies();
 }
 
 void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
@@ -451,6 +452,9 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     // before calling hasSetValue()
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
+    // the old mesh isn't modified any more, so the copies can keep it
+    releaseCopies();
+    _lazyFile.reset();
     _meshObject = mesh;
     hasSetValue();
 }
@@ -458,6 +462,8 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    detachCopies(false);
+    _lazyFile.reset();
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -465,41 +471,51 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    detachCopies(false);
+    _lazyFile.reset();
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
+    loadMesh();
     aboutToSetValue();
+    detachCopies();
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
+    loadMesh();
     aboutToSetValue();
+    detachCopies();
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
 const MeshObject& PropertyMeshKernel::getValue(void)const 
 {
+    loadMesh();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr(void)const 
 {
+    loadMesh();
     return (MeshObject*)_meshObject;
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
+    loadMesh();
     return (MeshObject*)_meshObject;
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    loadMesh();
     return _meshObject->getBoundBox();
 }
 
@@ -507,13 +523,19 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
 {
     unsigned int size = 0;
     size += _meshObject->getMemSize();
+    if (_sharedMesh && !_sharedMesh->owner) {
+        // a copy only needs memory of its own once the original has been modified
+        size += _sharedMesh->mesh->getMemSize();
+    }
     
     return size;
 }
 
 MeshObject* PropertyMeshKernel::startEditing()
 {
+    loadMesh();
     aboutToSetValue();
+    detachCopies();
     return (MeshObject*)_meshObject;
 }
 
@@ -524,14 +546,27 @@ void PropertyMeshKernel::finishEditing()
 
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
+    loadMesh();
     aboutToSetValue();
+    detachCopies();
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
 
+void PropertyMeshKernel::setTransform(const Base::Matrix4D &rclTrf)
+{
+    loadMesh();
+    if (_meshObject->getTransform() == rclTrf)
+        return;
+    detachCopies();
+    _meshObject->setTransform(rclTrf);
+}
+
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
+    loadMesh();
     aboutToSetValue();
+    detachCopies();
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -540,6 +575,7 @@ void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned lo
 
 PyObject *PropertyMeshKernel::getPyObject(void)
 {
+    loadMesh();
     if (!meshPyObject) {
         meshPyObject = new MeshPy(&*_meshObject);
         meshPyObject->setConst(); // set immutable
@@ -576,6 +612,7 @@ void PropertyMeshKernel::setPyObject(PyObject *value)
 void PropertyMeshKernel::Save (Base::Writer &writer) const
 {
     if (writer.isForceXML()) {
+        loadMesh();
         writer.Stream() << writer.ind() << "<Mesh>" << std::endl;
         MeshCore::MeshOutput saver(_meshObject->getKernel());
         saver.SaveXML(writer);
@@ -603,6 +640,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detachCopies(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -614,21 +652,171 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
 
 void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 {
+    loadMesh();
     _meshObject->save(writer.Stream());
 }
 
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachCopies(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::hasConcurrentDocFile() const
+{
+    return true;
+}
+
+void PropertyMeshKernel::decodeDocFile(Base::Reader &reader)
+{
+    // read into a separate mesh to not touch the one referenced by the document
+    Base::Reference<MeshObject> mesh(new MeshObject());
+    mesh->load(reader);
+    _decodedMesh = mesh;
+}
+
+bool PropertyMeshKernel::hasLazyDocFile() const
+{
+    return true;
+}
+
+void PropertyMeshKernel::setLazyDocFile(const std::shared_ptr<Base::LazyDocFile>& file)
+{
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    _lazyFile = file;
+    if (file)
+        _pendingLoad.store(true, std::memory_order_release);
+}
+
+void PropertyMeshKernel::loadLazyDocFile()
+{
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    loadLazyFile();
+}
+
+void PropertyMeshKernel::loadLazyFile()
+{
+    if (!_lazyFile)
+        return;
+
+    // Reading deferred data is no modification, so no notification is sent.
+    // The data is swapped to keep the mesh object of a Python wrapper valid.
+    std::shared_ptr<Base::LazyDocFile> file;
+    file.swap(_lazyFile);
+    file->decode(*this);
+    if (_decodedMesh.isValid()) {
+        _meshObject->swap(*_decodedMesh);
+        _decodedMesh = Base::Reference<MeshObject>();
+    }
+}
+
+void PropertyMeshKernel::loadMesh() const
+{
+    // The getters may be called by worker threads of a parallel recompute or
+    // save at the same time, so the deferred data is loaded under a lock
+    if (!_pendingLoad.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock(_loadMutex);
+    if (!_pendingLoad.load(std::memory_order_relaxed))
+        return;
+
+    if (_sharedMesh && _sharedMesh->owner != this) {
+        // this is a copy, so take over the data shared with the original
+        PropertyMeshKernel* self = const_cast<PropertyMeshKernel*>(this);
+        std::shared_ptr<SharedMesh> shared;
+        shared.swap(self->_sharedMesh);
+        if (shared->owner) {
+            *_meshObject = *shared->mesh;
+        }
+        else if (shared.use_count() == 1) {
+            self->_meshObject = shared->mesh;
+        }
+        else {
+            *_meshObject = *shared->mesh;
+        }
+    }
+
+    if (_lazyFile) {
+        std::string name = _lazyFile->getFileName();
+        try {
+            const_cast<PropertyMeshKernel*>(this)->loadLazyFile();
+        }
+        catch (const Base::Exception& e) {
+            Base::Console().Error("Reading failed from embedded file: %s (%s)\n", name.c_str(), e.what());
+        }
+        catch (const std::exception& e) {
+            Base::Console().Error("Reading failed from embedded file: %s (%s)\n", name.c_str(), e.what());
+        }
+    }
+
+    _pendingLoad.store(false, std::memory_order_release);
+}
+
+void PropertyMeshKernel::applyDocFile()
+{
+    if (_decodedMesh.isValid()) {
+        aboutToSetValue();
+        detachCopies(false);
+        _meshObject->swap(*_decodedMesh);
+        hasSetValue();
+        _decodedMesh = Base::Reference<MeshObject>();
+    }
+}
+
+void PropertyMeshKernel::detachCopies(bool keepData)
+{
+    if (!_sharedMesh)
+        return;
+
+    if (_sharedMesh->owner != this) {
+        loadMesh();
+        return;
+    }
+
+    if (_sharedMesh.use_count() > 1) {
+        if (!keepData && _meshObject->countSegments() == 0) {
+            // the mesh is replaced, so there is no need to copy it
+            Base::Reference<MeshObject> mesh(new MeshObject());
+            mesh->swap(*_meshObject);
+            _meshObject->setTransform(mesh->getTransform());
+            _sharedMesh->mesh = mesh;
+        }
+        else {
+            _sharedMesh->mesh = new MeshObject(*_meshObject);
+        }
+    }
+
+    _sharedMesh->owner = nullptr;
+    _sharedMesh.reset();
+}
+
+void PropertyMeshKernel::releaseCopies()
+{
+    if (!_sharedMesh)
+        return;
+
+    if (_sharedMesh->owner == this)
+        _sharedMesh->owner = nullptr;
+    _sharedMesh.reset();
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    // Note: The copy references the same mesh object until this property gets
+    // modified. Then detachCopies() gives the copy its own data.
+    loadMesh();
     PropertyMeshKernel *prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    if (!_sharedMesh) {
+        PropertyMeshKernel* self = const_cast<PropertyMeshKernel*>(this);
+        self->_sharedMesh = std::make_shared<SharedMesh>();
+        self->_sharedMesh->owner = this;
+        self->_sharedMesh->mesh = _meshObject;
+    }
+    prop->_sharedMesh = _sharedMesh;
+    prop->_pendingLoad.store(true, std::memory_order_release);
     return prop;
 }
 
@@ -637,6 +825,19 @@ void PropertyMeshKernel::Paste(const App::Property &from)
     // Note: Copy the content, do NOT reference the same mesh object
     aboutToSetValue();
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    if (prop._sharedMesh && prop._sharedMesh->owner == this) {
+        // the copy still references the unmodified mesh of this property
+        hasSetValue();
+        return;
+    }
+
+    detachCopies(false);
+    _lazyFile.reset();
+
+    // read the data of the source without taking over shared data
+    if (prop._sharedMesh)
+        *(this->_meshObject) = *prop._sharedMesh->mesh;
+    else
+        *(this->_meshObject) = prop.getValue();
     hasSetValue();
 }
@@ -24,8 +24,10 @@
 #ifndef MESH_MESHPROPERTIES_H
 #define MESH_MESHPROPERTIES_H
 
+#include <atomic>
 #include <vector>
 #include <list>
+#include <mutex>
 #include <set>
 #include <string>
 #include <map>
@@ -215,6 +217,8 @@ public:
     void finishEditing();
     /// Transform the real mesh data
     void transformGeometry(const Base::Matrix4D &rclMat);
+    /// Set the placement of the mesh without notification, the copies keep theirs
+    void setTransform(const Base::Matrix4D &rclTrf);
     void setPointIndices( const std::vector<std::pair<unsigned long, Base::Vector3f> >& );
     //@}
 
@@ -244,13 +248,51 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool hasConcurrentDocFile() const;
+    void decodeDocFile(Base::Reader &reader);
+    void applyDocFile();
+    bool hasLazyDocFile() const;
+    void setLazyDocFile(const std::shared_ptr<Base::LazyDocFile>& file);
+    void loadLazyDocFile();
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+private:
+    /// read the mesh if it has been deferred
+    void loadMesh() const;
+    /// read the deferred file, the caller must hold _loadMutex
+    void loadLazyFile();
+    /** Give the copies that still share the mesh their own data before it gets modified.
+     * If \a keepData is false the mesh is replaced anyway, so its data is moved to the copies.
+     */
+    void detachCopies(bool keepData = true);
+    /// stop sharing the mesh with the copies without modifying it
+    void releaseCopies();
+
+    /** Mesh shared between a property and its copies made by Copy().
+     * A copy is mostly kept for undo and never changed, so it only references
+     * the mesh of the original property (the owner). If the owner is about to
+     * modify its mesh, the copies get their own data.
+     */
+    struct SharedMesh {
+        const PropertyMeshKernel* owner = nullptr;
+        Base::Reference<MeshObject> mesh;
+    };
+
 private:
     Base::Reference<MeshObject> _meshObject;
+    /// mesh read by decodeDocFile() until it is applied
+    Base::Reference<MeshObject> _decodedMesh;
+    /// file of the mesh which is read on first access
+    std::shared_ptr<Base::LazyDocFile> _lazyFile;
+    /// mesh shared with the original property or the copies of this property
+    std::shared_ptr<SharedMesh> _sharedMesh;
+    /// set while loadMesh() may have to do something, checked without locking
+    mutable std::atomic<bool> _pendingLoad;
+    /// the mesh may be loaded by several worker threads at the same time
+    mutable std::mutex _loadMutex;
     MeshPy* meshPyObject;
 };
 
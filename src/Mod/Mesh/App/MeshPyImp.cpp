@@ -994,12 +994,20 @@ PyObject*  MeshPy::hasSelfIntersections(PyObject *args)
 
 PyObject*  MeshPy::getSelfIntersections(PyObject *args)
 {
-    if (!PyArg_ParseTuple(args, ""))
+    const char* method = "Grid";
+    if (!PyArg_ParseTuple(args, "|s", &method))
         return NULL;
 
     std::vector<std::pair<unsigned long, unsigned long> > selfIndices;
     std::vector<std::pair<Base::Vector3f, Base::Vector3f> > selfPoints;
     MeshCore::MeshEvalSelfIntersection eval(getMeshObjectPtr()->getKernel());
+    if (strcmp(method, "BVH") == 0) {
+        eval.SetBroadPhase(MeshCore::MeshEvalSelfIntersection::BoundingVolumes);
+    }
+    else if (strcmp(method, "Grid") != 0) {
+        PyErr_SetString(PyExc_ValueError, "Method must be 'Grid' or 'BVH'");
+        return NULL;
+    }
     eval.GetIntersections(selfIndices);
     eval.GetIntersections(selfIndices, selfPoints);
 
@@ -1689,9 +1697,10 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
     int iter=1;
     double lambda = 0;
     double micro = 0;
-    static char* keywords_smooth[] = {"Method","Iteration","Lambda","Micro",NULL};
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|sidd",keywords_smooth,
-                                     &method, &iter, &lambda, &micro))
+    int threads = 0;
+    static char* keywords_smooth[] = {"Method","Iteration","Lambda","Micro","Threads",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|siddi",keywords_smooth,
+                                     &method, &iter, &lambda, &micro, &threads))
         return 0;
 
     PY_TRY {
@@ -1701,6 +1710,8 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
             MeshCore::LaplaceSmoothing smooth(kernel);
             if (lambda > 0)
                 smooth.SetLambda(lambda);
+            if (threads > 0)
+                smooth.SetThreads(threads);
             smooth.Smooth(iter);
         }
         else if (strcmp(method, "Taubin") == 0) {
@@ -1709,6 +1720,8 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
                 smooth.SetLambda(lambda);
             if (micro > 0)
                 smooth.SetMicro(micro);
+            if (threads > 0)
+                smooth.SetThreads(threads);
             smooth.Smooth(iter);
         }
         else if (strcmp(method, "PlaneFit") == 0) {
@@ -1875,6 +1888,32 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
     return Py::new_reference_to(s);
 }
 
+PyObject*  MeshPy::getCurvaturePerVertex(PyObject *args)
+{
+    int threads = 0;
+    if (!PyArg_ParseTuple(args, "|i", &threads))
+        return NULL;
+
+    PY_TRY {
+        MeshCore::MeshCurvature meshCurv(getMeshObjectPtr()->getKernel());
+        if (threads > 0)
+            meshCurv.SetThreads(threads);
+        meshCurv.ComputePerVertex();
+
+        const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
+        Py::List list;
+        for (std::vector<MeshCore::CurvatureInfo>::const_iterator it = curv.begin(); it != curv.end(); ++it) {
+            Py::Tuple tuple(4);
+            tuple.setItem(0, Py::Float(it->fMaxCurvature));
+            tuple.setItem(1, Py::Float(it->fMinCurvature));
+            tuple.setItem(2, Py::Vector(it->cMaxCurvDir));
+            tuple.setItem(3, Py::Vector(it->cMinCurvDir));
+            list.append(tuple);
+        }
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
 PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
 {
     PyObject* l;
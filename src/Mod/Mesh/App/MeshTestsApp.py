@@ -225,3 +225,182 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+class ParallelFileIOCases(unittest.TestCase):
+    def setUp(self):
+        self.grp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+        self.parallel = self.grp.GetBool("ParallelFileIO", False)
+        self.grp.SetBool("ParallelFileIO", True)
+        self.doc = FreeCAD.newDocument("ParallelFileIO")
+
+    def testSaveAndRestore(self):
+        counts = []
+        for i in range(4):
+            feature = self.doc.addObject("Mesh::Feature", "Mesh")
+            feature.Mesh = Mesh.createSphere(10.0, 20 * (i + 1))
+            counts.append(feature.Mesh.CountFacets)
+        name = tempfile.gettempdir() + os.sep + "ParallelFileIO.FCStd"
+        self.doc.saveAs(name)
+        FreeCAD.closeDocument(self.doc.Name)
+
+        self.doc = FreeCAD.openDocument(name)
+        meshes = [obj.Mesh.CountFacets for obj in self.doc.Objects]
+        self.assertEqual(meshes, counts)
+        os.remove(name)
+
+    def tearDown(self):
+        self.grp.SetBool("ParallelFileIO", self.parallel)
+        FreeCAD.closeDocument(self.doc.Name)
+
+
+class UndoMeshCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("UndoMesh")
+        self.doc.UndoMode = 1
+
+    def testSharedUndoData(self):
+        feature = self.doc.addObject("Mesh::Feature", "Mesh")
+        sphere = Mesh.createSphere(10.0, 50)
+        self.doc.openTransaction("Sphere")
+        feature.Mesh = sphere
+        self.doc.commitTransaction()
+        self.doc.openTransaction("Box")
+        feature.Mesh = Mesh.createBox(1.0, 1.0, 1.0)
+        self.doc.commitTransaction()
+        # the replaced sphere is kept for undo
+        self.assertGreater(self.doc.UndoRedoMemSize, 0)
+
+        self.doc.undo()
+        self.doc.redo()
+        self.doc.undo()
+        self.assertEqual(feature.Mesh.CountFacets, sphere.CountFacets)
+        self.doc.redo()
+        self.assertEqual(feature.Mesh.CountFacets, 12)
+
+    def testPlacementUndo(self):
+        feature = self.doc.addObject("Mesh::Feature", "Mesh")
+        self.doc.openTransaction("Sphere")
+        feature.Mesh = Mesh.createSphere(10.0, 50)
+        self.doc.commitTransaction()
+        self.doc.openTransaction("Move")
+        feature.Placement.Base = FreeCAD.Vector(5, 0, 0)
+        feature.Placement = feature.Placement
+        self.doc.commitTransaction()
+        self.assertEqual(feature.Mesh.Placement.Base, FreeCAD.Vector(5, 0, 0))
+
+        # moving the feature must not change the mesh kept for undo
+        self.doc.undo()
+        self.assertEqual(feature.Mesh.Placement.Base, FreeCAD.Vector(0, 0, 0))
+        self.doc.undo()
+        self.doc.redo()
+        self.assertEqual(feature.Mesh.Placement.Base, FreeCAD.Vector(0, 0, 0))
+        self.doc.redo()
+        self.assertEqual(feature.Mesh.Placement.Base, FreeCAD.Vector(5, 0, 0))
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.doc.Name)
+
+
+class ParallelSmoothingCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createTorus(8.0, 2.0, 40)
+        # make the mesh irregular so that smoothing moves every point
+        points = self.mesh.Points
+        for i in range(0, self.mesh.CountPoints, 3):
+            self.mesh.setPoint(i, points[i].Vector + FreeCAD.Vector(0.1, -0.05, 0.08))
+
+    def smoothedPoints(self, method, threads):
+        mesh = self.mesh.copy()
+        mesh.smooth(Method=method, Iteration=5, Threads=threads)
+        return [(p.x, p.y, p.z) for p in mesh.Points]
+
+    def testLaplace(self):
+        self.assertEqual(self.smoothedPoints("Laplace", 1), self.smoothedPoints("Laplace", 4))
+
+    def testTaubin(self):
+        self.assertEqual(self.smoothedPoints("Taubin", 1), self.smoothedPoints("Taubin", 4))
+
+    def testCurvature(self):
+        curv1 = self.mesh.getCurvaturePerVertex(1)
+        curv4 = self.mesh.getCurvaturePerVertex(4)
+        self.assertEqual(len(curv1), self.mesh.CountPoints)
+        self.assertEqual(curv1, curv4)
+
+
+class SelfIntersectionCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0, 30)
+        other = Mesh.createSphere(8.0, 30)
+        other.translate(5.0, 0.0, 0.0)
+        self.mesh.addMesh(other)
+
+    def testGridEqualsBVH(self):
+        self.assertTrue(self.mesh.hasSelfIntersections())
+        grid = self.mesh.getSelfIntersections()
+        bvh = self.mesh.getSelfIntersections("BVH")
+        self.assertTrue(len(bvh) > 0)
+        pairs = set((min(i[0], i[1]), max(i[0], i[1])) for i in grid)
+        self.assertEqual(pairs, set((i[0], i[1]) for i in bvh))
+
+    def testNoIntersection(self):
+        sphere = Mesh.createSphere(10.0, 30)
+        self.assertFalse(sphere.hasSelfIntersections())
+        self.assertEqual(len(sphere.getSelfIntersections("BVH")), 0)
+
+    def testInvalidMethod(self):
+        with self.assertRaises(ValueError):
+            self.mesh.getSelfIntersections("Octree")
+
+
+class CompactTopologyCases(unittest.TestCase):
+    def setUp(self):
+        # the large torus has enough facets to build the adjacency in several threads
+        self.meshes = []
+        for sampling in (40, 230):
+            mesh = Mesh.createTorus(8.0, 2.0, sampling)
+            mesh.removeFacets([sampling])
+            self.meshes.append(mesh)
+
+    def testFillupHoles(self):
+        for mesh in self.meshes:
+            count = mesh.CountFacets
+            self.assertFalse(mesh.isSolid())
+            mesh.fillupHoles(3)
+            self.assertEqual(mesh.CountFacets, count + 1)
+            self.assertTrue(mesh.isSolid())
+
+    def testSeparateComponents(self):
+        for mesh in self.meshes:
+            other = mesh.copy()
+            other.translate(0.0, 0.0, 10.0)
+            mesh.addMesh(other)
+            components = mesh.getSeparateComponents()
+            self.assertEqual(len(components), 2)
+            self.assertEqual([m.CountFacets for m in components], [other.CountFacets] * 2)
+
+    def testPointNeighbours(self):
+        # one Laplace step moves every inner point to the mean of its neighbours,
+        # so the result shows whether each point found all of its neighbours
+        lamda = 0.5
+        for mesh in self.meshes:
+            points, facets = mesh.Topology
+            neighbours = [set() for p in points]
+            counts = [0] * len(points)
+            for f in facets:
+                for i in f:
+                    neighbours[i].update(f)
+                    counts[i] += 1
+            expected = []
+            for i, p in enumerate(points):
+                n = neighbours[i] - {i}
+                if len(n) < 3 or len(n) != counts[i]:
+                    expected.append(p)
+                else:
+                    mean = FreeCAD.Vector()
+                    for j in n:
+                        mean += points[j]
+                    expected.append(p + (mean * (1.0 / len(n)) - p) * lamda)
+
+            mesh.smooth(Method="Laplace", Iteration=1, Lambda=lamda)
+            for p, q in zip(mesh.Points, expected):
+                self.assertAlmostEqual((p.Vector - q).Length, 0.0, 4)
@@ -57,7 +57,9 @@
 #include <fcntl.h>
 #include <assert.h>
 
+#include <algorithm>
 #include <array>
+#include <limits>
 #include <vector>
 #include <list>
 #include <set>
@@ -67,6 +69,7 @@
 #include <string>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 
 #include <cmath>
@@ -90,6 +90,8 @@ PROPERTY_SOURCE_ABSTRACT_WITH_EXTENSIONS(Part::Primitive, Part::Feature)
 Primitive::Primitive(void)
 {
     AttachExtension::initExtension(this);
+    // the shape is built from our own properties only, unless it is attached
+    setStatus(App::ThreadSafeExecute, true);
     touch();
 }
 
@@ -179,6 +181,10 @@ void Primitive::Restore(Base::XMLReader &reader)
 
 void Primitive::onChanged(const App::Property* prop)
 {
+    if (prop == &Support) {
+        // the attacher reads the shapes of the support objects
+        setStatus(App::ThreadSafeExecute, Support.getValues().empty());
+    }
     if (!isRestoring()) {
         // Do not support sphere, ellipsoid and torus because the creation
         // takes too long and thus is not feasible
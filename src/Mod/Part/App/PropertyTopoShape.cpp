@@ -75,6 +75,7 @@ using namespace Part;
 TYPESYSTEM_SOURCE(Part::PropertyPartShape , App::PropertyComplexGeoData)
 
 PropertyPartShape::PropertyPartShape()
+  : _HasLazyFile(false), _DirectAccess(true)
 {
 }
 
@@ -85,6 +86,8 @@ PropertyPartShape::~PropertyPartShape()
 void PropertyPartShape::setValue(const TopoShape& sh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
+    _HasLazyFile.store(false, std::memory_order_release);
     _Shape = sh;
     hasSetValue();
 }
@@ -92,27 +95,33 @@ void PropertyPartShape::setValue(const TopoShape& sh)
 void PropertyPartShape::setValue(const TopoDS_Shape& sh)
 {
     aboutToSetValue();
+    _LazyFile.reset();
+    _HasLazyFile.store(false, std::memory_order_release);
     _Shape.setShape(sh);
     hasSetValue();
 }
 
 const TopoDS_Shape& PropertyPartShape::getValue(void)const
 {
+    loadShape();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    loadShape();
     return this->_Shape;
 }
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    loadShape();
     return &(this->_Shape);
 }
 
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
+    loadShape();
     Base::BoundBox3d box;
     if (_Shape.getShape().IsNull())
         return box;
@@ -139,6 +148,7 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 {
+    loadShape();
     aboutToSetValue();
     _Shape.transformGeometry(rclTrf);
     hasSetValue();
@@ -147,7 +157,7 @@ void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 PyObject *PropertyPartShape::getPyObject(void)
 {
     Base::PyObjectBase* prop;
-    const TopoDS_Shape& sh = _Shape.getShape();
+    const TopoDS_Shape& sh = getValue();
     if (sh.IsNull()) {
         prop = new TopoShapePy(new TopoShape(sh));
     }
@@ -205,6 +215,7 @@ void PropertyPartShape::setPyObject(PyObject *value)
 
 App::Property *PropertyPartShape::Copy(void) const
 {
+    loadShape();
     PropertyPartShape *prop = new PropertyPartShape();
     prop->_Shape = this->_Shape;
     if (!_Shape.getShape().IsNull()) {
@@ -218,7 +229,9 @@ App::Property *PropertyPartShape::Copy(void) const
 void PropertyPartShape::Paste(const App::Property &from)
 {
     aboutToSetValue();
-    _Shape = dynamic_cast<const PropertyPartShape&>(from)._Shape;
+    _LazyFile.reset();
+    _HasLazyFile.store(false, std::memory_order_release);
+    _Shape = dynamic_cast<const PropertyPartShape&>(from).getShape();
     hasSetValue();
 }
 
@@ -241,11 +254,23 @@ void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) cons
                     << App::ObjectIdentifier::Component::SimpleComponent(App::ObjectIdentifier::String("Volume")));
 }
 
+void PropertyPartShape::readDirectAccess() const
+{
+    _DirectAccess = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+}
+
 void PropertyPartShape::Save (Base::Writer &writer) const
 {
     if(!writer.isForceXML()) {
+        readDirectAccess();
         //See SaveDocFile(), RestoreDocFile()
-        if (writer.getMode("BinaryBrep")) {
+        if (writer.getMode("ShapeBlob")) {
+            writer.Stream() << writer.ind() << "<Part file=\""
+                            << writer.addFile("PartShape.blob", this)
+                            << "\"/>" << std::endl;
+        }
+        else if (writer.getMode("BinaryBrep")) {
             writer.Stream() << writer.ind() << "<Part file=\""
                             << writer.addFile("PartShape.bin", this)
                             << "\"/>" << std::endl;
@@ -265,6 +290,7 @@ void PropertyPartShape::Restore(Base::XMLReader &reader)
 
     if (!file.empty()) {
         // initiate a file read
+        readDirectAccess();
         reader.addFile(file.c_str(),this);
     }
 }
@@ -317,18 +343,21 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
+    loadShape();
     if (_Shape.getShape().IsNull())
         return;
     TopoDS_Shape myShape = _Shape.getShape();
-    if (writer.getMode("BinaryBrep")) {
+    if (writer.getMode("ShapeBlob")) {
+        // written directly into the stream, no temporary file needed
+        _Shape.exportBlob(writer.Stream(), writer.getMode("ShapeTriangulation"));
+    }
+    else if (writer.getMode("BinaryBrep")) {
         TopoShape shape;
         shape.setShape(myShape);
         shape.exportBinary(writer.Stream());
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
-        if (!direct) {
+        if (!_DirectAccess) {
             // create a temporary file and copy the content to the zip stream
             // once the tmp. filename is known use always the same because otherwise
             // we may run into some problems on the Linux platform
@@ -382,18 +411,105 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     }
 }
 
+bool PropertyPartShape::hasConcurrentDocFile() const
+{
+    // with indirect access a temporary file is used
+    return _DirectAccess;
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
+{
+    decodeDocFile(reader);
+    applyDocFile();
+}
+
+bool PropertyPartShape::hasLazyDocFile() const
+{
+    return true;
+}
+
+void PropertyPartShape::setLazyDocFile(const std::shared_ptr<Base::LazyDocFile>& file)
+{
+    std::lock_guard<std::mutex> lock(_LoadMutex);
+    _LazyFile = file;
+    _HasLazyFile.store(static_cast<bool>(file), std::memory_order_release);
+}
+
+void PropertyPartShape::loadLazyDocFile()
+{
+    if (!_HasLazyFile.load(std::memory_order_acquire))
+        return;
+
+    std::lock_guard<std::mutex> lock(_LoadMutex);
+    if (!_LazyFile)
+        return;
+
+    // Reading deferred data is no modification, so no notification is sent.
+    // A file that cannot be read is not tried again.
+    std::shared_ptr<Base::LazyDocFile> file;
+    file.swap(_LazyFile);
+    try {
+        file->decode(*this);
+        _Shape = _DecodedShape;
+    }
+    catch (...) {
+        _DecodedShape.setShape(TopoDS_Shape());
+        _HasLazyFile.store(false, std::memory_order_release);
+        throw;
+    }
+    _DecodedShape.setShape(TopoDS_Shape());
+    _HasLazyFile.store(false, std::memory_order_release);
+}
+
+void PropertyPartShape::loadShape() const
+{
+    // The getters may be called by worker threads of a parallel recompute or
+    // save at the same time, loadLazyDocFile() reads the file only once
+    if (!_HasLazyFile.load(std::memory_order_acquire))
+        return;
+
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(_LoadMutex);
+        if (!_LazyFile)
+            return;
+        name = _LazyFile->getFileName();
+    }
+    try {
+        const_cast<PropertyPartShape*>(this)->loadLazyDocFile();
+    }
+    catch (const Base::Exception& e) {
+        Base::Console().Error("Reading failed from embedded file: %s (%s)\n", name.c_str(), e.what());
+    }
+    catch (const std::exception& e) {
+        Base::Console().Error("Reading failed from embedded file: %s (%s)\n", name.c_str(), e.what());
+    }
+}
+
+void PropertyPartShape::applyDocFile()
+{
+    TopoShape shape(_DecodedShape);
+    _DecodedShape.setShape(TopoDS_Shape());
+    setValue(shape);
+}
+
+void PropertyPartShape::decodeDocFile(Base::Reader &reader)
 {
     Base::FileInfo brep(reader.getFileName());
-    if (brep.hasExtension("bin")) {
+    if (brep.hasExtension("blob")) {
+        // an empty file means an empty shape, see SaveDocFile()
+        TopoShape shape;
+        if (reader.peek() != std::char_traits<char>::eof())
+            shape.importBlob(reader);
+        _DecodedShape = shape;
+    }
+    else if (brep.hasExtension("bin")) {
         TopoShape shape;
         shape.importBinary(reader);
-        setValue(shape);
+        _DecodedShape = shape;
     }
     else {
-        bool direct = App::GetApplication().GetParameterGroupByPath
-            ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
-        if (!direct) {
+        if (!_DirectAccess) {
             BRep_Builder builder;
             // create a temporary file and copy the content from the zip stream
             Base::FileInfo fi(App::Application::getTempFileName());
@@ -432,13 +548,13 @@ void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 
             // delete the temp file
             fi.deleteFile();
-            setValue(shape);
+            _DecodedShape.setShape(shape);
         }
         else {
             BRep_Builder builder;
             TopoDS_Shape shape;
             BRepTools::Read(shape, reader, builder);
-            setValue(shape);
+            _DecodedShape.setShape(shape);
         }
     }
 }
@@ -28,7 +28,9 @@
 #include <TopAbs_ShapeEnum.hxx>
 #include <App/DocumentObject.h>
 #include <App/PropertyGeo.h>
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace Part
@@ -82,6 +84,12 @@ public:
 
     void SaveDocFile (Base::Writer &writer) const;
     void RestoreDocFile(Base::Reader &reader);
+    bool hasConcurrentDocFile() const;
+    void decodeDocFile(Base::Reader &reader);
+    void applyDocFile();
+    bool hasLazyDocFile() const;
+    void setLazyDocFile(const std::shared_ptr<Base::LazyDocFile>& file);
+    void loadLazyDocFile();
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
@@ -91,8 +99,27 @@ public:
     /// Get valid paths for this property; used by auto completer
     virtual void getPaths(std::vector<App::ObjectIdentifier> & paths) const;
 
+private:
+    /// read the shape if it has been deferred
+    void loadShape() const;
+    /// reads the DirectAccess preference, called in the main thread
+    void readDirectAccess() const;
+
 private:
     TopoShape _Shape;
+    /// shape read by decodeDocFile() until it is applied
+    TopoShape _DecodedShape;
+    /// file of the shape which is read on first access
+    std::shared_ptr<Base::LazyDocFile> _LazyFile;
+    /// set while _LazyFile is pending, checked without locking
+    std::atomic<bool> _HasLazyFile;
+    /// the shape may be loaded by several worker threads at the same time
+    mutable std::mutex _LoadMutex;
+    /** DirectAccess preference of the last Save() or Restore(). The files
+     * may be written or read in worker threads, which must not access the
+     * parameters.
+     */
+    mutable bool _DirectAccess;
 };
 
 struct PartExport ShapeHistory {
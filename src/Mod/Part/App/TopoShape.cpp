@@ -24,10 +24,14 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <array>
 # include <cmath>
 # include <cstdlib>
+# include <cstring>
+# include <limits>
 # include <sstream>
+# include <vector>
 # include <QString>
 
 # include <BRepLib.hxx>
@@ -113,6 +117,7 @@
 # include <STEPControl_Writer.hxx>
 # include <STEPControl_Reader.hxx>
 # include <TopTools_MapOfShape.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
 # include <TopoDS.hxx>
 # include <TopoDS_Compound.hxx>
 # include <TopoDS_Iterator.hxx>
@@ -189,6 +194,7 @@
 #include <Base/FileInfo.h>
 #include <Base/Exception.h>
 #include <Base/Tools.h>
+#include <Base/Stream.h>
 #include <Base/Console.h>
 #include <App/Material.h>
 
@@ -819,6 +825,147 @@ void TopoShape::importBinary(std::istream& str)
     }
 }
 
+namespace {
+// Layout of the shape blob:
+// magic, version, flags, BinTools shape set, shape id, location id,
+// orientation, number of triangulated faces and the triangulations
+const char ShapeBlobMagic[4] = {'F','C','S','B'};
+const uint32_t ShapeBlobVersion = 1;
+const uint32_t ShapeBlobTriangulation = 1;
+
+// Reads \a count values of a triangulation. The memory grows with the data
+// actually read, so that a corrupt count cannot cause a huge allocation.
+template <typename T>
+void readBlobValues(Base::InputStream& str, std::vector<T>& values, uint64_t count)
+{
+    values.clear();
+    values.reserve(static_cast<std::size_t>(std::min<uint64_t>(count, 65536)));
+    for (uint64_t i = 0; i < count && str; i++) {
+        T value;
+        str >> value;
+        values.push_back(value);
+    }
+    if (!str)
+        throw Base::BadFormatError("Unexpected end of shape blob");
+}
+
+// Returns the number of bytes left in the stream or -1 if it cannot be determined
+std::streamoff remainingSize(std::istream& in)
+{
+    std::streampos pos = in.tellg();
+    if (pos < 0)
+        return -1;
+    in.seekg(0, std::ios::end);
+    std::streampos end = in.tellg();
+    in.seekg(pos);
+    if (end < 0 || !in) {
+        in.clear();
+        in.seekg(pos);
+        return -1;
+    }
+    return end - pos;
+}
+}
+
+void TopoShape::importBlob(std::istream& in)
+{
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || memcmp(magic, ShapeBlobMagic, sizeof(magic)) != 0)
+        throw Base::RuntimeError("Stream does not contain a shape blob");
+
+    Base::InputStream str(in);
+    uint32_t version = 0, flags = 0;
+    str >> version >> flags;
+    if (version > ShapeBlobVersion) {
+        std::stringstream ss;
+        ss << "Shape blob version " << version << " is not supported";
+        throw Base::RuntimeError(ss.str());
+    }
+
+    try {
+        BinTools_ShapeSet theShapeSet;
+        theShapeSet.Read(in);
+        Standard_Integer shapeId=0, locId=0, orient=0;
+        BinTools::GetInteger(in, shapeId);
+        BinTools::GetInteger(in, locId);
+        BinTools::GetInteger(in, orient);
+        if (shapeId <= 0 || shapeId > theShapeSet.NbShapes()) {
+            this->_Shape.Nullify();
+            return;
+        }
+
+        TopoDS_Shape shape = theShapeSet.Shape(shapeId);
+        shape.Location(theShapeSet.Locations().Location(locId));
+        shape.Orientation(static_cast<TopAbs_Orientation>(orient));
+
+        if (flags & ShapeBlobTriangulation) {
+            // the faces are enumerated in the same order as when writing
+            TopTools_IndexedMapOfShape faces;
+            TopExp::MapShapes(shape, TopAbs_FACE, faces);
+            BRep_Builder builder;
+
+            uint32_t count = 0;
+            str >> count;
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t index = 0, nbNodes = 0, nbTriangles = 0;
+                bool hasUV = false;
+                double deflection = 0;
+                str >> index >> nbNodes >> nbTriangles >> hasUV >> deflection;
+                if (!str || index < 1 || static_cast<int>(index) > faces.Extent())
+                    throw Base::BadFormatError("Invalid triangulation in shape blob");
+                if (nbNodes > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+                    nbTriangles > static_cast<uint32_t>(std::numeric_limits<int>::max()))
+                    throw Base::BadFormatError("Invalid triangulation in shape blob");
+
+                // nodes, uv nodes and triangles are written as doubles and 32-bit integers
+                uint64_t size = uint64_t(nbNodes) * (hasUV ? 40 : 24) + uint64_t(nbTriangles) * 12;
+                std::streamoff remaining = remainingSize(in);
+                if (remaining >= 0 && size > static_cast<uint64_t>(remaining))
+                    throw Base::BadFormatError("Unexpected end of shape blob");
+
+                std::vector<double> coords, uvCoords;
+                std::vector<int32_t> indices;
+                readBlobValues(str, coords, uint64_t(nbNodes) * 3);
+                if (hasUV)
+                    readBlobValues(str, uvCoords, uint64_t(nbNodes) * 2);
+                readBlobValues(str, indices, uint64_t(nbTriangles) * 3);
+                for (std::vector<int32_t>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
+                    if (*it < 1 || static_cast<uint32_t>(*it) > nbNodes)
+                        throw Base::BadFormatError("Invalid node index in shape blob");
+                }
+
+                Handle(Poly_Triangulation) mesh = new Poly_Triangulation(nbNodes, nbTriangles, hasUV);
+                mesh->Deflection(deflection);
+                TColgp_Array1OfPnt& nodes = mesh->ChangeNodes();
+                for (uint32_t j = 1; j <= nbNodes; j++) {
+                    const double* xyz = &coords[3 * (j - 1)];
+                    nodes(j).SetCoord(xyz[0], xyz[1], xyz[2]);
+                }
+                if (hasUV) {
+                    TColgp_Array1OfPnt2d& uvNodes = mesh->ChangeUVNodes();
+                    for (uint32_t j = 1; j <= nbNodes; j++) {
+                        const double* uv = &uvCoords[2 * (j - 1)];
+                        uvNodes(j).SetCoord(uv[0], uv[1]);
+                    }
+                }
+                Poly_Array1OfTriangle& triangles = mesh->ChangeTriangles();
+                for (uint32_t j = 1; j <= nbTriangles; j++) {
+                    const int32_t* tria = &indices[3 * (j - 1)];
+                    triangles(j).Set(tria[0], tria[1], tria[2]);
+                }
+
+                builder.UpdateFace(TopoDS::Face(faces(index)), mesh);
+            }
+        }
+
+        this->_Shape = shape;
+    }
+    catch (Standard_Failure& e) {
+        throw Base::CADKernelError(e.GetMessageString());
+    }
+}
+
 void TopoShape::write(const char *FileName) const
 {
     Base::FileInfo File(FileName);
@@ -930,6 +1077,67 @@ void TopoShape::exportBinary(std::ostream& out)
     }
 }
 
+void TopoShape::exportBlob(std::ostream& out, bool withTriangulation) const
+{
+    out.write(ShapeBlobMagic, sizeof(ShapeBlobMagic));
+    Base::OutputStream str(out);
+    str << ShapeBlobVersion << static_cast<uint32_t>(withTriangulation ? ShapeBlobTriangulation : 0);
+
+    // The shape set shares geometry and locations between sub-shapes
+    BinTools_ShapeSet theShapeSet;
+    Standard_Integer shapeId = -1, locId = -1, orient = -1;
+    if (!this->_Shape.IsNull()) {
+        shapeId = theShapeSet.Add(this->_Shape);
+        locId = theShapeSet.Locations().Index(this->_Shape.Location());
+        orient = static_cast<int>(this->_Shape.Orientation());
+    }
+
+    theShapeSet.Write(out);
+    BinTools::PutInteger(out, shapeId);
+    BinTools::PutInteger(out, locId);
+    BinTools::PutInteger(out, orient);
+
+    if (!withTriangulation)
+        return;
+
+    std::vector<std::pair<uint32_t, Handle(Poly_Triangulation)> > meshes;
+    if (!this->_Shape.IsNull()) {
+        TopTools_IndexedMapOfShape faces;
+        TopExp::MapShapes(this->_Shape, TopAbs_FACE, faces);
+        for (int i = 1; i <= faces.Extent(); i++) {
+            TopLoc_Location loc;
+            Handle(Poly_Triangulation) mesh = BRep_Tool::Triangulation(TopoDS::Face(faces(i)), loc);
+            if (!mesh.IsNull())
+                meshes.push_back(std::make_pair(static_cast<uint32_t>(i), mesh));
+        }
+    }
+
+    str << static_cast<uint32_t>(meshes.size());
+    for (const auto& it : meshes) {
+        const Handle(Poly_Triangulation)& mesh = it.second;
+        // the nodes are relative to the face location which is part of the shape set
+        str << it.first
+            << static_cast<uint32_t>(mesh->NbNodes())
+            << static_cast<uint32_t>(mesh->NbTriangles())
+            << static_cast<bool>(mesh->HasUVNodes())
+            << mesh->Deflection();
+        const TColgp_Array1OfPnt& nodes = mesh->Nodes();
+        for (int j = nodes.Lower(); j <= nodes.Upper(); j++)
+            str << nodes(j).X() << nodes(j).Y() << nodes(j).Z();
+        if (mesh->HasUVNodes()) {
+            const TColgp_Array1OfPnt2d& uvNodes = mesh->UVNodes();
+            for (int j = uvNodes.Lower(); j <= uvNodes.Upper(); j++)
+                str << uvNodes(j).X() << uvNodes(j).Y();
+        }
+        const Poly_Array1OfTriangle& triangles = mesh->Triangles();
+        for (int j = triangles.Lower(); j <= triangles.Upper(); j++) {
+            Standard_Integer n1, n2, n3;
+            triangles(j).Get(n1, n2, n3);
+            str << static_cast<int32_t>(n1) << static_cast<int32_t>(n2) << static_cast<int32_t>(n3);
+        }
+    }
+}
+
 void TopoShape::dump(std::ostream& out) const
 {
     BRepTools::Dump(this->_Shape, out);
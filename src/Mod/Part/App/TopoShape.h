@@ -180,11 +180,18 @@ public:
     void importBrep(const char *FileName);
     void importBrep(std::istream&, int indicator=1);
     void importBinary(std::istream&);
+    /// Read a shape written with exportBlob(), including its cached triangulation
+    void importBlob(std::istream&);
     void exportIges(const char *FileName) const;
     void exportStep(const char *FileName) const;
     void exportBrep(const char *FileName) const;
     void exportBrep(std::ostream&) const;
     void exportBinary(std::ostream&);
+    /** Write the shape in the versioned binary format used for documents.
+     * If \a withTriangulation is true the triangulation of the faces is
+     * written too so that it needs not to be recomputed after reading.
+     */
+    void exportBlob(std::ostream&, bool withTriangulation) const;
     void exportStl (const char *FileName, double deflection) const;
     void exportFaceSet(double, double, const std::vector<App::Color>&, std::ostream&) const;
     void exportLineSet(std::ostream&) const;
@@ -52,6 +52,67 @@ class PartTestCases(unittest.TestCase):
         #self.Doc.addObject("Part::Feature","Face").Shape = result
         #self.assertTrue(isinstance(result.Surface, Part.BSplineSurface))
 
+    def testShapeBlob(self):
+        grp = App.ParamGet("User parameter:BaseApp/Preferences/Document")
+        blob = grp.GetBool("SaveShapeBlob", False)
+        tria = grp.GetBool("SaveShapeTriangulation", False)
+        grp.SetBool("SaveShapeBlob", True)
+        grp.SetBool("SaveShapeTriangulation", True)
+        try:
+            doc = App.newDocument("PartTestBlob")
+            shape = Part.makeCylinder(2, 5)
+            shape.tessellate(0.1)
+            nodes = [len(f.getUVNodes()) for f in shape.Faces]
+            doc.addObject("Part::Feature", "Cylinder").Shape = shape
+            doc.addObject("Part::Feature", "Empty")
+            name = os.path.join(App.getTempPath(), "PartTestBlob.FCStd")
+            doc.saveAs(name)
+            App.closeDocument(doc.Name)
+        finally:
+            grp.SetBool("SaveShapeBlob", blob)
+            grp.SetBool("SaveShapeTriangulation", tria)
+
+        doc = App.openDocument(name)
+        try:
+            restored = doc.getObject("Cylinder").Shape
+            self.assertEqual(len(restored.Faces), len(shape.Faces))
+            self.assertAlmostEqual(restored.Volume, shape.Volume)
+            # getUVNodes() fails for a face without triangulation
+            self.assertEqual([len(f.getUVNodes()) for f in restored.Faces], nodes)
+            self.assertTrue(doc.getObject("Empty").Shape.isNull())
+        finally:
+            App.closeDocument(doc.Name)
+            os.remove(name)
+
+    def testLazyFileLoading(self):
+        doc = App.newDocument("PartTestLazy")
+        doc.addObject("Part::Feature", "Box").Shape = Part.makeBox(1, 2, 3)
+        doc.addObject("Part::Feature", "Sphere").Shape = Part.makeSphere(2)
+        name = os.path.join(App.getTempPath(), "PartTestLazy.FCStd")
+        doc.saveAs(name)
+        App.closeDocument(doc.Name)
+
+        grp = App.ParamGet("User parameter:BaseApp/Preferences/Document")
+        lazy = grp.GetBool("LazyFileLoading", False)
+        grp.SetBool("LazyFileLoading", True)
+        try:
+            doc = App.openDocument(name)
+        finally:
+            grp.SetBool("LazyFileLoading", lazy)
+
+        try:
+            self.assertAlmostEqual(doc.getObject("Box").Shape.Volume, 6.0)
+            doc.prefetchFiles([doc.getObject("Sphere")])
+            self.assertEqual(len(doc.getObject("Sphere").Shape.Faces), 1)
+            # saving to the same file must not lose data that is not read yet
+            doc.save()
+            App.closeDocument(doc.Name)
+            doc = App.openDocument(name)
+            self.assertAlmostEqual(doc.getObject("Box").Shape.Volume, 6.0)
+        finally:
+            App.closeDocument(doc.Name)
+            os.remove(name)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartTest")
@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 # include <BRepBuilderAPI_Transform.hxx>
 # include <BRepAlgoAPI_Fuse.hxx>
 # include <BRepAlgoAPI_Cut.hxx>
@@ -34,8 +35,13 @@
 # include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBndLib.hxx>
 # include <Bnd_Box.hxx>
+# include <Standard_Version.hxx>
+# include <TopoDS_Iterator.hxx>
+# include <TopTools_ListOfShape.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 
 #include "FeatureTransformed.h"
 #include "FeatureMultiTransform.h"
@@ -55,6 +61,62 @@
 
 using namespace PartDesign;
 
+namespace {
+
+// Non-destructive booleans, which are needed for concurrent checks, are available since OCC 7.1
+#if OCC_VERSION_HEX >= 0x070100
+/// A transformed shape whose intersection with the support is checked
+struct PatternInstance {
+    TopoDS_Shape support;
+    Bnd_Box supportBound;
+    TopoDS_Shape shape;
+    Bnd_Box bound;
+    bool intersects;
+    bool failed;
+    std::string error;
+
+    PatternInstance() : intersects(false), failed(false) {
+    }
+};
+
+// Does the same as Part::checkIntersection(support, shape, false, true) but leaves the
+// arguments untouched, so that the instances of a pattern can be checked concurrently
+void checkPatternInstance(PatternInstance& instance)
+{
+    // A gap between the bounding boxes means that the fuse gives two solids
+    if (instance.bound.IsOut(instance.supportBound))
+        return;
+
+    try {
+        TopTools_ListOfShape arguments, tools;
+        arguments.Append(instance.support);
+        tools.Append(instance.shape);
+
+        // If both shapes fuse to a single solid, then they intersect
+        BRepAlgoAPI_Fuse mkFuse;
+        mkFuse.SetArguments(arguments);
+        mkFuse.SetTools(tools);
+        mkFuse.SetNonDestructive(Standard_True);
+        mkFuse.Build();
+        if (!mkFuse.IsDone() || mkFuse.Shape().IsNull())
+            return;
+
+        TopExp_Explorer xp(mkFuse.Shape(), TopAbs_SOLID);
+        if (xp.More()) {
+            xp.Next();
+            instance.intersects = !xp.More();
+        }
+    }
+    catch (Standard_Failure& e) {
+        instance.failed = true;
+        if (e.GetMessageString() != NULL)
+            instance.error = e.GetMessageString();
+    }
+}
+#endif
+
+}
+
 namespace PartDesign {
 
 PROPERTY_SOURCE(PartDesign::Transformed, PartDesign::Feature)
@@ -247,6 +309,13 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
     typedef std::map<App::DocumentObject*,  trsf_it> rej_it_map;
     rej_it_map nointersect_trsfms;
 
+#if OCC_VERSION_HEX >= 0x070100
+    // Fuse or cut all transformed shapes of an original in one boolean operation
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter()
+        .GetGroup("BaseApp")->GetGroup("Preferences")->GetGroup("Mod/PartDesign");
+    bool batched = hGrp->GetBool("BatchPatternBoolean", false);
+#endif
+
     // NOTE: It would be possible to build a compound from all original addShapes/subShapes and then
     // transform the compounds as a whole. But we choose to apply the transformations to each
     // Original separately. This way it is easier to discover what feature causes a fuse/cut
@@ -275,9 +344,146 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
         trsf_it_vec v_transformations;
         std::vector<TopoDS_Shape> v_transformedShapes;*/
 
+        typedef std::vector<std::vector<gp_Trsf>::const_iterator> trsf_it_vec;
+        trsf_it_vec pending;
         std::vector<gp_Trsf>::const_iterator t = transformations.begin();
         ++t; // Skip first transformation, which is always the identity transformation
-        for (; t != transformations.end(); ++t) {
+        for (; t != transformations.end(); ++t)
+            pending.push_back(t);
+
+#if OCC_VERSION_HEX >= 0x070100
+        if (batched && pending.size() > 1) {
+            try {
+                // Without a copy the transformed shapes share the geometry of the original shape
+                std::vector<PatternInstance> instances(pending.size());
+                Bnd_Box supportBound;
+                BRepBndLib::Add(support, supportBound);
+                supportBound.SetGap(0.0);
+                for (std::size_t i = 0; i < pending.size(); ++i) {
+                    BRepBuilderAPI_Transform mkTrf(shape, *pending[i], false);
+                    if (!mkTrf.IsDone())
+                        return new App::DocumentObjectExecReturn("Transformation failed", (*o));
+                    PatternInstance& instance = instances[i];
+                    instance.support = support;
+                    instance.supportBound = supportBound;
+                    instance.shape = mkTrf.Shape();
+                    BRepBndLib::Add(instance.shape, instance.bound);
+                    instance.bound.SetGap(0.0);
+                }
+
+                // All instances are checked against the support as it is before this original
+                QtConcurrent::blockingMap(instances, checkPatternInstance);
+
+                std::vector<TopoDS_Shape> tools;
+                std::vector<Bnd_Box> toolBounds;
+                std::list<std::size_t> outside;
+                for (std::size_t i = 0; i < instances.size(); ++i) {
+                    const PatternInstance& instance = instances[i];
+                    if (instance.failed) {
+                        std::string msg("Transformation: Intersection check failed");
+                        if (!instance.error.empty())
+                            msg += std::string(": '") + instance.error + "'";
+                        return new App::DocumentObjectExecReturn(msg.c_str());
+                    }
+                    if (instance.intersects) {
+                        tools.push_back(instance.shape);
+                        toolBounds.push_back(instance.bound);
+                    }
+                    else {
+                        outside.push_back(i);
+                    }
+                }
+
+                // An added shape may only touch the support through other added shapes, e.g. a
+                // pattern that grows out of the support. These are fused one by one afterwards.
+                std::vector<std::size_t> chained;
+                bool grown = fuse;
+                while (grown) {
+                    grown = false;
+                    for (std::list<std::size_t>::iterator it = outside.begin(); it != outside.end();) {
+                        bool touches = false;
+                        for (std::vector<Bnd_Box>::const_iterator jt = toolBounds.begin(); jt != toolBounds.end(); ++jt) {
+                            if (!instances[*it].bound.IsOut(*jt)) {
+                                touches = true;
+                                break;
+                            }
+                        }
+                        if (touches) {
+                            toolBounds.push_back(instances[*it].bound);
+                            chained.push_back(*it);
+                            it = outside.erase(it);
+                            grown = true;
+                        }
+                        else {
+                            ++it;
+                        }
+                    }
+                }
+
+                for (std::list<std::size_t>::const_iterator it = outside.begin(); it != outside.end(); ++it) {
+#ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
+                    Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
+#endif
+                    nointersect_trsfms[*o].insert(pending[*it]);
+                }
+
+                if (!tools.empty()) {
+                    // Overlapping shapes must not be put into the same compound
+                    TopoDS_Compound compoundTool;
+                    std::vector<TopoDS_Shape> individualTools;
+                    divideTools(tools, individualTools, compoundTool);
+
+                    TopTools_ListOfShape arguments, toolList;
+                    arguments.Append(support);
+                    if (TopoDS_Iterator(compoundTool).More())
+                        toolList.Append(compoundTool);
+                    for (std::vector<TopoDS_Shape>::const_iterator it = individualTools.begin(); it != individualTools.end(); ++it)
+                        toolList.Append(*it);
+
+                    if (fuse) {
+                        BRepAlgoAPI_Fuse mkFuse;
+                        mkFuse.SetRunParallel(Standard_True);
+                        mkFuse.SetArguments(arguments);
+                        mkFuse.SetTools(toolList);
+                        mkFuse.Build();
+                        if (!mkFuse.IsDone())
+                            return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
+                        // we have to get the solids (fuse sometimes creates compounds)
+                        TopoDS_Shape current = this->getSolid(mkFuse.Shape());
+                        // lets check if the result is a solid
+                        if (current.IsNull())
+                            return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
+                        support = current;
+                    }
+                    else {
+                        BRepAlgoAPI_Cut mkCut;
+                        mkCut.SetRunParallel(Standard_True);
+                        mkCut.SetArguments(arguments);
+                        mkCut.SetTools(toolList);
+                        mkCut.Build();
+                        if (!mkCut.IsDone())
+                            return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
+                        support = mkCut.Shape();
+                    }
+                }
+
+                std::sort(chained.begin(), chained.end());
+                trsf_it_vec remaining;
+                for (std::vector<std::size_t>::const_iterator it = chained.begin(); it != chained.end(); ++it)
+                    remaining.push_back(pending[*it]);
+                pending.swap(remaining);
+            }
+            catch (Standard_Failure& e) {
+                std::string msg("Transformation: Intersection check failed");
+                if (e.GetMessageString() != NULL)
+                    msg += std::string(": '") + e.GetMessageString() + "'";
+                return new App::DocumentObjectExecReturn(msg.c_str());
+            }
+        }
+#endif
+
+        for (trsf_it_vec::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+            t = *it;
             // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
             // seems to be pretty broken
             BRepBuilderAPI_Copy copy(shape);
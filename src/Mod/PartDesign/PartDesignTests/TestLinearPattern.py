@@ -138,6 +138,54 @@ class TestLinearPattern(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 1e4)
 
+    def testBatchedLinearPattern(self):
+        # fusing or cutting all instances in one boolean has to give the same shape
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=10.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Box]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 45.0
+        self.LinearPattern.Occurrences = 10
+        self.Body.addObject(self.LinearPattern)
+        self.Cylinder = self.Doc.addObject('PartDesign::SubtractiveCylinder','Cylinder')
+        self.Body.addObject(self.Cylinder)
+        self.Cylinder.Radius = 1.0
+        self.Cylinder.Height = 10.0
+        self.Cylinder.Placement.Base = FreeCAD.Vector(5, 5, 0)
+        self.Doc.recompute()
+        self.CutPattern = self.Doc.addObject("PartDesign::LinearPattern","CutPattern")
+        self.CutPattern.Originals = [self.Cylinder]
+        self.CutPattern.Direction = (self.Doc.X_Axis,[""])
+        self.CutPattern.Length = 45.0
+        self.CutPattern.Occurrences = 10
+        self.Body.addObject(self.CutPattern)
+
+        grp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/PartDesign")
+        batched = grp.GetBool("BatchPatternBoolean", False)
+        results = []
+        try:
+            for on in (False, True):
+                grp.SetBool("BatchPatternBoolean", on)
+                self.LinearPattern.touch()
+                self.Doc.recompute()
+                results.append([(len(f.Shape.Solids), f.Shape.Volume) for f in (self.LinearPattern, self.CutPattern)])
+        finally:
+            grp.SetBool("BatchPatternBoolean", batched)
+
+        self.assertEqual(results[0][0][0], 1)
+        self.assertAlmostEqual(results[0][0][1], 5500)
+        self.assertEqual(results[0][1][0], 1)
+        self.assertAlmostEqual(results[0][1][1], 5500 - 100 * 3.141592653589793, 4)
+        for (solids1, volume1), (solids2, volume2) in zip(results[0], results[1]):
+            self.assertEqual(solids1, solids2)
+            self.assertAlmostEqual(volume1, volume2, 4)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestLinearPattern")
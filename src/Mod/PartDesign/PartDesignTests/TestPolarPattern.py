@@ -138,6 +138,39 @@ class TestPolarPattern(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.PolarPattern.Shape.Volume, 4000)
 
+    def testBatchedPolarPattern(self):
+        # fusing all instances in one boolean has to give the same shape
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=10.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Box.Placement.Base = FreeCAD.Vector(5, 0, 0)
+        self.Doc.recompute()
+        self.PolarPattern = self.Doc.addObject("PartDesign::PolarPattern","PolarPattern")
+        self.PolarPattern.Originals = [self.Box]
+        self.PolarPattern.Axis = (self.Doc.Z_Axis,[""])
+        self.PolarPattern.Angle = 360
+        self.PolarPattern.Occurrences = 8
+        self.Body.addObject(self.PolarPattern)
+
+        grp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/PartDesign")
+        batched = grp.GetBool("BatchPatternBoolean", False)
+        results = []
+        try:
+            for on in (False, True):
+                grp.SetBool("BatchPatternBoolean", on)
+                self.PolarPattern.touch()
+                self.Doc.recompute()
+                results.append((len(self.PolarPattern.Shape.Solids), self.PolarPattern.Shape.Volume))
+        finally:
+            grp.SetBool("BatchPatternBoolean", batched)
+
+        self.assertEqual(results[0][0], 1)
+        self.assertEqual(results[1][0], results[0][0])
+        self.assertAlmostEqual(results[1][1], results[0][1], 4)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestPolarPattern")
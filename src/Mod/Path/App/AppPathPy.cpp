@@ -32,6 +32,7 @@
 #include <Base/Console.h>
 #include <Base/VectorPy.h>
 #include <Base/FileInfo.h>
+#include <Base/Stream.h>
 #include <Base/Interpreter.h>
 #include <App/Document.h>
 #include <App/DocumentObjectPy.h>
@@ -193,12 +194,9 @@ private:
 
         try {
             // read the gcode file
-            std::ifstream filestr(file.filePath().c_str());
-            std::stringstream buffer;
-            buffer << filestr.rdbuf();
-            std::string gcode = buffer.str();
+            Base::ifstream filestr(file, std::ios::in | std::ios::binary);
             Toolpath path;
-            path.setFromGCode(gcode);
+            path.setFromGCode(filestr);
             Path::Feature *object = static_cast<Path::Feature *>(pcDoc->addObject("Path::Feature",file.fileNamePure().c_str()));
             object->Path.setValue(path);
             pcDoc->recompute();
@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <cinttypes>
 # include <iomanip>
 # include <boost/algorithm/string.hpp>
@@ -42,6 +43,228 @@ using namespace Path;
 
 TYPESYSTEM_SOURCE(Path::Command , Base::Persistence)
 
+// CommandParameters
+
+CommandParameters::const_iterator::const_iterator()
+  : params(0), letter(CommandParameters::NumLetters), other(0), onLetter(false)
+{
+}
+
+CommandParameters::const_iterator::const_iterator(const CommandParameters* p, int l, std::size_t o)
+  : params(p), letter(l), other(o), onLetter(false)
+{
+    update();
+}
+
+void CommandParameters::const_iterator::update()
+{
+    // skip to the next set letter
+    while (letter < NumLetters && !params->hasLetter(letter))
+        ++letter;
+
+    bool hasLetter = letter < NumLetters;
+    bool hasOther = other < params->others.size();
+    if (hasLetter && hasOther)
+        onLetter = letterKey(letter) < params->others[other].first;
+    else
+        onLetter = hasLetter;
+
+    if (onLetter)
+        current = value_type(letterKey(letter), params->getLetter(letter));
+    else if (hasOther)
+        current = params->others[other];
+}
+
+CommandParameters::const_iterator& CommandParameters::const_iterator::operator++()
+{
+    if (onLetter)
+        ++letter;
+    else
+        ++other;
+    update();
+    return *this;
+}
+
+CommandParameters::const_iterator CommandParameters::const_iterator::operator++(int)
+{
+    const_iterator it(*this);
+    ++(*this);
+    return it;
+}
+
+CommandParameters::CommandParameters()
+  : mask(0)
+{
+}
+
+CommandParameters::CommandParameters(const std::map<std::string,double>& parameters)
+  : mask(0)
+{
+    for (std::map<std::string,double>::const_iterator it = parameters.begin(); it != parameters.end(); ++it)
+        (*this)[it->first] = it->second;
+}
+
+int CommandParameters::letterIndex(const std::string& key)
+{
+    if (key.size() == 1 && key[0] >= 'A' && key[0] <= 'Z')
+        return key[0] - 'A';
+    return -1;
+}
+
+const std::string& CommandParameters::letterKey(int index)
+{
+    static const std::string keys[NumLetters] = {
+        "A","B","C","D","E","F","G","H","I","J","K","L","M",
+        "N","O","P","Q","R","S","T","U","V","W","X","Y","Z"
+    };
+    return keys[index];
+}
+
+std::size_t CommandParameters::valueIndex(int index) const
+{
+    // number of set bits below the given letter
+    std::uint32_t bits = mask & ((1u << index) - 1);
+    std::size_t count = 0;
+    for (; bits; count++)
+        bits &= bits - 1;
+    return count;
+}
+
+std::vector<CommandParameters::value_type>::const_iterator CommandParameters::findOther(const std::string& key) const
+{
+    std::vector<value_type>::const_iterator it = std::lower_bound(others.begin(), others.end(),
+        value_type(key, 0.0), [](const value_type& a, const value_type& b) { return a.first < b.first; });
+    if (it != others.end() && it->first == key)
+        return it;
+    return others.end();
+}
+
+CommandParameters::const_iterator CommandParameters::begin() const
+{
+    return const_iterator(this, 0, 0);
+}
+
+CommandParameters::const_iterator CommandParameters::end() const
+{
+    return const_iterator(this, NumLetters, others.size());
+}
+
+CommandParameters::const_iterator CommandParameters::find(const std::string& key) const
+{
+    int index = letterIndex(key);
+    if (index >= 0) {
+        if (!hasLetter(index))
+            return end();
+        // the other keys before the letter need to be skipped
+        std::size_t other = std::lower_bound(others.begin(), others.end(), value_type(key, 0.0),
+            [](const value_type& a, const value_type& b) { return a.first < b.first; }) - others.begin();
+        return const_iterator(this, index, other);
+    }
+
+    std::vector<value_type>::const_iterator it = findOther(key);
+    if (it == others.end())
+        return end();
+    int letter = 0;
+    while (letter < NumLetters && letterKey(letter) < key)
+        ++letter;
+    return const_iterator(this, letter, it - others.begin());
+}
+
+std::size_t CommandParameters::count(const std::string& key) const
+{
+    int index = letterIndex(key);
+    if (index >= 0)
+        return hasLetter(index) ? 1 : 0;
+    return findOther(key) != others.end() ? 1 : 0;
+}
+
+std::size_t CommandParameters::size() const
+{
+    return values.size() + others.size();
+}
+
+bool CommandParameters::empty() const
+{
+    return values.empty() && others.empty();
+}
+
+void CommandParameters::clear()
+{
+    mask = 0;
+    values.clear();
+    others.clear();
+}
+
+std::size_t CommandParameters::erase(const std::string& key)
+{
+    int index = letterIndex(key);
+    if (index >= 0) {
+        if (!hasLetter(index))
+            return 0;
+        values.erase(values.begin() + valueIndex(index));
+        mask &= ~(1u << index);
+        return 1;
+    }
+
+    std::vector<value_type>::const_iterator it = findOther(key);
+    if (it == others.end())
+        return 0;
+    others.erase(others.begin() + (it - others.begin()));
+    return 1;
+}
+
+double& CommandParameters::operator[](const std::string& key)
+{
+    int index = letterIndex(key);
+    if (index >= 0) {
+        if (!hasLetter(index))
+            setLetter(index, 0.0);
+        return values[valueIndex(index)];
+    }
+
+    std::vector<value_type>::iterator it = std::lower_bound(others.begin(), others.end(), value_type(key, 0.0),
+        [](const value_type& a, const value_type& b) { return a.first < b.first; });
+    if (it == others.end() || it->first != key)
+        it = others.insert(it, value_type(key, 0.0));
+    return it->second;
+}
+
+double CommandParameters::value(const std::string& key, double def) const
+{
+    int index = letterIndex(key);
+    if (index >= 0)
+        return hasLetter(index) ? getLetter(index) : def;
+    std::vector<value_type>::const_iterator it = findOther(key);
+    return it != others.end() ? it->second : def;
+}
+
+double CommandParameters::getLetter(int index) const
+{
+    return values[valueIndex(index)];
+}
+
+void CommandParameters::setLetter(int index, double value)
+{
+    std::size_t pos = valueIndex(index);
+    if (hasLetter(index)) {
+        values[pos] = value;
+    }
+    else {
+        values.insert(values.begin() + pos, value);
+        mask |= (1u << index);
+    }
+}
+
+unsigned int CommandParameters::getMemSize() const
+{
+    unsigned int size = values.capacity() * sizeof(double) + others.capacity() * sizeof(value_type);
+    for (std::vector<value_type>::const_iterator it = others.begin(); it != others.end(); ++it)
+        size += it->first.capacity();
+    return size;
+}
+
+// Command
+
 // Constructors & destructors
 
 Command::Command(const char* name,
@@ -107,7 +330,7 @@ std::string Command::toGCode (int precision, bool padzero) const
         precision = 0;
     double scale = std::pow(10.0,precision+1);
     std::int64_t iscale = static_cast<std::int64_t>(scale)/10;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         if(i->first == "N") continue;
 
         str << " " << i->first;
@@ -138,70 +361,85 @@ std::string Command::toGCode (int precision, bool padzero) const
 
 void Command::setFromGCode (const std::string& str)
 {
+    setFromGCode(str.c_str(), str.size());
+}
+
+void Command::setFromGCode (const char* str, std::size_t len)
+{
+    enum Mode { ModeNone, ModeCommand, ModeArgument, ModeComment };
+
     Parameters.clear();
-    std::string mode = "none";
+    Mode mode = ModeNone;
     std::string key;
     std::string value;
-    for (unsigned int i=0; i < str.size(); i++) {
-        if ( (isdigit(str[i])) || (str[i] == '-') || (str[i] == '.') ) {
+    for (std::size_t i=0; i < len; i++) {
+        unsigned char ch = static_cast<unsigned char>(str[i]);
+        if ( (isdigit(ch)) || (ch == '-') || (ch == '.') ) {
             value += str[i];
-        } else if (isalpha(str[i])) {
-            if (mode == "command") {
+        } else if (isalpha(ch)) {
+            if (mode == ModeCommand) {
                 if (!key.empty() && !value.empty()) {
-                    std::string cmd = key + value;
-                    boost::to_upper(cmd);
-                    Name = cmd;
-                    key = "";
-                    value = "";
-                    mode = "argument";
+                    Name = key + value;
+                    boost::to_upper(Name);
+                    key.clear();
+                    value.clear();
                 } else {
                     throw Base::BadFormatError("Badly formatted GCode command");
                 }
-                mode = "argument";
-            } else if (mode == "none") {
-                mode = "command";
-            } else if (mode == "argument") {
+                mode = ModeArgument;
+            } else if (mode == ModeNone) {
+                mode = ModeCommand;
+            } else if (mode == ModeArgument) {
                 if (!key.empty() && !value.empty()) {
-                    double val = std::atof(value.c_str());
-                    boost::to_upper(key);
-                    Parameters[key] = val;
-                    key = "";
-                    value = "";
+                    setParameter(key, std::atof(value.c_str()));
+                    key.clear();
+                    value.clear();
                 } else {
                     throw Base::BadFormatError("Badly formatted GCode argument");
                 }
-            } else if (mode == "comment") {
+            } else if (mode == ModeComment) {
                 value += str[i];
             }
             key = str[i];
-        } else if (str[i] == '(') {
-            mode = "comment";
-        } else if (str[i] == ')') {
+        } else if (ch == '(') {
+            mode = ModeComment;
+        } else if (ch == ')') {
             key = "(";
             value += ")";
         } else {
             // add non-ascii characters only if this is a comment
-            if (mode == "comment") {
+            if (mode == ModeComment) {
                 value += str[i];
             }
         }
     }
     if (!key.empty() && !value.empty()) {
-        if ( (mode == "command") || (mode == "comment") ) {
-            std::string cmd = key + value;
-            if (mode == "command")
-                boost::to_upper(cmd);
-            Name = cmd;
+        if ( (mode == ModeCommand) || (mode == ModeComment) ) {
+            Name = key + value;
+            if (mode == ModeCommand)
+                boost::to_upper(Name);
         } else {
-            double val = std::atof(value.c_str());
-            boost::to_upper(key);
-            Parameters[key] = val;
+            setParameter(key, std::atof(value.c_str()));
         }
     } else {
         throw Base::BadFormatError("Badly formatted GCode argument");
     }
 }
 
+void Command::setParameter(const std::string& key, double value)
+{
+    // keys of the G-code are single letters, avoid any temporary strings for them
+    int index = key.size() == 1 ? toupper(key[0]) - 'A' : -1;
+    if (index >= 0 && index < CommandParameters::NumLetters) {
+        Parameters.setLetter(index, value);
+    }
+    else {
+        std::string k(key);
+        boost::to_upper(k);
+        Parameters[k] = value;
+    }
+}
+
 void Command::setFromPlacement (const Base::Placement &plac)
 {
     Name = "G1";
@@ -261,7 +499,7 @@ Command Command::transform(const Base::Placement other)
     plac.getRotation().getYawPitchRoll(aval,bval,cval);
     Command c = Command();
     c.Name = Name;
-    for(std::map<std::string,double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         std::string k = i->first;
         double v = i->second;
         if (k == "X")
@@ -283,7 +521,7 @@ Command Command::transform(const Base::Placement other)
 
 void Command::scaleBy(double factor)
 {
-    for(std::map<std::string, double>::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = Parameters.begin(); i != Parameters.end(); ++i) {
         switch (i->first[0]) {
             case 'X':
             case 'Y':
@@ -303,7 +541,7 @@ void Command::scaleBy(double factor)
 
 unsigned int Command::getMemSize (void) const
 {
-    return toGCode().size();
+    return sizeof(Command) + Name.capacity() + Parameters.getMemSize();
 }
 
 void Command::Save (Writer &writer) const
@@ -26,12 +26,103 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <iterator>
+#include <cstdint>
 #include <Base/Persistence.h>
 #include <Base/Placement.h>
 #include <Base/Vector3D.h>
 
 namespace Path
 {
+    /** Compact storage of the parameters of a command.
+     * The single-letter words of G-code (X, Y, Z, I, J, K, F, ...) are
+     * kept as a bitmask together with their values in alphabetical order,
+     * any other key is stored in a separate sorted list. The interface mimics
+     * the subset of std::map<std::string,double> used by the Path module,
+     * the iteration order is the same as the one of std::map.
+     */
+    class PathExport CommandParameters
+    {
+    public:
+        typedef std::pair<std::string, double> value_type;
+
+        class PathExport const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef CommandParameters::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef const value_type& reference;
+
+            const_iterator();
+            reference operator*() const { return current; }
+            pointer operator->() const { return &current; }
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            bool operator==(const const_iterator& it) const
+            { return letter == it.letter && other == it.other; }
+            bool operator!=(const const_iterator& it) const
+            { return !(*this == it); }
+
+        private:
+            friend class CommandParameters;
+            const_iterator(const CommandParameters*, int letter, std::size_t other);
+            void update();
+
+            const CommandParameters* params;
+            int letter;         // next set bit of the mask, NumLetters if none
+            std::size_t other;  // next entry of the other keys
+            bool onLetter;
+            value_type current;
+        };
+        typedef const_iterator iterator;
+
+        CommandParameters();
+        CommandParameters(const std::map<std::string,double>&);
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_iterator find(const std::string&) const;
+        std::size_t count(const std::string&) const;
+        std::size_t size() const;
+        bool empty() const;
+        void clear();
+        std::size_t erase(const std::string&);
+        /// inserts the key if needed, the reference is only valid until the next insertion
+        double& operator[](const std::string&);
+        /// returns the value of the given key or \a def if not set
+        double value(const std::string&, double def=0.0) const;
+
+        /** @name Direct access to the single-letter words
+         * The index of a letter is its offset from 'A'.
+         */
+        //@{
+        bool hasLetter(int index) const { return (mask & (1u << index)) != 0; }
+        double getLetter(int index) const;
+        void setLetter(int index, double value);
+        std::uint32_t getLetterMask() const { return mask; }
+        //@}
+
+        unsigned int getMemSize() const;
+
+        static const int NumLetters = 26;
+        /// returns the index of a single upper case letter key or -1
+        static int letterIndex(const std::string&);
+        /// returns the interned key of a letter
+        static const std::string& letterKey(int index);
+
+    private:
+        std::size_t valueIndex(int index) const;
+        std::vector<value_type>::const_iterator findOther(const std::string&) const;
+
+    private:
+        std::uint32_t mask;
+        std::vector<double> values;
+        std::vector<value_type> others;
+    };
+
     /** The representation of a cnc command in a path */
     class PathExport Command : public Base::Persistence
     {
@@ -54,21 +145,22 @@ namespace Path
         void setCenter(const Base::Vector3d&, bool clockwise=true); // sets the center coordinates and the command name
         std::string toGCode (int precision=6, bool padzero=true) const; // returns a GCode string representation of the command
         void setFromGCode (const std::string&); // sets the parameters from the contents of the given GCode string
+        void setFromGCode (const char*, std::size_t); // same as above for a part of a buffer
         void setFromPlacement (const Base::Placement&); // sets the parameters from the contents of the given placement
         bool has(const std::string&) const; // returns true if the given string exists in the parameters
         Command transform(const Base::Placement); // returns a transformed copy of this command
         double getValue(const std::string &name) const; // returns the value of a given parameter
         void scaleBy(double factor); // scales the receiver - use for imperial/metric conversions
+        void setParameter(const std::string&, double); // sets a parameter, the key is converted to upper case
 
         // this assumes the name is upper case
         inline double getParam(const std::string &name) const {
-            auto it = Parameters.find(name);
-            return it==Parameters.end()?0.0:it->second;
+            return Parameters.value(name);
         }
 
         // attributes
         std::string Name;
-        std::map<std::string,double> Parameters;
+        CommandParameters Parameters;
     };
     
 } //namespace Path
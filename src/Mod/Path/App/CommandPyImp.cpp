@@ -47,7 +47,7 @@ std::string CommandPy::representation(void) const
     str << "Command ";
     str << getCommandPtr()->Name;
     str << " [";
-    for(std::map<std::string,double>::iterator i = getCommandPtr()->Parameters.begin(); i != getCommandPtr()->Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = getCommandPtr()->Parameters.begin(); i != getCommandPtr()->Parameters.end(); ++i) {
         std::string k = i->first;
         double v = i->second;
         str << " " << k << ":" << v;
@@ -158,7 +158,7 @@ void CommandPy::setName(Py::String arg)
 Py::Dict CommandPy::getParameters(void) const
 {
     PyObject *dict = PyDict_New();
-    for(std::map<std::string,double>::iterator i = getCommandPtr()->Parameters.begin(); i != getCommandPtr()->Parameters.end(); ++i) {
+    for(CommandParameters::const_iterator i = getCommandPtr()->Parameters.begin(); i != getCommandPtr()->Parameters.end(); ++i) {
 #if PY_MAJOR_VERSION >= 3
         PyDict_SetItem(dict,PyUnicode_FromString(i->first.c_str()),PyFloat_FromDouble(i->second));
 #else
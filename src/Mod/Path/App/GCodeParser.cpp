@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include "GCodeParser.h"
+#include "Command.h"
+
+using namespace Path;
+
+
+GCodeParser::GCodeParser(std::vector<Command*>& cmds)
+  : commands(cmds)
+  , state(Skip)
+  , inches(false)
+{
+}
+
+GCodeParser::~GCodeParser()
+{
+}
+
+void GCodeParser::parse(const char* data, std::size_t size)
+{
+    // The program is split at every G, M and comment. Text before the
+    // first command and between a comment and the next command is dropped.
+    const char* end = data + size;
+    for (const char* it = data; it != end; ++it) {
+        char ch = *it;
+        switch (state) {
+        case Skip:
+            if (ch == '(') {
+                fragment = ch;
+                state = InComment;
+            }
+            else if (ch == 'G' || ch == 'g' || ch == 'M' || ch == 'm') {
+                fragment = ch;
+                state = InCommand;
+            }
+            break;
+        case InCommand:
+            if (ch == '(') {
+                addCommand();
+                fragment = ch;
+                state = InComment;
+            }
+            else if (ch == 'G' || ch == 'g' || ch == 'M' || ch == 'm') {
+                addCommand();
+                fragment = ch;
+            }
+            else {
+                // copy the run of characters up to the next split point at once
+                const char* next = it + 1;
+                while (next != end && *next != '(' && *next != 'G' && *next != 'g'
+                                   && *next != 'M' && *next != 'm')
+                    ++next;
+                fragment.append(it, next);
+                it = next - 1;
+            }
+            break;
+        case InComment:
+            {
+                const char* next = std::find(it, end, ')');
+                if (next == end) {
+                    fragment.append(it, end);
+                    it = end - 1;
+                }
+                else {
+                    fragment.append(it, next + 1);
+                    it = next;
+                    addCommand();
+                    state = Skip;
+                }
+            }
+            break;
+        }
+    }
+}
+
+void GCodeParser::parse(std::istream& in)
+{
+    std::vector<char> buffer(1 << 16);
+    while (in) {
+        in.read(&buffer[0], buffer.size());
+        std::streamsize count = in.gcount();
+        if (count <= 0)
+            break;
+        parse(&buffer[0], static_cast<std::size_t>(count));
+    }
+    finish();
+}
+
+void GCodeParser::finish()
+{
+    // an unterminated comment is dropped
+    if (state == InCommand)
+        addCommand();
+    fragment.clear();
+    state = Skip;
+}
+
+void GCodeParser::addCommand()
+{
+    Command *cmd = new Command();
+    try {
+        cmd->setFromGCode(fragment.c_str(), fragment.size());
+    }
+    catch (...) {
+        delete cmd;
+        throw;
+    }
+
+    if ("G20" == cmd->Name) {
+        inches = true;
+        delete cmd;
+    } else if ("G21" == cmd->Name) {
+        inches = false;
+        delete cmd;
+    } else {
+        if (inches) {
+            cmd->scaleBy(25.4);
+        }
+        commands.push_back(cmd);
+    }
+}
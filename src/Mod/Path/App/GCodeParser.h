@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PATH_GCODEPARSER_H
+#define PATH_GCODEPARSER_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace Path
+{
+    class Command;
+
+    /** Single-pass G-code tokenizer.
+     * The input is split into commands at every G, M or comment and each
+     * part is turned into a Command right away, so that neither the whole
+     * program nor its fragments have to be copied. Input can be fed in
+     * pieces, e.g. from a stream or a memory block, the unit mode is kept
+     * between the pieces.
+     */
+    class PathExport GCodeParser
+    {
+    public:
+        GCodeParser(std::vector<Command*>& commands);
+        ~GCodeParser();
+
+        /// parses the given part of the program
+        void parse(const char* data, std::size_t size);
+        /// parses the whole stream in chunks
+        void parse(std::istream&);
+        /// processes a pending command at the end of the program
+        void finish();
+
+        /** @name Modal state */
+        //@{
+        /// true after G20, the coordinates of the following commands are converted to mm
+        bool isInches() const { return inches; }
+        //@}
+
+    private:
+        void addCommand();
+
+    private:
+        enum State { Skip, InCommand, InComment };
+
+        std::vector<Command*>& commands;
+        std::string fragment;
+        State state;
+        bool inches;
+    };
+
+} //namespace Path
+
+#endif // PATH_GCODEPARSER_H
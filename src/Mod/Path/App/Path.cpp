@@ -24,6 +24,8 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cstring>
 # include <boost/regex.hpp>
 #endif
 
@@ -31,6 +33,8 @@
 #include <Base/Reader.h>
 #include <Base/Stream.h>
 #include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <App/Application.h>
 
 // KDL stuff - at the moment, not used
 //#include "Mod/Robot/App/kdl_cp/path_line.hpp"
@@ -39,6 +43,7 @@
 //#include "Mod/Robot/App/kdl_cp/utilities/error.h"
 
 #include "Path.h"
+#include "GCodeParser.h"
 
 using namespace Path;
 using namespace Base;
@@ -145,74 +150,22 @@ double Toolpath::getLength()
     return l;
 }
 
-static void bulkAddCommand(const std::string &gcodestr, std::vector<Command*> &commands, bool &inches)
+void Toolpath::setFromGCode(const std::string instr)
 {
-    Command *cmd = new Command();
-    cmd->setFromGCode(gcodestr);
-    if ("G20" == cmd->Name) {
-        inches = true;
-        delete cmd;
-    } else if ("G21" == cmd->Name) {
-        inches = false;
-        delete cmd;
-    } else {
-        if (inches) {
-            cmd->scaleBy(25.4);
-        }
-        commands.push_back(cmd);
-    }
+    clear();
+
+    GCodeParser parser(vpcCommands);
+    parser.parse(instr.c_str(), instr.size());
+    parser.finish();
+    recalculate();
 }
 
-void Toolpath::setFromGCode(const std::string instr)
+void Toolpath::setFromGCode(std::istream& in)
 {
     clear();
 
-    // remove comments
-    //boost::regex e("\\(.*?\\)");
-    //std::string str = boost::regex_replace(instr, e, "");
-    std::string str(instr);
-
-    // split input string by () or G or M commands
-    std::string mode = "command";
-    std::size_t found = str.find_first_of("(gGmM");
-    int last = -1;
-    bool inches = false;
-    while (found != std::string::npos)
-    {
-        if (str[found] == '(') {
-            // start of comment
-            if ( (last > -1) && (mode == "command") ) {
-                // before opening a comment, add the last found command
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
-            }
-            mode = "comment";
-            last = found;
-            found = str.find_first_of(")", found+1);
-        } else if (str[found] == ')') {
-            // end of comment
-            std::string gcodestr = str.substr(last, found-last+1);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-            last = -1;
-            found = str.find_first_of("(gGmM", found+1);
-            mode = "command";
-        } else if (mode == "command") {
-            // command
-            if (last > -1) {
-                std::string gcodestr = str.substr(last, found-last);
-                bulkAddCommand(gcodestr, vpcCommands, inches);
-            }
-            last = found;
-            found = str.find_first_of("(gGmM", found+1);
-        }
-    }
-    // add the last command found, if any
-    if (last > -1) {
-        if (mode == "command") {
-            std::string gcodestr = str.substr(last,std::string::npos);
-            bulkAddCommand(gcodestr, vpcCommands, inches);
-        }
-    }
+    GCodeParser parser(vpcCommands);
+    parser.parse(in);
     recalculate();
 }
 
@@ -293,7 +246,10 @@ void Toolpath::recalculate(void) // recalculates the path cache
 
 unsigned int Toolpath::getMemSize (void) const
 {
-    return toGCode().size();
+    unsigned int size = vpcCommands.capacity() * sizeof(Command*);
+    for (std::vector<Command*>::const_iterator it = vpcCommands.begin(); it != vpcCommands.end(); ++it)
+        size += (*it)->getMemSize();
+    return size;
 }
 
 void Toolpath::setCenter(const Base::Vector3d &c)
@@ -302,6 +258,14 @@ void Toolpath::setCenter(const Base::Vector3d &c)
     recalculate();
 }
 
+static bool useBinaryFormat()
+{
+    // The binary format is not understood by older versions, so it must
+    // be enabled explicitly
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Path")->GetBool("BinaryToolpath", false);
+}
+
 static void saveCenter(Writer &writer, const Base::Vector3d &center)
 {
     writer.Stream() << writer.ind() << "<Center x=\"" << center.x << "\" y=\"" << center.y << "\" z=\"" << center.z << "\"/>" << std::endl;
@@ -318,8 +282,9 @@ void Toolpath::Save (Writer &writer) const
         }
         writer.decInd();
     } else {
+        std::string file = writer.ObjectName + (useBinaryFormat() ? ".bin" : ".nc");
         writer.Stream() << writer.ind()
-            << "<Path file=\"" << writer.addFile((writer.ObjectName+".nc").c_str(), this) << "\" version=\"" << SchemaVersion << "\">" << std::endl;
+            << "<Path file=\"" << writer.addFile(file.c_str(), this) << "\" version=\"" << SchemaVersion << "\">" << std::endl;
         writer.incInd();
         saveCenter(writer, center);
         writer.decInd();
@@ -327,11 +292,89 @@ void Toolpath::Save (Writer &writer) const
     writer.Stream() << writer.ind() << "</Path>" << std::endl;
 }
 
+namespace {
+const char ToolpathMagic[4] = {'F','C','T','P'};
+const uint32_t ToolpathVersion = 1;
+
+void writeString(std::ostream& out, Base::OutputStream& str, const std::string& s)
+{
+    str << static_cast<uint32_t>(s.size());
+    out.write(s.c_str(), s.size());
+}
+
+// The string is read in chunks, so that a corrupt length cannot cause a huge allocation
+std::string readString(std::istream& in, Base::InputStream& str)
+{
+    uint32_t len = 0;
+    str >> len;
+    std::string s;
+    char buffer[4096];
+    while (len > 0 && in) {
+        in.read(buffer, std::min<uint32_t>(len, sizeof(buffer)));
+        s.append(buffer, static_cast<std::size_t>(in.gcount()));
+        len -= static_cast<uint32_t>(in.gcount());
+    }
+    if (!in)
+        throw Base::BadFormatError("Unexpected end of toolpath file");
+    return s;
+}
+}
+
 void Toolpath::SaveDocFile (Base::Writer &writer) const
 {
-    if (toGCode().empty())
+    if (!useBinaryFormat()) {
+        std::string gcode = toGCode();
+        if (gcode.empty())
+            return;
+        writer.Stream() << gcode;
         return;
-    writer.Stream() << toGCode();
+    }
+
+    // Binary format: the command names are stored once in a table and each
+    // command refers to it, the single-letter words are stored as bitmask
+    // followed by their values
+    std::ostream& out = writer.Stream();
+    out.write(ToolpathMagic, sizeof(ToolpathMagic));
+    Base::OutputStream str(out);
+    str << ToolpathVersion;
+
+    std::map<std::string, uint32_t> names;
+    std::vector<uint32_t> indices;
+    indices.reserve(vpcCommands.size());
+    for (std::vector<Command*>::const_iterator it = vpcCommands.begin(); it != vpcCommands.end(); ++it) {
+        std::map<std::string, uint32_t>::iterator jt = names.insert
+            (std::make_pair((*it)->Name, static_cast<uint32_t>(names.size()))).first;
+        indices.push_back(jt->second);
+    }
+
+    std::vector<const std::string*> table(names.size());
+    for (std::map<std::string, uint32_t>::iterator it = names.begin(); it != names.end(); ++it)
+        table[it->second] = &it->first;
+    str << static_cast<uint32_t>(table.size());
+    for (std::vector<const std::string*>::iterator it = table.begin(); it != table.end(); ++it)
+        writeString(out, str, **it);
+
+    str << static_cast<uint32_t>(vpcCommands.size());
+    for (std::size_t i = 0; i < vpcCommands.size(); i++) {
+        const CommandParameters& params = vpcCommands[i]->Parameters;
+        str << indices[i] << params.getLetterMask();
+        for (int index = 0; index < CommandParameters::NumLetters; index++) {
+            if (params.hasLetter(index))
+                str << params.getLetter(index);
+        }
+
+        uint32_t others = static_cast<uint32_t>(params.size()) - static_cast<uint32_t>(
+            std::count_if(params.begin(), params.end(), [](const CommandParameters::value_type& v) {
+                return CommandParameters::letterIndex(v.first) >= 0;
+            }));
+        str << others;
+        for (CommandParameters::const_iterator it = params.begin(); it != params.end(); ++it) {
+            if (CommandParameters::letterIndex(it->first) < 0) {
+                writeString(out, str, it->first);
+                str << it->second;
+            }
+        }
+    }
 }
 
 void Toolpath::Restore(XMLReader &reader)
@@ -347,17 +390,72 @@ void Toolpath::Restore(XMLReader &reader)
 
 void Toolpath::RestoreDocFile(Base::Reader &reader)
 {
-    std::string gcode;
-    std::string line;
-    while (reader >> line) {
-        gcode += line;
-        gcode += " ";
+    Base::FileInfo fi(reader.getFileName());
+    if (fi.hasExtension("bin")) {
+        restoreBinary(reader);
+        return;
     }
-    setFromGCode(gcode);
 
+    setFromGCode(reader);
 }
 
+void Toolpath::restoreBinary(std::istream& in)
+{
+    clear();
 
+    // an empty file is an empty path
+    if (in.peek() == std::char_traits<char>::eof())
+        return;
 
+    char magic[4];
+    in.read(magic, sizeof(magic));
+    if (!in || memcmp(magic, ToolpathMagic, sizeof(magic)) != 0)
+        throw Base::BadFormatError("Stream does not contain a toolpath");
+
+    Base::InputStream str(in);
+    uint32_t version = 0;
+    str >> version;
+    if (version > ToolpathVersion)
+        throw Base::BadFormatError("Unsupported toolpath version");
+
+    uint32_t count = 0;
+    str >> count;
+    // the counts are not trusted, the vectors grow with the data actually read
+    std::vector<std::string> names;
+    names.reserve(std::min<uint32_t>(count, 1024));
+    for (uint32_t i = 0; i < count; i++)
+        names.push_back(readString(in, str));
+
+    str >> count;
+    vpcCommands.reserve(std::min<uint32_t>(count, 65536));
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t name = 0, mask = 0, others = 0;
+        str >> name >> mask;
+        if (name >= names.size())
+            throw Base::BadFormatError("Invalid command in toolpath");
+
+        Command* cmd = new Command();
+        vpcCommands.push_back(cmd);
+        cmd->Name = names[name];
+        for (int index = 0; index < CommandParameters::NumLetters; index++) {
+            if (mask & (1u << index)) {
+                double value;
+                str >> value;
+                cmd->Parameters.setLetter(index, value);
+            }
+        }
 
+        str >> others;
+        for (uint32_t j = 0; j < others; j++) {
+            std::string key = readString(in, str);
+            double value;
+            str >> value;
+            cmd->Parameters[key] = value;
+        }
+
+        if (!in)
+            throw Base::BadFormatError("Unexpected end of toolpath file");
+    }
 
+    recalculate();
+}
@@ -52,6 +52,7 @@ namespace Path
             virtual void Restore(Base::XMLReader &/*reader*/);
             void SaveDocFile (Base::Writer &writer) const;
             void RestoreDocFile(Base::Reader &reader);
+            void restoreBinary(std::istream&); // reads the binary format written by SaveDocFile
         
             // interface
             void clear(void); // clears the internal data
@@ -61,6 +62,7 @@ namespace Path
             double getLength(void); // return the Length (mm) of the Path
             void recalculate(void); // recalculates the points
             void setFromGCode(const std::string); // sets the path from the contents of the given GCode string
+            void setFromGCode(std::istream&); // same as above but reads the GCode from a stream
             std::string toGCode(void) const; // gets a gcode string representation from the Path
             
             // shortcut functions
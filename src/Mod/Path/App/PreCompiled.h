@@ -42,6 +42,8 @@
 #ifdef _PreComp_
 
 // standard
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <stdio.h>
@@ -24,6 +24,8 @@
 
 import FreeCAD
 import Path
+import os
+import tempfile
 from PathTests.PathTestUtils import PathTestBase
 
 class TestPathCore(PathTestBase):
@@ -155,3 +157,64 @@ G0 Z0.500000
 
         self.assertEqual(len(table.Tools), 2)
         self.assertEqual(str(table.Tools), '{1: Tool 12.7mm Drill Bit, 2: Tool my other tool}' )
+
+    def test30(self):
+        """Test saving and restoring a path in the binary format"""
+        c1 = Path.Command("G1", {"X": 1.0, "Y": -2.5, "Z": 1.0 / 3.0, "F": 300})
+        c2 = Path.Command("(a comment)")
+        c3 = Path.Command("M6", {"T": 2, "XX": 4.5})
+        self.assertEqual(c3.Parameters, {"T": 2.0, "XX": 4.5})
+        c3.Parameters = {"AB": 1}
+        self.assertEqual(list(c3.Parameters.keys()), ["AB", "T", "XX"])
+
+        grp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Path")
+        binary = grp.GetBool("BinaryToolpath", False)
+        name = os.path.join(tempfile.gettempdir(), "PathBinary.FCStd")
+        try:
+            for mode in (True, False):
+                grp.SetBool("BinaryToolpath", mode)
+                # the G-code text cannot represent multi-letter words
+                cmds = [c1, c2, c3] if mode else [c1]
+                doc = FreeCAD.newDocument("PathBinary")
+                obj = doc.addObject("Path::Feature", "Path")
+                obj.Path = Path.Path(cmds)
+                doc.saveAs(name)
+                FreeCAD.closeDocument(doc.Name)
+
+                doc = FreeCAD.openDocument(name)
+                restored = doc.Path.Path.Commands
+                self.assertEqual(len(restored), len(cmds))
+                if mode:
+                    # no rounding in the binary format
+                    for c, r in zip(cmds, restored):
+                        self.assertEqual(c.Name, r.Name)
+                        self.assertEqual(c.Parameters, r.Parameters)
+                else:
+                    self.assertCommandEqual(restored[0], c1)
+                FreeCAD.closeDocument(doc.Name)
+        finally:
+            grp.SetBool("BinaryToolpath", binary)
+            if os.path.exists(name):
+                os.remove(name)
+
+    def test40(self):
+        """Test reading G-code with modal units from a file"""
+        gcode = "N10 g20 G1 X1 Y-0.5\n(comment G1)\nG21 G1 X1 F100\nM3 S1000\n"
+        p = Path.Path(gcode)
+        self.assertEqual([c.Name for c in p.Commands], ["G1", "(comment G1)", "G1", "M3"])
+        self.assertRoughly(p.Commands[0].X, 25.4)
+        self.assertRoughly(p.Commands[0].Y, -12.7)
+        self.assertRoughly(p.Commands[2].X, 1.0)
+        self.assertRoughly(p.Commands[3].S, 1000.0)
+
+        name = os.path.join(tempfile.gettempdir(), "PathRead.ngc")
+        with open(name, "w") as f:
+            f.write(gcode * 1000)
+        try:
+            doc = FreeCAD.newDocument("PathRead")
+            Path.read(name, doc.Name)
+            self.assertEqual(len(doc.Objects), 1)
+            self.assertEqual(len(doc.Objects[0].Path.Commands), 4000)
+            FreeCAD.closeDocument(doc.Name)
+        finally:
+            os.remove(name)
@@ -45,6 +45,7 @@
 #include "PointsAlgos.h"
 #include "Structured.h"
 #include "Properties.h"
+#include "Processing.h"
 
 namespace Points {
 class Module : public Py::ExtensionModule<Module>
@@ -52,25 +53,63 @@ class Module : public Py::ExtensionModule<Module>
 public:
     Module() : Py::ExtensionModule<Module>("Points")
     {
-        add_varargs_method("open",&Module::open
+        add_keyword_method("open",&Module::open,
+            "open(filename,[fields,decimation=1]) -- Create a new document and load the points into it.\n"
+            "fields is a list of the optional fields to read, i.e. 'Normal', 'Color' and 'Intensity',\n"
+            "by default all fields are read. Only every decimation-th point of the file is read."
         );
-        add_varargs_method("insert",&Module::importer
+        add_keyword_method("insert",&Module::importer,
+            "insert(filename,docname,[fields,decimation=1]) -- Load the points into the given document.\n"
+            "fields and decimation are the same as for open()."
         );
         add_varargs_method("export",&Module::exporter
         );
         add_varargs_method("show",&Module::show,
             "show(points,[string]) -- Add the points to the active document or create one if no document exists."
         );
+        add_varargs_method("estimateNormals",&Module::estimateNormals,
+            "estimateNormals(feature,[int=10,bool=True]) -- Estimate the normals of the points of a feature from\n"
+            "their k nearest neighbours and set them to its Normal property, which is added if needed.\n"
+            "If the last argument is True the normals get a consistent orientation."
+        );
         initialize("This module is the Points module."); // register with Python
     }
 
     virtual ~Module() {}
 
 private:
-    Py::Object open(const Py::Tuple& args)
+    /// Applies the fields and decimation arguments of open() and insert() to \a reader
+    void setupReader(Reader& reader, PyObject* fields, int decimation)
+    {
+        if (fields) {
+            int readFields = 0;
+            Py::Sequence list(fields);
+            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                std::string field = static_cast<std::string>(Py::String(*it));
+                if (field == "Normal")
+                    readFields |= Reader::Normals;
+                else if (field == "Color")
+                    readFields |= Reader::Colors;
+                else if (field == "Intensity")
+                    readFields |= Reader::Intensities;
+                else
+                    throw Py::ValueError("Unknown field '" + field + "'");
+            }
+            reader.setFields(readFields);
+        }
+        if (decimation < 1)
+            throw Py::ValueError("Decimation must be positive");
+        reader.setDecimation(static_cast<std::size_t>(decimation));
+    }
+
+    Py::Object open(const Py::Tuple& args, const Py::Dict& kwds)
     {
         char* Name;
-        if (!PyArg_ParseTuple(args.ptr(), "et","utf-8",&Name))
+        PyObject* fields = 0;
+        int decimation = 1;
+        static char* kwds_open[] = {"filename", "fields", "decimation", NULL};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "et|Oi", kwds_open,
+                                         "utf-8", &Name, &fields, &decimation))
             throw Py::Exception();
         std::string EncodedName = std::string(Name);
         PyMem_Free(Name);
@@ -97,6 +136,7 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            setupReader(*reader, fields, decimation);
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().newDocument("Unnamed");
@@ -178,11 +218,15 @@ private:
         return Py::None();
     }
 
-    Py::Object importer(const Py::Tuple& args)
+    Py::Object importer(const Py::Tuple& args, const Py::Dict& kwds)
     {
         char* Name;
         const char* DocName;
-        if (!PyArg_ParseTuple(args.ptr(), "ets","utf-8",&Name,&DocName))
+        PyObject* fields = 0;
+        int decimation = 1;
+        static char* kwds_insert[] = {"filename", "docname", "fields", "decimation", NULL};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "ets|Oi", kwds_insert,
+                                         "utf-8", &Name, &DocName, &fields, &decimation))
             throw Py::Exception();
         std::string EncodedName = std::string(Name);
         PyMem_Free(Name);
@@ -209,6 +253,7 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            setupReader(*reader, fields, decimation);
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().getDocument(DocName);
@@ -392,6 +437,43 @@ private:
 
         return Py::None();
     }
+
+    Py::Object estimateNormals(const Py::Tuple& args)
+    {
+        PyObject *pcObj;
+        int ksearch = 10;
+        PyObject *orient = Py_True;
+        if (!PyArg_ParseTuple(args.ptr(), "O!|iO!", &(App::DocumentObjectPy::Type), &pcObj,
+                              &ksearch, &PyBool_Type, &orient))
+            throw Py::Exception();
+
+        App::DocumentObject* obj = static_cast<App::DocumentObjectPy*>(pcObj)->getDocumentObjectPtr();
+        Points::Feature* pcFeature = dynamic_cast<Points::Feature*>(obj);
+        if (!pcFeature)
+            throw Py::TypeError("Points feature expected");
+
+        try {
+            App::Property* prop = pcFeature->getPropertyByName("Normal");
+            if (prop && !prop->getTypeId().isDerivedFrom(Points::PropertyNormalList::getClassTypeId()))
+                throw Py::TypeError("Normal property is not a Points::PropertyNormalList");
+
+            // the normals refer to the local coordinate system like the points of the feature
+            std::vector<Base::Vector3f> normals;
+            NormalEstimation estimate(pcFeature->Points.getValue());
+            estimate.setKSearch(ksearch);
+            estimate.setOrientation(PyObject_IsTrue(orient) ? true : false);
+            estimate.perform(normals);
+
+            if (!prop)
+                prop = pcFeature->addDynamicProperty("Points::PropertyNormalList", "Normal");
+            static_cast<Points::PropertyNormalList*>(prop)->setValues(normals);
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        return Py::None();
+    }
 };
 
 PyObject* initModule()
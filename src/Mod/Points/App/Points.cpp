@@ -214,6 +214,12 @@ void PointKernel::RestoreDocFile(Base::Reader &reader)
     }
 }
 
+bool PointKernel::hasConcurrentDocFile() const
+{
+    // only plain binary data which is independent of any other object
+    return true;
+}
+
 void PointKernel::save(const char* file) const
 {
     Base::ofstream out(file, std::ios::out);
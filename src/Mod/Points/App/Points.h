@@ -102,6 +102,7 @@ public:
     void SaveDocFile (Base::Writer &writer) const;
     void Restore(Base::XMLReader &reader);
     void RestoreDocFile(Base::Reader &reader);
+    bool hasConcurrentDocFile() const;
     void save(const char* file) const;
     void save(std::ostream&) const;
     void load(const char* file);
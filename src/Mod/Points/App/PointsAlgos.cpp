@@ -26,6 +26,8 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <algorithm>
+# include <cstring>
 # include <sstream>
 #endif
 
@@ -37,84 +39,539 @@
 #include <Base/Exception.h>
 #include <Base/FileInfo.h>
 #include <Base/Console.h>
-#include <Base/Sequencer.h>
 #include <Base/Stream.h>
+#include <Base/Tools.h>
 
 #include <boost/shared_ptr.hpp>
-#include <boost/regex.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <QFile>
+#include <QtConcurrentMap>
 
 using namespace Points;
 
-void PointsAlgos::Load(PointKernel &points, const char *FileName)
+namespace {
+
+typedef std::pair<std::size_t, std::size_t> Range;
+typedef std::pair<const char*, const char*> Token;
+
+/// Maps a file into memory, or reads it if it cannot be mapped
+class MappedFile
 {
-    Base::FileInfo File(FileName);
+public:
+    explicit MappedFile(const std::string& filename)
+      : file(QString::fromUtf8(filename.c_str()))
+      , data(0)
+      , size(0)
+    {
+        if (!file.open(QIODevice::ReadOnly))
+            throw Base::FileException("Cannot open file", filename.c_str());
+        size = static_cast<std::size_t>(file.size());
+        if (size > 0) {
+            data = reinterpret_cast<const char*>(file.map(0, file.size()));
+            if (!data) {
+                buffer.resize(size);
+                if (file.read(&buffer[0], file.size()) != file.size())
+                    throw Base::FileException("Cannot read file", filename.c_str());
+                data = &buffer[0];
+            }
+        }
+    }
+    const char* begin() const {
+        return data;
+    }
+    const char* end() const {
+        return data + size;
+    }
+    std::size_t length() const {
+        return size;
+    }
 
-    // checking on the file
-    if (!File.isReadable())
-        throw Base::FileException("File to load not existing or not readable", FileName);
+private:
+    QFile file;
+    const char* data;
+    std::size_t size;
+    std::vector<char> buffer;
+};
 
-    if (File.hasExtension("asc"))
-        LoadAscii(points,FileName);
-    else
-        throw Base::RuntimeError("Unknown ending");
+enum ValueType {
+    NoValue, Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+};
+
+/// Where the values of a field are found in a file body
+struct Column {
+    ValueType type;
+    std::size_t offset; // byte offset of the value of the first point
+    std::size_t stride; // bytes between the values of two points
+    std::size_t token;  // index of the value in a line of text
+
+    Column() : type(NoValue), offset(0), stride(0), token(0) {
+    }
+};
+
+/// The fields that are read, a field without a value type is not read
+struct PointLayout {
+    Column x, y, z;
+    Column nx, ny, nz;
+    Column intensity;
+    Column red, green, blue, alpha;
+    Column rgba; // packed colour
+    float colorRange; // value of the full intensity of a colour component
+    std::size_t tokens; // number of tokens of a line of text that are needed
+
+    PointLayout() : colorRange(1.0f), tokens(0) {
+    }
+    /// Sets the number of tokens from the fields that are read
+    void countTokens() {
+        const Column* columns[] = {&x, &y, &z, &nx, &ny, &nz, &intensity,
+                                   &red, &green, &blue, &alpha, &rgba};
+        tokens = 0;
+        for (std::size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++) {
+            if (columns[i]->type != NoValue)
+                tokens = std::max(tokens, columns[i]->token + 1);
+        }
+    }
+};
+
+/// The arrays that get the values of the points
+struct PointTarget {
+    std::vector<Base::Vector3f>* points;
+    std::vector<Base::Vector3f>* normals;
+    std::vector<float>* intensity;
+    std::vector<App::Color>* colors;
+
+    explicit PointTarget(std::vector<Base::Vector3f>& pts)
+        : points(&pts), normals(0), intensity(0), colors(0) {
+    }
+    void resize(std::size_t count) {
+        points->resize(count);
+        if (normals)
+            normals->resize(count);
+        if (intensity)
+            intensity->resize(count);
+        if (colors)
+            colors->resize(count);
+    }
+};
+
+ValueType plyValueType(const std::string& t)
+{
+    if (t == "char" || t == "int8")
+        return Int8;
+    if (t == "uchar" || t == "uint8")
+        return UInt8;
+    if (t == "short" || t == "int16")
+        return Int16;
+    if (t == "ushort" || t == "uint16")
+        return UInt16;
+    if (t == "int" || t == "int32")
+        return Int32;
+    if (t == "uint" || t == "uint32")
+        return UInt32;
+    if (t == "float" || t == "float32")
+        return Float32;
+    if (t == "double" || t == "float64")
+        return Float64;
+    return NoValue;
 }
 
-void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName)
+ValueType pcdValueType(const std::string& t, int size)
 {
-    boost::regex rx("^\\s*([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)"
-                     "\\s+([-+]?[0-9]*)\\.?([0-9]+([eE][-+]?[0-9]+)?)\\s*$");
-    //boost::regex rx("(\\b[0-9]+\\.([0-9]+\\b)?|\\.[0-9]+\\b)");
-    //boost::regex rx("^\\s*(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s+(-?[0-9]*)\\.([0-9]+)\\s*$");
-    boost::cmatch what;
+    char c = t.empty() ? 0 : t[0];
+    switch (size) {
+    case 1:
+        return c == 'I' ? Int8 : c == 'U' ? UInt8 : NoValue;
+    case 2:
+        return c == 'I' ? Int16 : c == 'U' ? UInt16 : NoValue;
+    case 4:
+        return c == 'I' ? Int32 : c == 'U' ? UInt32 : c == 'F' ? Float32 : NoValue;
+    case 8:
+        return c == 'F' ? Float64 : NoValue;
+    default:
+        return NoValue;
+    }
+}
 
-    Base::Vector3d pt;
-    int LineCnt=0;
-    std::string line;
-    Base::FileInfo fi(FileName);
+Column fieldColumn(const std::vector<Column>& columns, std::size_t index)
+{
+    if (columns[index].type == NoValue)
+        throw Base::BadFormatError("Unexpected type");
+    return columns[index];
+}
 
-    Base::ifstream tmp_str(fi, std::ios::in);
+inline bool isLittleEndian()
+{
+    const uint16_t value = 1;
+    return *reinterpret_cast<const unsigned char*>(&value) == 1;
+}
 
-    // estimating size
-    while (std::getline(tmp_str,line))
-        LineCnt++;
+template <typename T>
+inline T readValue(const char* ptr, bool swapByteOrder)
+{
+    T value;
+    if (swapByteOrder) {
+        char bytes[sizeof(T)];
+        std::reverse_copy(ptr, ptr + sizeof(T), bytes);
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+    else {
+        std::memcpy(&value, ptr, sizeof(T));
+    }
+    return value;
+}
 
-    // resize the PointKernel
-    points.resize(LineCnt);
+/// Reads the values of a point from a binary body
+struct BinarySource {
+    const char* body;
+    std::size_t index;
+    bool swapByteOrder;
+
+    BinarySource(const char* data, std::size_t i, bool swap)
+        : body(data), index(i), swapByteOrder(swap) {
+    }
+    double value(const Column& col) const {
+        const char* ptr = body + col.offset + index * col.stride;
+        switch (col.type) {
+        case Int8:
+            return readValue<int8_t>(ptr, false);
+        case UInt8:
+            return readValue<uint8_t>(ptr, false);
+        case Int16:
+            return readValue<int16_t>(ptr, swapByteOrder);
+        case UInt16:
+            return readValue<uint16_t>(ptr, swapByteOrder);
+        case Int32:
+            return readValue<int32_t>(ptr, swapByteOrder);
+        case UInt32:
+            return readValue<uint32_t>(ptr, swapByteOrder);
+        case Float32:
+            return readValue<float>(ptr, swapByteOrder);
+        case Float64:
+            return readValue<double>(ptr, swapByteOrder);
+        default:
+            return 0;
+        }
+    }
+    uint32_t packed(const Column& col) const {
+        // the bits of a packed colour, also if it's stored as float
+        if (col.type == UInt32 || col.type == Float32)
+            return readValue<uint32_t>(body + col.offset + index * col.stride, swapByteOrder);
+        return static_cast<uint32_t>(value(col));
+    }
+};
 
-    Base::SequencerLauncher seq( "Loading points...", LineCnt );
+// A token is only a number if it's converted completely
+inline bool parseNumber(const char* begin, const char* end, double& value)
+{
+    return begin != end && Base::Tools::parseDouble(begin, end, value) == end;
+}
 
-    // again to the beginning
-    Base::ifstream file(fi, std::ios::in);
-    LineCnt = 0;
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    try {
-        // read file
-        while (std::getline(file, line)) {
-            if (boost::regex_match(line.c_str(), what, rx)) {
-                pt.x = std::atof(what[1].first);
-                pt.y = std::atof(what[4].first);
-                pt.z = std::atof(what[7].first);
+// Splits a line into its blank separated tokens, at most 'count'
+void splitTokens(const char* begin, const char* end, std::size_t count, std::vector<Token>& tokens)
+{
+    tokens.clear();
+    const char* p = begin;
+    while (p != end && tokens.size() < count) {
+        while (p != end && isBlank(*p))
+            ++p;
+        const char* start = p;
+        while (p != end && !isBlank(*p))
+            ++p;
+        if (start != p)
+            tokens.push_back(Token(start, p));
+    }
+}
 
-                points.setPoint(LineCnt,pt);
-                seq.next();
-                LineCnt++;
-            }
+/// Reads the values of a point from a line of text
+struct TextSource {
+    const std::vector<Token>& tokens;
+    bool& failed;
+
+    TextSource(const std::vector<Token>& t, bool& f)
+        : tokens(t), failed(f) {
+    }
+    double value(const Column& col) const {
+        double v = 0;
+        if (col.token >= tokens.size() ||
+            !parseNumber(tokens[col.token].first, tokens[col.token].second, v))
+            failed = true;
+        return v;
+    }
+    uint32_t packed(const Column& col) const {
+        // the bits of a packed colour, also if it's written as float
+        if (col.type == Float32) {
+            float f = static_cast<float>(value(col));
+            uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return bits;
         }
+        return static_cast<uint32_t>(value(col));
     }
-    catch (...) {
-        points.clear();
-        throw Base::BadFormatError("Reading in points failed.");
+};
+
+template <class Source>
+void transferPoint(const PointLayout& layout, const Source& src, std::size_t index,
+                   Base::Vector3f* points, Base::Vector3f* normals,
+                   float* intensity, App::Color* colors)
+{
+    points[index].Set(static_cast<float>(src.value(layout.x)),
+                      static_cast<float>(src.value(layout.y)),
+                      static_cast<float>(src.value(layout.z)));
+    if (normals) {
+        normals[index].Set(static_cast<float>(src.value(layout.nx)),
+                           static_cast<float>(src.value(layout.ny)),
+                           static_cast<float>(src.value(layout.nz)));
+    }
+    if (intensity) {
+        intensity[index] = static_cast<float>(src.value(layout.intensity));
+    }
+    if (colors) {
+        if (layout.rgba.type != NoValue) {
+            uint32_t packed = src.packed(layout.rgba);
+            uint32_t a = (packed >> 24) & 0xff;
+            uint32_t r = (packed >> 16) & 0xff;
+            uint32_t g = (packed >> 8) & 0xff;
+            uint32_t b = packed & 0xff;
+            colors[index] = App::Color(static_cast<float>(r)/255.0f,
+                                       static_cast<float>(g)/255.0f,
+                                       static_cast<float>(b)/255.0f,
+                                       static_cast<float>(a)/255.0f);
+        }
+        else {
+            float a = 1.0f;
+            if (layout.alpha.type != NoValue)
+                a = static_cast<float>(src.value(layout.alpha));
+            colors[index] = App::Color(static_cast<float>(src.value(layout.red)) / layout.colorRange,
+                                       static_cast<float>(src.value(layout.green)) / layout.colorRange,
+                                       static_cast<float>(src.value(layout.blue)) / layout.colorRange,
+                                       a / layout.colorRange);
+        }
     }
+}
 
-    // now remove the last points from the kernel
-    // Note: first we allocate memory corresponding to the number of lines (points and comments)
-    //       and read in the file twice. But then the size of the kernel is too high
-    if (LineCnt < (int)points.size())
-        points.erase(LineCnt, points.size());
+template <typename T>
+inline T* dataOf(std::vector<T>* values)
+{
+    return values && !values->empty() ? &(*values)[0] : 0;
+}
+
+// Reads every step-th of the points of a binary body in parallel chunks
+void readBinaryBody(const char* body, std::size_t numPoints, std::size_t step, bool swapByteOrder,
+                    const PointLayout& layout, PointTarget& target)
+{
+    std::size_t count = (numPoints + step - 1) / step;
+    target.resize(count);
+
+    Base::Vector3f* points = dataOf(target.points);
+    Base::Vector3f* normals = dataOf(target.normals);
+    float* intensity = dataOf(target.intensity);
+    App::Color* colors = dataOf(target.colors);
+
+    std::vector<Range> ranges;
+    for (std::size_t i = 0; i < count; i += 65536)
+        ranges.push_back(Range(i, std::min(count, i + 65536)));
+    QtConcurrent::blockingMap(ranges, [&](Range& range) {
+        for (std::size_t i = range.first; i < range.second; i++) {
+            BinarySource src(body, i * step, swapByteOrder);
+            transferPoint(layout, src, i, points, normals, intensity, colors);
+        }
+    });
+}
+
+/// A part of a text body that ends at a line break
+struct TextChunk {
+    const char* begin;
+    const char* end;
+    std::size_t lines; // number of lines that are not blank
+    std::size_t first; // index of the first of these lines in the body
+    bool failed;
+};
+
+std::vector<TextChunk> splitText(const char* begin, const char* end)
+{
+    const std::size_t size = 4 * 1024 * 1024;
+    std::vector<TextChunk> chunks;
+    while (begin < end) {
+        const char* stop = end;
+        if (static_cast<std::size_t>(end - begin) > size) {
+            stop = static_cast<const char*>(std::memchr(begin + size, '\n', (end - begin) - size));
+            stop = stop ? stop + 1 : end;
+        }
+        TextChunk chunk = {begin, stop, 0, 0, false};
+        chunks.push_back(chunk);
+        begin = stop;
+    }
+    return chunks;
+}
+
+// Calls func(begin, end) for every line of [begin, end) that is not blank,
+// without leading and trailing blanks
+template <typename Func>
+void forEachLine(const char* begin, const char* end, Func func)
+{
+    while (begin < end) {
+        const char* stop = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (!stop)
+            stop = end;
+        const char* first = begin;
+        const char* last = stop;
+        while (first < last && isBlank(*first))
+            ++first;
+        while (last > first && isBlank(*(last - 1)))
+            --last;
+        if (first < last)
+            func(first, last);
+        begin = stop < end ? stop + 1 : end;
+    }
+}
+
+// Reads every step-th of the points of a text body in parallel chunks. The lines
+// are counted first so that every chunk knows where its points go. 'skip' lines
+// of other elements come before the points.
+void readTextBody(const char* begin, const char* end, std::size_t skip,
+                  std::size_t numPoints, std::size_t step,
+                  const PointLayout& layout, PointTarget& target)
+{
+    std::vector<TextChunk> chunks = splitText(begin, end);
+    QtConcurrent::blockingMap(chunks, [](TextChunk& chunk) {
+        std::size_t lines = 0;
+        forEachLine(chunk.begin, chunk.end, [&lines](const char*, const char*) {
+            lines++;
+        });
+        chunk.lines = lines;
+    });
+
+    std::size_t lines = 0;
+    for (std::vector<TextChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        it->first = lines;
+        lines += it->lines;
+    }
+
+    std::size_t rows = lines > skip ? std::min(numPoints, lines - skip) : 0;
+    std::size_t count = (rows + step - 1) / step;
+    target.resize(count);
+
+    Base::Vector3f* points = dataOf(target.points);
+    Base::Vector3f* normals = dataOf(target.normals);
+    float* intensity = dataOf(target.intensity);
+    App::Color* colors = dataOf(target.colors);
+
+    QtConcurrent::blockingMap(chunks, [&](TextChunk& chunk) {
+        std::vector<Token> tokens;
+        std::size_t line = chunk.first;
+        bool failed = false;
+        forEachLine(chunk.begin, chunk.end, [&](const char* first, const char* last) {
+            std::size_t index = line++;
+            if (index < skip)
+                return;
+            std::size_t row = index - skip;
+            if (row >= rows || row % step != 0)
+                return;
+            splitTokens(first, last, layout.tokens, tokens);
+            TextSource src(tokens, failed);
+            transferPoint(layout, src, row / step, points, normals, intensity, colors);
+        });
+        chunk.failed = failed;
+    });
+
+    for (std::vector<TextChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        if (it->failed)
+            throw Base::BadFormatError("Invalid number in point data");
+    }
+}
+
+// Parses a line of three numbers
+bool parseAsciiPoint(const char* begin, const char* end, std::vector<Token>& tokens, Base::Vector3f& point)
+{
+    splitTokens(begin, end, 4, tokens);
+    double x, y, z;
+    if (tokens.size() != 3 ||
+        !parseNumber(tokens[0].first, tokens[0].second, x) ||
+        !parseNumber(tokens[1].first, tokens[1].second, y) ||
+        !parseNumber(tokens[2].first, tokens[2].second, z))
+        return false;
+    point.Set(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+    return true;
+}
+
+// Reads every step-th of the lines with three numbers, other lines are ignored.
+// The valid lines are counted first so that every chunk knows where its points go.
+void readAsciiPoints(const char* begin, const char* end, std::size_t step,
+                     std::vector<Base::Vector3f>& points)
+{
+    std::vector<TextChunk> chunks = splitText(begin, end);
+    QtConcurrent::blockingMap(chunks, [](TextChunk& chunk) {
+        std::vector<Token> tokens;
+        Base::Vector3f point;
+        std::size_t lines = 0;
+        forEachLine(chunk.begin, chunk.end, [&](const char* first, const char* last) {
+            if (parseAsciiPoint(first, last, tokens, point))
+                lines++;
+        });
+        chunk.lines = lines;
+    });
+
+    std::size_t lines = 0;
+    for (std::vector<TextChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        it->first = lines;
+        lines += it->lines;
+    }
+
+    points.resize((lines + step - 1) / step);
+    QtConcurrent::blockingMap(chunks, [&](TextChunk& chunk) {
+        std::vector<Token> tokens;
+        Base::Vector3f point;
+        std::size_t line = chunk.first;
+        forEachLine(chunk.begin, chunk.end, [&](const char* first, const char* last) {
+            if (parseAsciiPoint(first, last, tokens, point)) {
+                if (line % step == 0)
+                    points[line / step] = point;
+                line++;
+            }
+        });
+    });
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+void PointsAlgos::Load(PointKernel &points, const char *FileName)
+{
+    Base::FileInfo File(FileName);
+
+    // checking on the file
+    if (!File.isReadable())
+        throw Base::FileException("File to load not existing or not readable", FileName);
+
+    if (File.hasExtension("asc"))
+        LoadAscii(points,FileName);
+    else
+        throw Base::RuntimeError("Unknown ending");
+}
+
+void PointsAlgos::LoadAscii(PointKernel &points, const char *FileName)
+{
+    MappedFile file(FileName);
+    std::vector<PointKernel::value_type> pts;
+    readAsciiPoints(file.begin(), file.end(), 1, pts);
+
+    // the file contains the points in the outer coordinate system of the kernel
+    Base::Matrix4D mat = points.getTransform();
+    if (mat != Base::Matrix4D()) {
+        mat.inverse();
+        for (std::vector<PointKernel::value_type>::iterator it = pts.begin(); it != pts.end(); ++it) {
+            Base::Vector3d pt = mat * Base::Vector3d(it->x, it->y, it->z);
+            it->Set(static_cast<float>(pt.x), static_cast<float>(pt.y), static_cast<float>(pt.z));
+        }
+    }
+    points.swap(pts);
 }
 
 // ----------------------------------------------------------------------------
@@ -123,6 +580,8 @@ Reader::Reader()
 {
     width = 0;
     height = 0;
+    readFields = AllFields;
+    decimation = 1;
 }
 
 Reader::~Reader()
@@ -136,6 +595,16 @@ void Reader::clear()
     normals.clear();
 }
 
+void Reader::setFields(int f)
+{
+    readFields = f;
+}
+
+void Reader::setDecimation(std::size_t step)
+{
+    decimation = std::max<std::size_t>(step, 1);
+}
+
 const PointKernel& Reader::getPoints() const
 {
     return points;
@@ -203,7 +672,8 @@ AscReader::~AscReader()
 
 void AscReader::read(const std::string& filename)
 {
-    points.load(filename.c_str());
+    MappedFile file(filename);
+    readAsciiPoints(file.begin(), file.end(), decimation, points.getBasicPoints());
 }
 
 // ----------------------------------------------------------------------------
@@ -214,7 +684,6 @@ public:
     virtual ~Converter() {
     }
     virtual std::string toString(float) const = 0;
-    virtual double toDouble(Base::InputStream&) const = 0;
     virtual int getSizeOf() const = 0;
 };
 template <typename T>
@@ -228,11 +697,6 @@ public:
         oss << c;
         return oss.str();
     }
-    virtual double toDouble(Base::InputStream& str) const {
-        T c;
-        str >> c;
-        return static_cast<double>(c);
-    }
     virtual int getSizeOf() const {
         return sizeof(T);
     }
@@ -240,73 +704,6 @@ public:
 
 typedef boost::shared_ptr<Converter> ConverterPtr;
 
-class DataStreambuf : public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data) : _buffer(data) {
-        _beg = 0;
-        _end = data.size();
-        _cur = 0;
-    }
-    ~DataStreambuf() {
-    }
-
-protected:
-    virtual int_type uflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    virtual int_type underflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    virtual int_type pbackfail(int_type ch) {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur-1]))
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    virtual std::streamsize showmanyc() {
-        return _end - _cur;
-    }
-    virtual pos_type seekoff(std::streambuf::off_type off,
-        std::ios_base::seekdir way,
-        std::ios_base::openmode = 
-            std::ios::in | std::ios::out) {
-        int p_pos=-1;
-        if (way == std::ios_base::beg)
-            p_pos = _beg;
-        else if (way == std::ios_base::end)
-            p_pos = _end;
-        else if (way == std::ios_base::cur)
-            p_pos = _cur;
-
-        if (p_pos > _end)
-            return traits_type::eof();
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg))
-            return traits_type::eof();
-
-        _cur = p_pos+ off;
-
-        return ((p_pos+off) - _beg);
-    }
-    virtual pos_type seekpos(std::streambuf::pos_type pos,
-        std::ios_base::openmode which =
-        std::ios::in | std::ios::out) {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg, _end, _cur;
-};
-
 //Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int 
 lzfDecompress (const void *const in_data,  unsigned int in_len,
@@ -516,17 +913,10 @@ void PlyReader::read(const std::string& filename)
     std::vector<int> sizes;
     std::size_t offset = 0;
     std::size_t numPoints = readHeader(inp, format, offset, fields, types, sizes);
-
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, offset, data);
-    }
-    else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
-    }
-    else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
-    }
+    std::streamoff header = inp.tellg();
+    if (header < 0)
+        throw Base::BadFormatError("Not a valid ply file");
+    inp.close();
 
     std::vector<std::string>::iterator it;
     std::size_t max_size = std::numeric_limits<std::size_t>::max();
@@ -602,54 +992,67 @@ void PlyReader::read(const std::string& filename)
     bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
     bool hasIntensity = (greyvalue != max_size);
     bool hasColor = (red != max_size && green != max_size && blue != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
-
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
+    if (!hasData)
+        return;
+
+    // position of the fields in a binary record or a line of text
+    std::vector<Column> columns(fields.size());
+    std::size_t recordSize = 0;
+    for (std::size_t i=0; i<fields.size(); i++) {
+        columns[i].type = plyValueType(types[i]);
+        columns[i].offset = recordSize;
+        columns[i].token = i;
+        recordSize += sizes[i];
+    }
+    for (std::size_t i=0; i<fields.size(); i++) {
+        columns[i].stride = recordSize;
+    }
+
+    // only the selected fields are parsed and go directly into the final arrays
+    PointLayout layout;
+    PointTarget target(points.getBasicPoints());
+    layout.x = fieldColumn(columns, x);
+    layout.y = fieldColumn(columns, y);
+    layout.z = fieldColumn(columns, z);
+
+    if (hasNormal && (readFields & Normals)) {
+        layout.nx = fieldColumn(columns, normal_x);
+        layout.ny = fieldColumn(columns, normal_y);
+        layout.nz = fieldColumn(columns, normal_z);
+        target.normals = &normals;
+    }
+
+    if (hasIntensity && (readFields & Intensities)) {
+        layout.intensity = fieldColumn(columns, greyvalue);
+        target.intensity = &intensity;
+    }
+
+    if (hasColor && (readFields & Colors)) {
+        if (columns[red].type == UInt8 || columns[red].type == Float32) {
+            layout.red = fieldColumn(columns, red);
+            layout.green = fieldColumn(columns, green);
+            layout.blue = fieldColumn(columns, blue);
+            if (alpha != max_size)
+                layout.alpha = fieldColumn(columns, alpha);
+            layout.colorRange = (columns[red].type == UInt8 ? 255.0f : 1.0f);
+            target.colors = &colors;
         }
     }
+    layout.countTokens();
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
+    MappedFile file(filename);
+    if (static_cast<std::size_t>(header) > file.length())
+        throw Base::BadFormatError("Not a valid ply file");
+    const char* body = file.begin() + header;
+    std::size_t available = file.length() - static_cast<std::size_t>(header);
+    if (format == "ascii") {
+        readTextBody(body, file.end(), offset, numPoints, decimation, layout, target);
     }
-
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
-        else if (types[red] == "float") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(r, g, b, a));
-            }
-        }
+    else {
+        if (offset > available || recordSize * numPoints > available - offset)
+            throw Base::BadFormatError("File expects too many elements");
+        bool bigEndian = (format == "binary_big_endian");
+        readBinaryBody(body + offset, numPoints, decimation, bigEndian == isLittleEndian(), layout, target);
     }
 }
 
@@ -821,121 +1224,6 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PlyReader::readBinary(bool swapByteOrder,
-                           std::istream& inp,
-                           std::size_t offset,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        std::string t = types[j];
-        switch (sizes[j]) {
-        case 1:
-            if (t == "char" || t == "int8")
-                converters.push_back(convert_int8);
-            else if (t == "uchar" || t == "uint8")
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == "short" || t == "int16")
-                converters.push_back(convert_int16);
-            else if (t == "ushort" || t == "uint16")
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == "int" || t == "int32")
-                converters.push_back(convert_int32);
-            else if (t == "uint" || t == "uint32")
-                converters.push_back(convert_uint32);
-            else if (t == "float" || t == "float32")
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == "double" || t == "float64")
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (std::size_t i=0; i<numPoints; i++) {
-        for (std::size_t j=0; j<numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 PcdReader::PcdReader()
@@ -959,33 +1247,12 @@ void PcdReader::read(const std::string& filename)
     std::vector<std::string> fields;
     std::vector<std::string> types;
     std::vector<int> sizes;
-    std::size_t numPoints = readHeader(inp, format, fields, types, sizes);
-
-    Eigen::MatrixXd data(numPoints, fields.size());
-    if (format == "ascii") {
-        readAscii(inp, data);
-    }
-    else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
-    }
-    else if (format == "binary_compressed") {
-        unsigned int c, u;
-        Base::InputStream str(inp);
-        str >> c >> u;
-
-        std::vector<char> compressed(c);
-        inp.read(&compressed[0], c);
-        std::vector<char> uncompressed(u);
-        if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(0);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
-        }
-        else {
-            throw Base::BadFormatError("Failed to decompress binary data");
-        }
-    }
+    std::vector<int> counts;
+    std::size_t numPoints = readHeader(inp, format, fields, types, sizes, counts);
+    std::streamoff header = inp.tellg();
+    if (header < 0)
+        throw Base::BadFormatError("Not a valid pcd file");
+    inp.close();
 
     std::vector<std::string>::iterator it;
     std::size_t max_size = std::numeric_limits<std::size_t>::max();
@@ -1051,63 +1318,88 @@ void PcdReader::read(const std::string& filename)
     bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
     bool hasIntensity = (greyvalue != max_size);
     bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
+    if (!hasData)
+        return;
+
+    // position of the fields in a binary record or a line of text, the
+    // compressed format stores all values of a field one after another
+    bool compressed = (format == "binary_compressed");
+    std::vector<Column> columns(fields.size());
+    std::size_t recordSize = 0;
+    std::size_t token = 0;
+    for (std::size_t i=0; i<fields.size(); i++) {
+        std::size_t size = static_cast<std::size_t>(sizes[i]) * static_cast<std::size_t>(counts[i]);
+        columns[i].type = pcdValueType(types[i], sizes[i]);
+        columns[i].offset = compressed ? recordSize * numPoints : recordSize;
+        columns[i].stride = size;
+        columns[i].token = token;
+        recordSize += size;
+        token += counts[i];
+    }
+    if (!compressed) {
+        for (std::size_t i=0; i<fields.size(); i++) {
+            columns[i].stride = recordSize;
         }
     }
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
-        }
+    // only the selected fields are parsed and go directly into the final arrays
+    PointLayout layout;
+    PointTarget target(points.getBasicPoints());
+    layout.x = fieldColumn(columns, x);
+    layout.y = fieldColumn(columns, y);
+    layout.z = fieldColumn(columns, z);
+
+    if (hasNormal && (readFields & Normals)) {
+        layout.nx = fieldColumn(columns, normal_x);
+        layout.ny = fieldColumn(columns, normal_y);
+        layout.nz = fieldColumn(columns, normal_z);
+        target.normals = &normals;
     }
 
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
+    if (hasIntensity && (readFields & Intensities)) {
+        layout.intensity = fieldColumn(columns, greyvalue);
+        target.intensity = &intensity;
     }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i,rgba));
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
+    if (hasColor && (readFields & Colors)) {
+        if (types[rgba] == "U" || types[rgba] == "F") {
+            layout.rgba = fieldColumn(columns, rgba);
+            target.colors = &colors;
         }
-        else if (types[rgba] == "F") {
-            union RGBA {
-                uint32_t u;
-                float f;
-            };
+    }
+    layout.countTokens();
 
-            union RGBA v;
-            for (std::size_t i=0; i<numPoints; i++) {
-                v.f = static_cast<float>(data(i,rgba));
-                uint32_t packed = v.u;
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
+    MappedFile file(filename);
+    if (static_cast<std::size_t>(header) > file.length())
+        throw Base::BadFormatError("Not a valid pcd file");
+    const char* body = file.begin() + header;
+    std::size_t available = file.length() - static_cast<std::size_t>(header);
+    if (format == "ascii") {
+        readTextBody(body, file.end(), 0, numPoints, decimation, layout, target);
+    }
+    else if (format == "binary") {
+        if (recordSize * numPoints > available)
+            throw Base::BadFormatError("File expects too many elements");
+        readBinaryBody(body, numPoints, decimation, !isLittleEndian(), layout, target);
+    }
+    else if (format == "binary_compressed") {
+        if (available < 8)
+            throw Base::BadFormatError("File expects too many elements");
+        uint32_t c = readValue<uint32_t>(body, !isLittleEndian());
+        uint32_t u = readValue<uint32_t>(body + 4, !isLittleEndian());
+        if (c > available - 8)
+            throw Base::BadFormatError("File expects too many elements");
+
+        std::vector<char> uncompressed(u);
+        if (u < recordSize * numPoints || (u > 0 && lzfDecompress(body + 8, c, &uncompressed[0], u) != u))
+            throw Base::BadFormatError("Failed to decompress binary data");
+        readBinaryBody(uncompressed.data(), numPoints, decimation, !isLittleEndian(), layout, target);
+    }
+
+    // a decimated cloud is not structured any more
+    if (decimation > 1) {
+        this->width = static_cast<int>(points.size());
+        this->height = 1;
     }
 }
 
@@ -1115,10 +1407,10 @@ std::size_t PcdReader::readHeader(std::istream& in,
                                   std::string& format,
                                   std::vector<std::string>& fields,
                                   std::vector<std::string>& types,
-                                  std::vector<int>& sizes)
+                                  std::vector<int>& sizes,
+                                  std::vector<int>& counts)
 {
     std::string line;
-    std::vector<std::string> counts;
     std::vector<std::string> list;
     std::size_t points = 0;
 
@@ -1152,7 +1444,10 @@ std::size_t PcdReader::readHeader(std::istream& in,
         }
         else if (kw == "COUNT") {
             for (std::size_t i=1; i<list.size(); i++) {
-                counts.push_back(list[i]);
+                int count = boost::lexical_cast<int>(list[i]);
+                if (count < 1)
+                    throw Base::BadFormatError("Not a valid pcd file");
+                counts.push_back(count);
             }
         }
         else if (kw == "WIDTH") {
@@ -1183,124 +1478,6 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PcdReader::readBinary(bool transpose,
-                           std::istream& inp,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-        case 1:
-            if (t == 'I')
-                converters.push_back(convert_int8);
-            else if (t == 'U')
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == 'I')
-                converters.push_back(convert_int16);
-            else if (t == 'U')
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == 'I')
-                converters.push_back(convert_int32);
-            else if (t == 'U')
-                converters.push_back(convert_uint32);
-            else if (t == 'F')
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == 'F')
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    if (transpose) {
-        for (std::size_t j=0; j<numFields; j++) {
-            for (std::size_t i=0; i<numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-    else {
-        for (std::size_t i=0; i<numPoints; i++) {
-            for (std::size_t j=0; j<numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 Writer::Writer(const PointKernel& p) : points(p)
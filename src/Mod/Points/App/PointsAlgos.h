@@ -47,10 +47,22 @@ public:
 class Reader
 {
 public:
+    /// Optional fields of a point cloud, the coordinates are always read
+    enum Field {
+        Normals     = 1,
+        Colors      = 2,
+        Intensities = 4,
+        AllFields   = Normals | Colors | Intensities
+    };
+
     Reader();
     virtual ~Reader();
     virtual void read(const std::string& filename) = 0;
 
+    /// Selects the optional fields to read, the default is AllFields
+    void setFields(int);
+    /// Keeps only every \a step-th point of the file
+    void setDecimation(std::size_t step);
     void clear();
     const PointKernel& getPoints() const;
     bool hasProperties() const;
@@ -70,6 +82,8 @@ protected:
     std::vector<App::Color> colors;
     std::vector<Base::Vector3f> normals;
     int width, height;
+    int readFields;
+    std::size_t decimation;
 };
 
 class AscReader : public Reader
@@ -91,11 +105,6 @@ private:
     std::size_t readHeader(std::istream&, std::string& format, std::size_t& offset,
         std::vector<std::string>& fields, std::vector<std::string>& types,
         std::vector<int>& sizes);
-    void readAscii(std::istream&, std::size_t offset, Eigen::MatrixXd& data);
-    void readBinary(bool swapByteOrder, std::istream&, std::size_t offset,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
 };
 
 class PcdReader : public Reader
@@ -107,12 +116,7 @@ public:
 
 private:
     std::size_t readHeader(std::istream&, std::string& format, std::vector<std::string>& fields,
-        std::vector<std::string>& types, std::vector<int>& sizes);
-    void readAscii(std::istream&, Eigen::MatrixXd& data);
-    void readBinary(bool transpose, std::istream&,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+        std::vector<std::string>& types, std::vector<int>& sizes, std::vector<int>& counts);
 };
 
 class Writer
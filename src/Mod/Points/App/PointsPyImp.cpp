@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 
 #include "Mod/Points/App/Points.h"
+#include "Mod/Points/App/Processing.h"
 #include <Base/Builder3D.h>
 #include <Base/VectorPy.h>
 #include <Base/GeometryPyCXX.h>
@@ -227,6 +228,109 @@ PyObject* PointsPy::fromValid(PyObject * args)
     }
 }
 
+PyObject* PointsPy::filterVoxelGrid(PyObject *args, PyObject *kwds)
+{
+    double dimX = 0;
+    double dimY = 0;
+    double dimZ = 0;
+    static char* keywords_voxel[] = {"DimX","DimY","DimZ",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "d|dd", keywords_voxel,
+                                     &dimX, &dimY, &dimZ))
+        return 0;
+
+    if (dimY == 0)
+        dimY = dimX;
+    if (dimZ == 0)
+        dimZ = dimX;
+
+    PY_TRY {
+        std::unique_ptr<PointKernel> pts(new PointKernel());
+        VoxelGridFilter filter(*getPointKernelPtr());
+        filter.setLeafSize(dimX, dimY, dimZ);
+        filter.perform(*pts);
+        return new PointsPy(pts.release());
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::estimateNormals(PyObject *args, PyObject *kwds)
+{
+    int ksearch = 10;
+    PyObject* orient = Py_True;
+    static char* keywords_normals[] = {"KSearch","Orient",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iO!", keywords_normals,
+                                     &ksearch, &PyBool_Type, &orient))
+        return 0;
+
+    PY_TRY {
+        const PointKernel* points = getPointKernelPtr();
+        std::vector<Base::Vector3f> normals;
+        NormalEstimation estimate(*points);
+        estimate.setKSearch(ksearch);
+        estimate.setOrientation(PyObject_IsTrue(orient) ? true : false);
+        estimate.perform(normals);
+
+        // the normals refer to the local coordinate system of the points, they are
+        // transformed with the inverse transpose to stay normal under any scaling
+        Base::Matrix4D mat = points->getTransform();
+        mat[0][3] = mat[1][3] = mat[2][3] = 0;
+        mat.inverseGauss();
+        mat.transpose();
+        Py::List list;
+        for (std::vector<Base::Vector3f>::iterator it = normals.begin(); it != normals.end(); ++it) {
+            Base::Vector3d normal = mat * Base::Vector3d(it->x, it->y, it->z);
+            if (normal.Length() > 0)
+                normal.Normalize();
+            list.append(Py::Vector(normal));
+        }
+
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::findOutliers(PyObject *args, PyObject *kwds)
+{
+    int ksearch = 8;
+    double stddev = 1.0;
+    static char* keywords_outliers[] = {"KSearch","StdDevMul",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|id", keywords_outliers,
+                                     &ksearch, &stddev))
+        return 0;
+
+    PY_TRY {
+        std::vector<unsigned long> outliers;
+        OutlierRemoval filter(*getPointKernelPtr());
+        filter.setKSearch(ksearch);
+        filter.setStdDevMultiplier(stddev);
+        filter.perform(outliers);
+
+        Py::List list;
+        for (std::vector<unsigned long>::iterator it = outliers.begin(); it != outliers.end(); ++it)
+            list.append(Py::Long(*it));
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
+PyObject* PointsPy::findDuplicates(PyObject *args, PyObject *kwds)
+{
+    double tolerance = 0.0;
+    static char* keywords_duplicates[] = {"Tolerance",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|d", keywords_duplicates,
+                                     &tolerance))
+        return 0;
+
+    PY_TRY {
+        std::vector<unsigned long> duplicates;
+        DuplicateRemoval filter(*getPointKernelPtr());
+        filter.setTolerance(tolerance);
+        filter.perform(duplicates);
+
+        Py::List list;
+        for (std::vector<unsigned long>::iterator it = duplicates.begin(); it != duplicates.end(); ++it)
+            list.append(Py::Long(*it));
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+}
+
 Py::Long PointsPy::getCountPoints(void) const
 {
     return Py::Long((long)getPointKernelPtr()->size());
@@ -0,0 +1,282 @@
+#   (c) The FreeCAD project 2020      LGPL
+
+import FreeCAD, os, unittest, struct, math
+import Points
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD Points module
+#---------------------------------------------------------------------------
+
+def makeGrid(num, z=0.0):
+    return [(float(x), float(y), z) for y in range(num) for x in range(num)]
+
+def makeSphere(num, radius):
+    # evenly distributed points on a sphere around the origin
+    pts = []
+    golden = math.pi * (3.0 - math.sqrt(5.0))
+    for i in range(num):
+        z = 1.0 - 2.0 * (i + 0.5) / num
+        r = math.sqrt(1.0 - z * z)
+        pts.append((radius * r * math.cos(golden * i), radius * r * math.sin(golden * i), radius * z))
+    return pts
+
+
+class PointsProcessingCases(unittest.TestCase):
+    def testVoxelGrid(self):
+        pts = Points.Points(makeGrid(10))
+        voxel = pts.filterVoxelGrid(2.0)
+        self.assertEqual(voxel.CountPoints, 25)
+        first = voxel.Points[0]
+        self.assertAlmostEqual(first.x, 0.5)
+        self.assertAlmostEqual(first.y, 0.5)
+        self.assertAlmostEqual(first.z, 0.0)
+
+    def testNormalsOfPlane(self):
+        pts = Points.Points(makeGrid(10))
+        normals = pts.estimateNormals(KSearch=8)
+        self.assertEqual(len(normals), 100)
+        for n in normals:
+            self.assertAlmostEqual(abs(n.z), 1.0, 5)
+        # the orientation is consistent
+        self.assertTrue(all(n.z > 0 for n in normals) or all(n.z < 0 for n in normals))
+
+    def testNormalsOfSphere(self):
+        pts = Points.Points(makeSphere(500, 10.0))
+        normals = pts.estimateNormals(KSearch=10, Orient=True)
+        for p, n in zip(pts.Points, normals):
+            self.assertGreater(n.dot(p) / p.Length, 0.95)
+
+    def testNormalsOfScaledPoints(self):
+        # the plane z = x scaled by 2 along the x axis is the plane z = x/2
+        pts = Points.Points([(x, y, x) for x, y, z in makeGrid(10)])
+        mat = FreeCAD.Matrix()
+        mat.scale(2.0, 1.0, 1.0)
+        pts.Matrix = mat
+        direction = FreeCAD.Vector(2, 0, 1).normalize()
+        for n in pts.estimateNormals(Orient=False):
+            self.assertAlmostEqual(n.Length, 1.0, 5)
+            self.assertAlmostEqual(n.dot(direction), 0.0, 5)
+
+    def testNormalProperty(self):
+        doc = FreeCAD.newDocument("PointsNormals")
+        try:
+            feature = doc.addObject("Points::Feature", "Points")
+            feature.Points = Points.Points(makeGrid(10))
+            Points.estimateNormals(feature, 8)
+            self.assertEqual(len(feature.Normal), 100)
+            for n in feature.Normal:
+                self.assertAlmostEqual(abs(n.z), 1.0, 5)
+        finally:
+            FreeCAD.closeDocument(doc.Name)
+
+    def testOutlier(self):
+        grid = makeGrid(10)
+        grid.append((4.5, 4.5, 50.0))
+        pts = Points.Points(grid)
+        self.assertEqual(pts.findOutliers(KSearch=8, StdDevMul=1.0), [100])
+
+    def testDuplicates(self):
+        pts = Points.Points([(0, 0, 0), (0, 0, 0), (1, 0, 0), (1.05, 0, 0), (3, 0, 0), (3, 0, 0)])
+        self.assertEqual(pts.findDuplicates(), [1, 5])
+        self.assertEqual(pts.findDuplicates(Tolerance=0.1), [1, 3, 5])
+
+
+def splitFile(filename, end):
+    # header lines up to and including the line starting with 'end' and the data lines
+    with open(filename) as f:
+        lines = f.read().splitlines()
+    index = [i for i, line in enumerate(lines) if line.startswith(end)][0] + 1
+    return lines[:index], [line for line in lines[index:] if line.strip()]
+
+def lzfLiterals(data):
+    # a valid LZF stream that only consists of literal runs of up to 32 bytes
+    out = bytearray()
+    for i in range(0, len(data), 32):
+        chunk = data[i:i + 32]
+        out.append(len(chunk) - 1)
+        out += chunk
+    return bytes(out)
+
+def plyToBinary(filename):
+    header, data = splitFile(filename, "end_header")
+    codes = {"float": "f", "uchar": "B"}
+    fmt = "<" + "".join(codes[line.split()[1]] for line in header if line.startswith("property"))
+    header = ["format binary_little_endian 1.0" if line.startswith("format") else line for line in header]
+    with open(filename, "wb") as f:
+        f.write(("\n".join(header) + "\n").encode("ascii"))
+        for line in data:
+            f.write(struct.pack(fmt, *[float(v) if c == "f" else int(v) for c, v in zip(fmt[1:], line.split())]))
+
+def pcdToBinary(filename, compressed=False):
+    header, data = splitFile(filename, "DATA")
+    types = [line.split()[1:] for line in header if line.startswith("TYPE")][0]
+    codes = ["f" if t == "F" else "I" for t in types]
+    rows = [[float(v) if c == "f" else int(v) for c, v in zip(codes, line.split())] for line in data]
+    if compressed:
+        # all values of a field one after another
+        body = b"".join(struct.pack("<" + c * len(rows), *[r[i] for r in rows]) for i, c in enumerate(codes))
+        packed = lzfLiterals(body)
+        body = struct.pack("<II", len(packed), len(body)) + packed
+        header[-1] = "DATA binary_compressed"
+    else:
+        body = b"".join(struct.pack("<" + "".join(codes), *r) for r in rows)
+        header[-1] = "DATA binary"
+    with open(filename, "wb") as f:
+        f.write(("\n".join(header) + "\n").encode("ascii"))
+        f.write(body)
+
+
+class PointsIOCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PointsIOTest")
+        self.grid = makeGrid(10)
+        self.normals = [(0.6, 0.0, 0.8) if i % 2 else (0.0, 0.8, -0.6) for i in range(len(self.grid))]
+        self.colors = [((i % 5) / 4.0, (i % 3) / 2.0, 1.0) for i in range(len(self.grid))]
+        self.intensities = [i * 0.25 for i in range(len(self.grid))]
+        feature = self.Doc.addObject("Points::Feature", "Cloud")
+        feature.Points = Points.Points(self.grid)
+        feature.addProperty("Points::PropertyNormalList", "Normal")
+        feature.addProperty("App::PropertyColorList", "Color")
+        feature.addProperty("Points::PropertyGreyValueList", "Intensity")
+        feature.Normal = self.normals
+        feature.Color = self.colors
+        feature.Intensity = self.intensities
+        self.feature = feature
+
+    def exportCloud(self, suffix):
+        fileName = os.path.join(FreeCAD.getTempPath(), "PointsIOCloud" + suffix)
+        Points.export([self.feature], fileName)
+        return fileName
+
+    def insertCloud(self, fileName, **kwds):
+        count = len(self.Doc.Objects)
+        Points.insert(fileName, self.Doc.Name, **kwds)
+        self.assertEqual(len(self.Doc.Objects), count + 1)
+        return self.Doc.Objects[-1]
+
+    def checkCloud(self, cloud, step=1, fields=("Normal", "Color", "Intensity")):
+        indices = range(0, len(self.grid), step)
+        pts = cloud.Points.Points
+        self.assertEqual(len(pts), len(indices))
+        for p, i in zip(pts, indices):
+            self.assertAlmostEqual((p - FreeCAD.Vector(self.grid[i])).Length, 0.0, 5)
+        for name in ("Normal", "Color", "Intensity"):
+            self.assertEqual(name in cloud.PropertiesList, name in fields)
+        if "Normal" in fields:
+            for n, i in zip(cloud.Normal, indices):
+                self.assertAlmostEqual((n - FreeCAD.Vector(self.normals[i])).Length, 0.0, 5)
+        if "Color" in fields:
+            for c, i in zip(cloud.Color, indices):
+                for a, b in zip(c[:3], self.colors[i]):
+                    self.assertAlmostEqual(a, b, 2)
+        if "Intensity" in fields:
+            for v, i in zip(cloud.Intensity, indices):
+                self.assertAlmostEqual(v, self.intensities[i], 5)
+
+    def testPlyAscii(self):
+        fileName = self.exportCloud(".ply")
+        self.checkCloud(self.insertCloud(fileName))
+
+    def testPlyBinary(self):
+        fileName = self.exportCloud(".ply")
+        plyToBinary(fileName)
+        self.checkCloud(self.insertCloud(fileName))
+        self.checkCloud(self.insertCloud(fileName, decimation=3), step=3)
+
+    def testPcdAscii(self):
+        fileName = self.exportCloud(".pcd")
+        self.checkCloud(self.insertCloud(fileName))
+
+    def testPcdBinary(self):
+        fileName = self.exportCloud(".pcd")
+        pcdToBinary(fileName)
+        self.checkCloud(self.insertCloud(fileName))
+        self.checkCloud(self.insertCloud(fileName, decimation=3), step=3)
+
+    def testPcdBinaryCompressed(self):
+        fileName = self.exportCloud(".pcd")
+        pcdToBinary(fileName, compressed=True)
+        self.checkCloud(self.insertCloud(fileName))
+        self.checkCloud(self.insertCloud(fileName, decimation=3), step=3)
+
+    def testDecimation(self):
+        for suffix in (".ply", ".pcd"):
+            fileName = self.exportCloud(suffix)
+            self.checkCloud(self.insertCloud(fileName, decimation=3), step=3)
+            self.checkCloud(self.insertCloud(fileName, decimation=200), step=200)
+            with self.assertRaises(ValueError):
+                Points.insert(fileName, self.Doc.Name, decimation=0)
+
+    def testFields(self):
+        fileName = self.exportCloud(".pcd")
+        self.checkCloud(self.insertCloud(fileName, fields=["Normal"]), fields=["Normal"])
+        self.checkCloud(self.insertCloud(fileName, fields=["Color", "Intensity"]), fields=["Color", "Intensity"])
+        cloud = self.insertCloud(fileName, fields=[])
+        self.assertEqual(cloud.TypeId, "Points::Feature")
+        self.checkCloud(cloud, fields=[])
+        with self.assertRaises(ValueError):
+            Points.insert(fileName, self.Doc.Name, fields=["Curvature"])
+
+    def testOpen(self):
+        fileName = self.exportCloud(".ply")
+        Points.open(fileName, fields=["Intensity"], decimation=2)
+        doc = FreeCAD.ActiveDocument
+        try:
+            self.assertNotEqual(doc.Name, self.Doc.Name)
+            self.checkCloud(doc.Objects[-1], step=2, fields=["Intensity"])
+        finally:
+            FreeCAD.closeDocument(doc.Name)
+
+    def testBlankLines(self):
+        for suffix, end in ((".ply", "end_header"), (".pcd", "DATA")):
+            fileName = self.exportCloud(suffix)
+            header, data = splitFile(fileName, end)
+            # blank lines in the header, DOS line ends and indented data lines
+            with open(fileName, "w", newline="\r\n") as f:
+                f.write(header[0] + "\n\n" + "\n".join(header[1:]) + "\n")
+                for line in data:
+                    f.write("\n  " + line + "\t\n")
+                f.write("\n\n")
+            self.checkCloud(self.insertCloud(fileName))
+
+    def testBadFormat(self):
+        fileName = self.exportCloud(".ply")
+        header, data = splitFile(fileName, "end_header")
+        with open(fileName, "w") as f:
+            f.write("\n".join(["format ascii 2.0" if line.startswith("format") else line for line in header] + data))
+        with self.assertRaises(RuntimeError):
+            Points.insert(fileName, self.Doc.Name)
+
+        # more points than data
+        fileName = self.exportCloud(".ply")
+        plyToBinary(fileName)
+        with open(fileName, "rb") as f:
+            content = f.read()
+        with open(fileName, "wb") as f:
+            f.write(content[:-10])
+        with self.assertRaises(RuntimeError):
+            Points.insert(fileName, self.Doc.Name)
+
+        # the number of points doesn't match the size
+        fileName = self.exportCloud(".pcd")
+        header, data = splitFile(fileName, "DATA")
+        with open(fileName, "w") as f:
+            f.write("\n".join(["POINTS 99" if line.startswith("POINTS") else line for line in header] + data))
+        with self.assertRaises(RuntimeError):
+            Points.insert(fileName, self.Doc.Name)
+
+        # an invalid number in the data
+        fileName = self.exportCloud(".pcd")
+        header, data = splitFile(fileName, "DATA")
+        data[5] = data[5].replace(" ", " x", 1)
+        with open(fileName, "w") as f:
+            f.write("\n".join(header + data))
+        with self.assertRaises(RuntimeError):
+            Points.insert(fileName, self.Doc.Name)
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
+        for suffix in (".ply", ".pcd"):
+            fileName = os.path.join(FreeCAD.getTempPath(), "PointsIOCloud" + suffix)
+            if os.path.exists(fileName):
+                os.remove(fileName)
@@ -45,6 +45,8 @@
 // standard
 #include <stdio.h>
 #include <assert.h>
+#include <clocale>
+#include <cstring>
 
 // STL
 #include <algorithm>
@@ -57,6 +59,7 @@
 #include <sstream>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <bitset>
 #include <float.h>
@@ -0,0 +1,714 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <limits>
+# include <unordered_map>
+#endif
+
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <Eigen/Eigenvalues>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <Base/BoundBox.h>
+#include <Base/Exception.h>
+
+#include "Processing.h"
+
+using namespace Points;
+
+namespace {
+
+// Minimum number of points of a sub-range of the k-d tree that gets split
+const unsigned long LeafSize = 8;
+
+typedef std::pair<std::size_t, std::size_t> Range;
+
+inline bool isValid(const Base::Vector3f& p)
+{
+    return !(boost::math::isnan(p.x) ||
+             boost::math::isnan(p.y) ||
+             boost::math::isnan(p.z));
+}
+
+std::vector<Range> makeRanges(std::size_t count, std::size_t chunk)
+{
+    std::vector<Range> ranges;
+    ranges.reserve(count / chunk + 1);
+    for (std::size_t i = 0; i < count; i += chunk)
+        ranges.push_back(Range(i, std::min(count, i + chunk)));
+    return ranges;
+}
+
+// Calls func(begin, end) for consecutive chunks of [0, count), concurrently if
+// there is more than one chunk. The chunks don't depend on the number of threads.
+template <typename Func>
+void forEachRange(std::size_t count, std::size_t chunk, const Func& func)
+{
+    std::vector<Range> ranges = makeRanges(count, chunk);
+    if (ranges.size() > 1 && QThread::idealThreadCount() > 1) {
+        QtConcurrent::blockingMap(ranges, [&func](Range& range) {
+            func(range.first, range.second);
+        });
+    }
+    else {
+        for (std::vector<Range>::iterator it = ranges.begin(); it != ranges.end(); ++it)
+            func(it->first, it->second);
+    }
+}
+
+struct VoxelCell {
+    double x, y, z;
+    double nx, ny, nz;
+    unsigned long count;
+
+    VoxelCell() : x(0), y(0), z(0), nx(0), ny(0), nz(0), count(0) {
+    }
+};
+
+typedef std::unordered_map<uint64_t, VoxelCell> VoxelCellMap;
+
+struct VoxelChunk {
+    std::size_t begin, end;
+    VoxelCellMap cells;
+};
+
+void voxelize(const PointKernel& kernel, double leafX, double leafY, double leafZ,
+              const std::vector<Base::Vector3f>* normals,
+              std::vector<PointKernel::value_type>& resultPoints,
+              std::vector<Base::Vector3f>* resultNormals)
+{
+    if (leafX <= 0 || leafY <= 0 || leafZ <= 0)
+        throw Base::ValueError("Leaf size must be positive");
+
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    if (normals && normals->size() != points.size())
+        throw Base::ValueError("Number of normals doesn't match the number of points");
+
+    Base::BoundBox3d box;
+    for (std::vector<PointKernel::value_type>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        if (isValid(*it))
+            box.Add(Base::Vector3d(it->x, it->y, it->z));
+    }
+    if (!box.IsValid())
+        return;
+
+    double cellsX = std::floor(box.LengthX() / leafX) + 1;
+    double cellsY = std::floor(box.LengthY() / leafY) + 1;
+    double cellsZ = std::floor(box.LengthZ() / leafZ) + 1;
+    if (cellsX * cellsY * cellsZ >= 9.2e18)
+        throw Base::ValueError("Leaf size is too small");
+    uint64_t numX = static_cast<uint64_t>(cellsX);
+    uint64_t numY = static_cast<uint64_t>(cellsY);
+    uint64_t numZ = static_cast<uint64_t>(cellsZ);
+
+    // Accumulate a batch of chunks concurrently and merge them in order, so that
+    // the memory stays bounded and the sums don't depend on the number of threads
+    const std::size_t chunkSize = 65536;
+    std::size_t batchSize = 4 * static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    std::vector<Range> ranges = makeRanges(points.size(), chunkSize);
+
+    VoxelCellMap cells;
+    for (std::size_t batch = 0; batch < ranges.size(); batch += batchSize) {
+        std::vector<VoxelChunk> chunks(std::min(batchSize, ranges.size() - batch));
+        for (std::size_t i = 0; i < chunks.size(); i++) {
+            chunks[i].begin = ranges[batch + i].first;
+            chunks[i].end = ranges[batch + i].second;
+        }
+
+        QtConcurrent::blockingMap(chunks, [&](VoxelChunk& chunk) {
+            for (std::size_t i = chunk.begin; i < chunk.end; i++) {
+                const PointKernel::value_type& p = points[i];
+                if (!isValid(p))
+                    continue;
+                uint64_t ix = std::min<uint64_t>(static_cast<uint64_t>((p.x - box.MinX) / leafX), numX - 1);
+                uint64_t iy = std::min<uint64_t>(static_cast<uint64_t>((p.y - box.MinY) / leafY), numY - 1);
+                uint64_t iz = std::min<uint64_t>(static_cast<uint64_t>((p.z - box.MinZ) / leafZ), numZ - 1);
+                VoxelCell& cell = chunk.cells[ix + numX * (iy + numY * iz)];
+                cell.x += p.x;
+                cell.y += p.y;
+                cell.z += p.z;
+                if (normals) {
+                    const Base::Vector3f& n = (*normals)[i];
+                    cell.nx += n.x;
+                    cell.ny += n.y;
+                    cell.nz += n.z;
+                }
+                cell.count++;
+            }
+        });
+
+        for (std::vector<VoxelChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            for (VoxelCellMap::iterator jt = it->cells.begin(); jt != it->cells.end(); ++jt) {
+                VoxelCell& cell = cells[jt->first];
+                cell.x += jt->second.x;
+                cell.y += jt->second.y;
+                cell.z += jt->second.z;
+                cell.nx += jt->second.nx;
+                cell.ny += jt->second.ny;
+                cell.nz += jt->second.nz;
+                cell.count += jt->second.count;
+            }
+        }
+    }
+
+    std::vector<uint64_t> keys;
+    keys.reserve(cells.size());
+    for (VoxelCellMap::iterator it = cells.begin(); it != cells.end(); ++it)
+        keys.push_back(it->first);
+    std::sort(keys.begin(), keys.end());
+
+    resultPoints.reserve(keys.size());
+    if (resultNormals)
+        resultNormals->reserve(keys.size());
+    for (std::vector<uint64_t>::iterator it = keys.begin(); it != keys.end(); ++it) {
+        const VoxelCell& cell = cells[*it];
+        double count = static_cast<double>(cell.count);
+        resultPoints.push_back(PointKernel::value_type(static_cast<float>(cell.x / count),
+                                                       static_cast<float>(cell.y / count),
+                                                       static_cast<float>(cell.z / count)));
+        if (resultNormals) {
+            Base::Vector3f normal(static_cast<float>(cell.nx),
+                                  static_cast<float>(cell.ny),
+                                  static_cast<float>(cell.nz));
+            if (normal.Length() > 0)
+                normal.Normalize();
+            resultNormals->push_back(normal);
+        }
+    }
+}
+
+/// marks an unused entry of the neighbour lists kept for the orientation
+const unsigned int NoNeighbour = std::numeric_limits<unsigned int>::max();
+
+/** A min-heap of point indices ordered by their cost, whose cost can be lowered.
+ * Unlike a std::priority_queue of edges every point is queued at most once,
+ * so the memory is bound by the number of points.
+ */
+class OrientQueue
+{
+public:
+    OrientQueue(std::size_t size)
+      : position(size, NotQueued), cost(size, 0) {
+    }
+    bool empty() const {
+        return heap.empty();
+    }
+    bool contains(unsigned long index) const {
+        return position[index] != NotQueued;
+    }
+    float getCost(unsigned long index) const {
+        return cost[index];
+    }
+    /// Adds \a index or lowers its cost
+    void push(unsigned long index, float c) {
+        if (position[index] == NotQueued) {
+            position[index] = heap.size();
+            heap.push_back(index);
+        }
+        cost[index] = c;
+        siftUp(position[index]);
+    }
+    /// Removes and returns the index with the lowest cost
+    unsigned long pop() {
+        unsigned long top = heap.front();
+        position[top] = NotQueued;
+        unsigned long last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            position[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    // ties are broken by the index to get the same result on every platform
+    bool less(unsigned long a, unsigned long b) const {
+        if (cost[a] != cost[b])
+            return cost[a] < cost[b];
+        return a < b;
+    }
+    void siftUp(std::size_t pos) {
+        unsigned long index = heap[pos];
+        while (pos > 0) {
+            std::size_t parent = (pos - 1) / 2;
+            if (!less(index, heap[parent]))
+                break;
+            heap[pos] = heap[parent];
+            position[heap[pos]] = pos;
+            pos = parent;
+        }
+        heap[pos] = index;
+        position[index] = pos;
+    }
+    void siftDown(std::size_t pos) {
+        unsigned long index = heap[pos];
+        std::size_t size = heap.size();
+        for (;;) {
+            std::size_t child = 2 * pos + 1;
+            if (child >= size)
+                break;
+            if (child + 1 < size && less(heap[child + 1], heap[child]))
+                child++;
+            if (!less(heap[child], index))
+                break;
+            heap[pos] = heap[child];
+            position[heap[pos]] = pos;
+            pos = child;
+        }
+        heap[pos] = index;
+        position[index] = pos;
+    }
+
+private:
+    static const std::size_t NotQueued = static_cast<std::size_t>(-1);
+    std::vector<unsigned long> heap;
+    std::vector<std::size_t> position;
+    std::vector<float> cost;
+};
+
+}
+
+// ----------------------------------------------------------------------------
+
+PointKdTree::PointKdTree(const std::vector<value_type>& points)
+  : _points(points)
+{
+    _index.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (isValid(points[i]))
+            _index.push_back(static_cast<unsigned long>(i));
+    }
+    _axis.resize(_index.size());
+
+    // split the upper levels and build the remaining sub-trees concurrently
+    int levels = 0;
+    int threads = std::max(1, QThread::idealThreadCount());
+    while ((1 << levels) < 4 * threads && levels < 16)
+        levels++;
+    std::vector<std::pair<unsigned long, unsigned long> > subtrees;
+    split(0, static_cast<unsigned long>(_index.size()), levels, subtrees);
+    QtConcurrent::blockingMap(subtrees, [this](std::pair<unsigned long, unsigned long>& range) {
+        build(range.first, range.second);
+    });
+}
+
+unsigned long PointKdTree::split(unsigned long lo, unsigned long hi)
+{
+    // split at the median along the axis of the largest extent
+    Base::BoundBox3f box;
+    for (unsigned long i = lo; i < hi; i++)
+        box.Add(_points[_index[i]]);
+    unsigned char axis = 0;
+    if (box.LengthY() > box.LengthX())
+        axis = 1;
+    if (box.LengthZ() > std::max(box.LengthX(), box.LengthY()))
+        axis = 2;
+
+    unsigned long mid = lo + (hi - lo) / 2;
+    const std::vector<value_type>& points = _points;
+    std::nth_element(_index.begin() + lo, _index.begin() + mid, _index.begin() + hi,
+        [&points, axis](unsigned long a, unsigned long b) {
+            return points[a][axis] < points[b][axis];
+        });
+    _axis[mid] = axis;
+    return mid;
+}
+
+void PointKdTree::split(unsigned long lo, unsigned long hi, int levels,
+                        std::vector<std::pair<unsigned long, unsigned long> >& subtrees)
+{
+    if (levels == 0 || hi - lo <= LeafSize) {
+        subtrees.push_back(std::make_pair(lo, hi));
+        return;
+    }
+
+    unsigned long mid = split(lo, hi);
+    split(lo, mid, levels - 1, subtrees);
+    split(mid + 1, hi, levels - 1, subtrees);
+}
+
+void PointKdTree::build(unsigned long lo, unsigned long hi)
+{
+    if (hi - lo <= LeafSize)
+        return;
+
+    unsigned long mid = split(lo, hi);
+    build(lo, mid);
+    build(mid + 1, hi);
+}
+
+void PointKdTree::findNearest(const value_type& point, std::size_t k,
+                              std::vector<unsigned long>& indices,
+                              std::vector<float>& sqrDistances) const
+{
+    indices.clear();
+    sqrDistances.clear();
+    if (k == 0)
+        return;
+
+    std::vector<Neighbour> heap;
+    heap.reserve(k);
+    searchNearest(0, static_cast<unsigned long>(_index.size()), point, k, heap);
+    std::sort_heap(heap.begin(), heap.end());
+
+    indices.reserve(heap.size());
+    sqrDistances.reserve(heap.size());
+    for (std::vector<Neighbour>::iterator it = heap.begin(); it != heap.end(); ++it) {
+        sqrDistances.push_back(it->first);
+        indices.push_back(it->second);
+    }
+}
+
+void PointKdTree::searchNearest(unsigned long lo, unsigned long hi, const value_type& point,
+                                std::size_t k, std::vector<Neighbour>& heap) const
+{
+    // 'heap' is a max-heap of the k best candidates found so far
+    unsigned long mid = lo + (hi - lo) / 2;
+    bool leaf = hi - lo <= LeafSize;
+    for (unsigned long i = leaf ? lo : mid; i < (leaf ? hi : mid + 1); i++) {
+        Neighbour candidate(Base::DistanceP2(point, _points[_index[i]]), _index[i]);
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+        }
+        else if (candidate < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+    if (leaf)
+        return;
+
+    unsigned char axis = _axis[mid];
+    float diff = point[axis] - _points[_index[mid]][axis];
+    if (diff < 0) {
+        searchNearest(lo, mid, point, k, heap);
+        if (heap.size() < k || diff * diff <= heap.front().first)
+            searchNearest(mid + 1, hi, point, k, heap);
+    }
+    else {
+        searchNearest(mid + 1, hi, point, k, heap);
+        if (heap.size() < k || diff * diff <= heap.front().first)
+            searchNearest(lo, mid, point, k, heap);
+    }
+}
+
+void PointKdTree::findInRadius(const value_type& point, float radius,
+                               std::vector<unsigned long>& indices) const
+{
+    indices.clear();
+    searchRadius(0, static_cast<unsigned long>(_index.size()), point, radius * radius, indices);
+}
+
+void PointKdTree::searchRadius(unsigned long lo, unsigned long hi, const value_type& point,
+                               float sqrRadius, std::vector<unsigned long>& indices) const
+{
+    unsigned long mid = lo + (hi - lo) / 2;
+    bool leaf = hi - lo <= LeafSize;
+    for (unsigned long i = leaf ? lo : mid; i < (leaf ? hi : mid + 1); i++) {
+        if (Base::DistanceP2(point, _points[_index[i]]) <= sqrRadius)
+            indices.push_back(_index[i]);
+    }
+    if (leaf)
+        return;
+
+    unsigned char axis = _axis[mid];
+    float diff = point[axis] - _points[_index[mid]][axis];
+    if (diff <= 0 || diff * diff <= sqrRadius)
+        searchRadius(lo, mid, point, sqrRadius, indices);
+    if (diff >= 0 || diff * diff <= sqrRadius)
+        searchRadius(mid + 1, hi, point, sqrRadius, indices);
+}
+
+// ----------------------------------------------------------------------------
+
+VoxelGridFilter::VoxelGridFilter(const PointKernel& pts)
+  : myPoints(pts), leafX(1), leafY(1), leafZ(1)
+{
+}
+
+void VoxelGridFilter::setLeafSize(double x, double y, double z)
+{
+    leafX = x;
+    leafY = y;
+    leafZ = z;
+}
+
+void VoxelGridFilter::perform(PointKernel& result) const
+{
+    std::vector<PointKernel::value_type> points;
+    voxelize(myPoints, leafX, leafY, leafZ, 0, points, 0);
+    result.setTransform(myPoints.getTransform());
+    result.swap(points);
+}
+
+void VoxelGridFilter::perform(const std::vector<Base::Vector3f>& normals, PointKernel& result,
+                              std::vector<Base::Vector3f>& resultNormals) const
+{
+    std::vector<PointKernel::value_type> points;
+    std::vector<Base::Vector3f> pointNormals;
+    voxelize(myPoints, leafX, leafY, leafZ, &normals, points, &pointNormals);
+    result.setTransform(myPoints.getTransform());
+    result.swap(points);
+    resultNormals.swap(pointNormals);
+}
+
+// ----------------------------------------------------------------------------
+
+NormalEstimation::NormalEstimation(const PointKernel& pts)
+  : myPoints(pts), kSearch(10), orientation(true)
+{
+}
+
+void NormalEstimation::perform(std::vector<Base::Vector3f>& normals) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    PointKdTree tree(points);
+    std::size_t k = static_cast<std::size_t>(kSearch);
+
+    // the neighbours found for the normals are kept for the orientation
+    std::vector<unsigned int> neighbours;
+    if (orientation) {
+        if (points.size() >= static_cast<std::size_t>(NoNeighbour))
+            throw Base::ValueError("Too many points to orient the normals");
+        neighbours.resize(points.size() * k, NoNeighbour);
+    }
+
+    normals.clear();
+    normals.resize(points.size());
+    forEachRange(points.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        std::vector<unsigned long> indices;
+        std::vector<float> distances;
+        for (std::size_t i = begin; i < end; i++) {
+            if (!isValid(points[i]))
+                continue;
+            tree.findNearest(points[i], k, indices, distances);
+            if (!neighbours.empty()) {
+                for (std::size_t j = 0; j < indices.size(); j++)
+                    neighbours[i * k + j] = static_cast<unsigned int>(indices[j]);
+            }
+            if (indices.size() < 3)
+                continue;
+
+            Eigen::Vector3d center(0, 0, 0);
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+                const PointKernel::value_type& p = points[*it];
+                center += Eigen::Vector3d(p.x, p.y, p.z);
+            }
+            center /= static_cast<double>(indices.size());
+
+            Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+                const PointKernel::value_type& p = points[*it];
+                Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - center;
+                covariance += d * d.transpose();
+            }
+
+            // the eigenvalues are sorted in increasing order
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(covariance);
+            Eigen::Vector3d normal = eig.eigenvectors().col(0);
+            normals[i].Set(static_cast<float>(normal.x()),
+                           static_cast<float>(normal.y()),
+                           static_cast<float>(normal.z()));
+        }
+    });
+
+    if (orientation)
+        orient(neighbours, normals);
+}
+
+void NormalEstimation::orient(const std::vector<unsigned int>& neighbours,
+                              std::vector<Base::Vector3f>& normals) const
+{
+    // Propagate the orientation along a minimum spanning tree of the neighbourhood
+    // graph whose edges are cheap for nearly parallel normals (Hoppe et al.).
+    // Prim's algorithm with a queue of points instead of edges keeps the memory
+    // linear in the number of points, and the neighbours of the parallel normal
+    // estimation are used, so no search is needed here.
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    std::size_t k = static_cast<std::size_t>(kSearch);
+
+    Base::Vector3d center;
+    std::size_t count = 0;
+    for (std::vector<PointKernel::value_type>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        if (isValid(*it)) {
+            center += Base::Vector3d(it->x, it->y, it->z);
+            count++;
+        }
+    }
+    if (count > 0)
+        center /= static_cast<double>(count);
+    Base::Vector3f centerf(static_cast<float>(center.x),
+                           static_cast<float>(center.y),
+                           static_cast<float>(center.z));
+
+    std::vector<bool> visited(points.size(), false);
+    // the point whose normal orients a point
+    std::vector<unsigned int> parent(points.size());
+    OrientQueue queue(points.size());
+
+    for (std::size_t seed = 0; seed < points.size(); seed++) {
+        if (visited[seed] || normals[seed].Length() == 0.0f)
+            continue;
+
+        if ((points[seed] - centerf) * normals[seed] < 0)
+            normals[seed] = -normals[seed];
+        parent[seed] = static_cast<unsigned int>(seed);
+        queue.push(static_cast<unsigned long>(seed), 0);
+
+        while (!queue.empty()) {
+            unsigned long index = queue.pop();
+            visited[index] = true;
+            if (normals[parent[index]] * normals[index] < 0)
+                normals[index] = -normals[index];
+
+            for (std::size_t j = index * k; j < (index + 1) * k; j++) {
+                unsigned int other = neighbours[j];
+                if (other == NoNeighbour || visited[other] || normals[other].Length() == 0.0f)
+                    continue;
+                float cost = 1.0f - std::fabs(normals[index] * normals[other]);
+                if (!queue.contains(other) || cost < queue.getCost(other)) {
+                    parent[other] = static_cast<unsigned int>(index);
+                    queue.push(other, cost);
+                }
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& pts)
+  : myPoints(pts), kSearch(8), stdDevMul(1.0)
+{
+}
+
+void OutlierRemoval::perform(std::vector<unsigned long>& outliers) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    PointKdTree tree(points);
+    // the point itself is its nearest neighbour
+    std::size_t k = static_cast<std::size_t>(kSearch) + 1;
+
+    // mean distance of every point to its neighbours, negative for invalid points
+    std::vector<float> meanDistances(points.size(), -1.0f);
+    forEachRange(points.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        std::vector<unsigned long> indices;
+        std::vector<float> distances;
+        for (std::size_t i = begin; i < end; i++) {
+            if (!isValid(points[i]))
+                continue;
+            tree.findNearest(points[i], k, indices, distances);
+            double sum = 0;
+            std::size_t num = 0;
+            for (std::size_t j = 0; j < indices.size(); j++) {
+                if (indices[j] != i) {
+                    sum += std::sqrt(distances[j]);
+                    num++;
+                }
+            }
+            meanDistances[i] = num > 0 ? static_cast<float>(sum / num) : 0.0f;
+        }
+    });
+
+    double sum = 0, sumSqr = 0;
+    std::size_t count = 0;
+    for (std::vector<float>::iterator it = meanDistances.begin(); it != meanDistances.end(); ++it) {
+        if (*it >= 0) {
+            sum += *it;
+            sumSqr += static_cast<double>(*it) * *it;
+            count++;
+        }
+    }
+
+    double threshold = 0;
+    if (count > 0) {
+        double mean = sum / count;
+        double variance = std::max(0.0, sumSqr / count - mean * mean);
+        threshold = mean + stdDevMul * std::sqrt(variance);
+    }
+
+    outliers.clear();
+    for (std::size_t i = 0; i < meanDistances.size(); i++) {
+        if (meanDistances[i] < 0 || meanDistances[i] > threshold)
+            outliers.push_back(static_cast<unsigned long>(i));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+DuplicateRemoval::DuplicateRemoval(const PointKernel& pts)
+  : myPoints(pts), tolerance(0)
+{
+}
+
+void DuplicateRemoval::perform(std::vector<unsigned long>& duplicates) const
+{
+    const std::vector<PointKernel::value_type>& points = myPoints.getBasicPoints();
+    PointKdTree tree(points);
+    float radius = static_cast<float>(tolerance);
+
+    // First find all points with a close point of lower index. Only these can be
+    // duplicates, which is decided in order afterwards as it depends on the
+    // decision for the points before.
+    std::vector<char> candidate(points.size(), 0);
+    forEachRange(points.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        std::vector<unsigned long> indices;
+        for (std::size_t i = begin; i < end; i++) {
+            if (!isValid(points[i]))
+                continue;
+            tree.findInRadius(points[i], radius, indices);
+            for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+                if (*it < i) {
+                    candidate[i] = 1;
+                    break;
+                }
+            }
+        }
+    });
+
+    std::vector<char> removed(points.size(), 0);
+    std::vector<unsigned long> indices;
+    duplicates.clear();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        if (!candidate[i])
+            continue;
+        tree.findInRadius(points[i], radius, indices);
+        for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+            if (*it < i && !removed[*it]) {
+                removed[i] = 1;
+                duplicates.push_back(static_cast<unsigned long>(i));
+                break;
+            }
+        }
+    }
+}
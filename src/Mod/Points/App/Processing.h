@@ -0,0 +1,195 @@
+/***************************************************************************
+ *   Copyright (c) 2020 The FreeCAD project                                *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_PROCESSING_H
+#define POINTS_PROCESSING_H
+
+#include <utility>
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+#include "Points.h"
+
+namespace Points
+{
+
+/** A k-d tree over the points of a point kernel.
+ * The tree works on the basic points, i.e. in the local coordinate system
+ * of the kernel, and refers to them by their index. Points with NaN
+ * coordinates are not added to the tree. The points must not be changed
+ * as long as the tree is used.
+ */
+class PointsExport PointKdTree
+{
+public:
+    typedef PointKernel::value_type value_type;
+
+    PointKdTree(const std::vector<value_type>& points);
+
+    /// Returns the number of points in the tree
+    std::size_t size() const
+    { return _index.size(); }
+    /** Searches the \a k nearest points of \a point, sorted by ascending distance.
+     * If \a point is part of the tree it is its own nearest point.
+     */
+    void findNearest(const value_type& point, std::size_t k,
+                     std::vector<unsigned long>& indices,
+                     std::vector<float>& sqrDistances) const;
+    /** Searches all points whose distance to \a point is not greater than
+     * \a radius. The indices are not sorted.
+     */
+    void findInRadius(const value_type& point, float radius,
+                      std::vector<unsigned long>& indices) const;
+
+private:
+    typedef std::pair<float, unsigned long> Neighbour;
+
+    unsigned long split(unsigned long lo, unsigned long hi);
+    void split(unsigned long lo, unsigned long hi, int levels,
+               std::vector<std::pair<unsigned long, unsigned long> >& subtrees);
+    void build(unsigned long lo, unsigned long hi);
+    void searchNearest(unsigned long lo, unsigned long hi, const value_type& point,
+                       std::size_t k, std::vector<Neighbour>& heap) const;
+    void searchRadius(unsigned long lo, unsigned long hi, const value_type& point,
+                      float sqrRadius, std::vector<unsigned long>& indices) const;
+
+private:
+    const std::vector<value_type>& _points;
+    /// The point indices, every sub-range is split at its middle
+    std::vector<unsigned long> _index;
+    /// The split axis of the middle element of every sub-range
+    std::vector<unsigned char> _axis;
+};
+
+/** Reduces the points to the centroids of the occupied cells of a
+ * regular grid (voxel grid).
+ * The cells are aligned to the local coordinate system of the kernel.
+ */
+class PointsExport VoxelGridFilter
+{
+public:
+    VoxelGridFilter(const PointKernel&);
+
+    /// Sets the size of the cells
+    void setLeafSize(double x, double y, double z);
+    /** Computes the reduced points. They are sorted by cell and get the
+     * transformation of the input points.
+     */
+    void perform(PointKernel& result) const;
+    /** Computes the reduced points and the averaged \a normals of the
+     * points of each cell.
+     */
+    void perform(const std::vector<Base::Vector3f>& normals, PointKernel& result,
+                 std::vector<Base::Vector3f>& resultNormals) const;
+
+private:
+    const PointKernel& myPoints;
+    double leafX, leafY, leafZ;
+};
+
+/** Estimates the normals of the points by a principal component analysis
+ * of their nearest neighbours.
+ * The normals refer to the local coordinate system of the kernel and are
+ * zero for points with too few neighbours. If orientation is enabled a
+ * consistent orientation is propagated over the neighbourhood graph,
+ * starting for every connected region at a normal that points away from
+ * the centre of the cloud. The orientation keeps the neighbours of all
+ * points, i.e. k indices per point.
+ */
+class PointsExport NormalEstimation
+{
+public:
+    NormalEstimation(const PointKernel&);
+
+    /// Sets the number of neighbours to use, the default is 10
+    void setKSearch(int k)
+    { kSearch = k > 3 ? k : 3; }
+    /// Sets whether the normals get a consistent orientation, the default is true
+    void setOrientation(bool on)
+    { orientation = on; }
+    void perform(std::vector<Base::Vector3f>& normals) const;
+
+private:
+    void orient(const std::vector<unsigned int>& neighbours, std::vector<Base::Vector3f>& normals) const;
+
+private:
+    const PointKernel& myPoints;
+    int kSearch;
+    bool orientation;
+};
+
+/** Statistical outlier removal.
+ * For every point the mean distance to its nearest neighbours is computed.
+ * A point is an outlier if its mean distance exceeds the mean of all points
+ * by more than a multiple of the standard deviation. Points with NaN
+ * coordinates are outliers, too.
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    OutlierRemoval(const PointKernel&);
+
+    /// Sets the number of neighbours to use, the default is 8
+    void setKSearch(int k)
+    { kSearch = k > 1 ? k : 1; }
+    /// Sets the multiple of the standard deviation, the default is 1
+    void setStdDevMultiplier(double mul)
+    { stdDevMul = mul; }
+    /** Returns the sorted indices of the outliers, e.g. to be passed to
+     * removeIndices() of the point properties.
+     */
+    void perform(std::vector<unsigned long>& outliers) const;
+
+private:
+    const PointKernel& myPoints;
+    int kSearch;
+    double stdDevMul;
+};
+
+/** Finds points that lie within a tolerance of a point with a lower index.
+ * A point is only a duplicate of points that are kept themselves, so that
+ * a dense row of points is thinned out instead of being removed as a whole.
+ */
+class PointsExport DuplicateRemoval
+{
+public:
+    DuplicateRemoval(const PointKernel&);
+
+    /// Sets the tolerance, the default is 0, i.e. identical points
+    void setTolerance(double tol)
+    { tolerance = tol > 0 ? tol : 0; }
+    /** Returns the sorted indices of the duplicates, e.g. to be passed to
+     * removeIndices() of the point properties.
+     */
+    void perform(std::vector<unsigned long>& duplicates) const;
+
+private:
+    const PointKernel& myPoints;
+    double tolerance;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_PROCESSING_H
@@ -49,32 +49,80 @@ PropertyPointKernel::PropertyPointKernel()
 
 PropertyPointKernel::~PropertyPointKernel()
 {
+    // the points aren't modified any more, so the copies can keep them
+    if (_sharedPoints && _sharedPoints->owner == this)
+        _sharedPoints->owner = nullptr;
+}
+
+void PropertyPointKernel::loadPoints() const
+{
+    if (_sharedPoints && _sharedPoints->owner != this) {
+        PropertyPointKernel* self = const_cast<PropertyPointKernel*>(this);
+        std::shared_ptr<SharedPoints> shared;
+        shared.swap(self->_sharedPoints);
+        if (!shared->owner && shared.use_count() == 1)
+            self->_cPoints = shared->points;
+        else
+            *_cPoints = *shared->points;
+    }
+}
+
+void PropertyPointKernel::detachCopies(bool keepData)
+{
+    if (!_sharedPoints)
+        return;
+
+    if (_sharedPoints->owner != this) {
+        loadPoints();
+        return;
+    }
+
+    if (_sharedPoints.use_count() > 1) {
+        if (keepData) {
+            _sharedPoints->points = new PointKernel(*_cPoints);
+        }
+        else {
+            Base::Reference<PointKernel> points(new PointKernel());
+            points->setTransform(_cPoints->getTransform());
+            std::vector<PointKernel::value_type> pts;
+            _cPoints->swap(pts);
+            points->swap(pts);
+            _sharedPoints->points = points;
+        }
+    }
+    _sharedPoints->owner = nullptr;
+    _sharedPoints.reset();
 }
 
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    detachCopies(false);
     *_cPoints = m;
     hasSetValue();
 }
 
 const PointKernel& PropertyPointKernel::getValue(void) const 
 {
+    loadPoints();
     return *_cPoints;
 }
 
 const Data::ComplexGeoData* PropertyPointKernel::getComplexData() const
 {
+    loadPoints();
     return _cPoints;
 }
 
 Base::BoundBox3d PropertyPointKernel::getBoundingBox() const
 {
+    loadPoints();
     return _cPoints->getBoundBox();
 }
 
 PyObject *PropertyPointKernel::getPyObject(void)
 {
+    loadPoints();
     PointsPy* points = new PointsPy(&*_cPoints);
     points->setConst(); // set immutable
     return points;
@@ -95,6 +143,7 @@ void PropertyPointKernel::setPyObject(PyObject *value)
 
 void PropertyPointKernel::Save (Base::Writer &writer) const
 {
+    loadPoints();
     _cPoints->Save(writer);
 }
 
@@ -114,6 +163,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detachCopies();
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -128,14 +178,23 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachCopies(false);
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
 
 App::Property *PropertyPointKernel::Copy(void) const 
 {
+    // The copy references the points until this property gets modified
+    loadPoints();
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    if (!_sharedPoints) {
+        PropertyPointKernel* self = const_cast<PropertyPointKernel*>(this);
+        self->_sharedPoints = std::make_shared<SharedPoints>();
+        self->_sharedPoints->owner = this;
+        self->_sharedPoints->points = _cPoints;
+    }
+    prop->_sharedPoints = _sharedPoints;
     return prop;
 }
 
@@ -143,18 +202,30 @@ void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    if (!prop._sharedPoints || prop._sharedPoints->owner != this) {
+        detachCopies(false);
+        if (prop._sharedPoints)
+            *(this->_cPoints) = *(prop._sharedPoints->points);
+        else
+            *(this->_cPoints) = *(prop._cPoints);
+    }
     hasSetValue();
 }
 
 unsigned int PropertyPointKernel::getMemSize (void) const
 {
-    return sizeof(Base::Vector3f) * this->_cPoints->size();
+    unsigned int size = sizeof(Base::Vector3f) * this->_cPoints->size();
+    // a copy only needs memory of its own once the original has been modified
+    if (_sharedPoints && !_sharedPoints->owner)
+        size += sizeof(Base::Vector3f) * _sharedPoints->points->size();
+    return size;
 }
 
 PointKernel* PropertyPointKernel::startEditing()
 {
+    loadPoints();
     aboutToSetValue();
+    detachCopies();
     return static_cast<PointKernel*>(_cPoints);
 }
 
@@ -165,6 +236,8 @@ void PropertyPointKernel::finishEditing()
 
 void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndices )
 {
+    loadPoints();
+
     // We need a sorted array
     std::vector<unsigned long> uSortedInds = uIndices;
     std::sort(uSortedInds.begin(), uSortedInds.end());
@@ -193,7 +266,18 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
+    loadPoints();
     aboutToSetValue();
+    detachCopies();
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
+
+void PropertyPointKernel::setTransform(const Base::Matrix4D &rclTrf)
+{
+    loadPoints();
+    if (_cPoints->getTransform() == rclTrf)
+        return;
+    detachCopies();
+    _cPoints->setTransform(rclTrf);
+}
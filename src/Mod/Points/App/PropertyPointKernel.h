@@ -24,6 +24,7 @@
 #ifndef POINTS_PROPERTYPOINTKERNEL_H
 #define POINTS_PROPERTYPOINTKERNEL_H
 
+#include <memory>
 #include "Points.h"
 
 namespace Points
@@ -83,11 +84,31 @@ public:
     void finishEditing();
     /// Transform the real 3d point kernel
     void transformGeometry(const Base::Matrix4D &rclMat);
+    /// Set the placement of the points without notification, the copies keep theirs
+    void setTransform(const Base::Matrix4D &rclTrf);
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    /// take over the points shared with the original property
+    void loadPoints() const;
+    /** Give the copies that still share the points their own data before they get modified.
+     * If \a keepData is false the points are replaced anyway, so they are moved to the copies.
+     */
+    void detachCopies(bool keepData = true);
+
+    /** Points shared between a property and its copies made by Copy().
+     * The copies only reference the points of the original property (the
+     * owner) until the owner is about to modify them.
+     */
+    struct SharedPoints {
+        const PropertyPointKernel* owner = nullptr;
+        Base::Reference<PointKernel> points;
+    };
+
 private:
     Base::Reference<PointKernel> _cPoints;
+    std::shared_ptr<SharedPoints> _sharedPoints;
 };
 
 } // namespace Points
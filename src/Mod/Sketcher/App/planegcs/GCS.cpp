@@ -87,6 +87,8 @@
 //#undef EIGEN_SPARSEQR_COMPATIBLE
 
 #include <Eigen/QR>
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
 
 #ifdef EIGEN_SPARSEQR_COMPATIBLE
 #include <Eigen/Sparse>
@@ -1701,8 +1703,9 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         return Success;
 
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Eigen::SparseMatrix<double> J(csize, xsize); // Jacobi of the subsystem
+    Eigen::SparseMatrix<double> A(xsize, xsize);
+    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldltA;
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
 
     subsys->redirectParams();
@@ -1750,9 +1753,16 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
-
-        A = J.transpose()*J;
+        // The Jacobian is sparse (every constraint depends on a few parameters only),
+        // so the normal equations are assembled and solved in sparse form.
+        subsys->calcJacobi(J);
+
+        A = Eigen::SparseMatrix<double>(J.transpose())*J;
+        // make sure that the diagonal is stored so that it can be augmented in place
+        for (int i=0; i < xsize; ++i)
+            A.coeffRef(i,i) += 0.;
+        A.makeCompressed();
+        ldltA.analyzePattern(A); // the augmentation below does not change the pattern
         g = J.transpose()*e;
 
         // Compute ||J^T e||_inf
@@ -1775,10 +1785,15 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         while (k < 50) {
             // augment normal equations A = A+uI
             for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+                A.coeffRef(i,i) += mu;
 
             //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
+            // A is symmetric and, for mu > 0, positive definite
+            ldltA.factorize(A);
+            if (ldltA.info() == Eigen::Success)
+                h = ldltA.solve(g);
+            else // fall back to the dense rank revealing decomposition
+                h = Eigen::MatrixXd(A).fullPivLu().solve(g);
             double rel_error = (A*h - g).norm() / g.norm();
 
             // check if solving works
@@ -1827,7 +1842,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
             mu*=nu;
             nu*=2.0;
             for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+                A.coeffRef(i,i) = diag_A(i);
 
             k++;
         }
@@ -1895,7 +1910,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    Eigen::SparseMatrix<double> Jx(csize, xsize), Jx_new(csize, xsize);
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
     subsys->redirectParams();
@@ -1939,16 +1954,28 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
             // get the gauss-newton step
             // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
             // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
+            // The rank revealing LU decompositions need the dense Jacobian, the
+            // LDLT variant solves the sparse normal equations J*J^T directly.
             switch (dogLegGaussStep){
                 case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
+                    h_gn = Eigen::MatrixXd(Jx).fullPivLu().solve(-fx);
                     break;
                 case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
+                {
+                    Eigen::MatrixXd Jd(Jx);
+                    h_gn = Jd.adjoint()*(Jd*Jd.adjoint()).fullPivLu().solve(-fx);
                     break;
+                }
                 case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
+                {
+                    Eigen::SparseMatrix<double> JJt = Jx*Eigen::SparseMatrix<double>(Jx.adjoint());
+                    Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldlt(JJt);
+                    if (ldlt.info() == Eigen::Success)
+                        h_gn = Jx.adjoint()*ldlt.solve(-fx);
+                    else // singular, use the pivoting dense decomposition
+                        h_gn = Jx.adjoint()*Eigen::MatrixXd(JJt).ldlt().solve(-fx);
                     break;
+                }
             }
 
             double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
@@ -3796,6 +3823,12 @@ void System::makeReducedJacobian(Eigen::MatrixXd &J,
 
     J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
 
+    // column of each diagnosed parameter, so that only the parameters a
+    // constraint depends on have to be differentiated
+    MAP_pD_I pdiagnoseindex;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        pdiagnoseindex[pdiagnoselist[j]] = j;
+
     int jacobianconstraintcount=0;
     int allcount=0;
     for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
@@ -3803,8 +3836,11 @@ void System::makeReducedJacobian(Eigen::MatrixXd &J,
         ++allcount;
         if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
             jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
+            VEC_pD constr_params = (*constr)->params();
+            for (VEC_pD::const_iterator param=constr_params.begin(); param != constr_params.end(); ++param) {
+                MAP_pD_I::const_iterator it = pdiagnoseindex.find(*param);
+                if (it != pdiagnoseindex.end())
+                    J(jacobianconstraintcount-1,it->second) = (*constr)->grad(*param);
             }
 
             // parallel processing: create tag multiplicity map
@@ -107,8 +107,10 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
 
     c2p.clear();
     p2c.clear();
+    c2pindex.assign(csize, VEC_I());
+    int i=0;
     for (std::vector<Constraint *>::iterator constr=clist.begin();
-         constr != clist.end(); ++constr) {
+         constr != clist.end(); ++constr, i++) {
         (*constr)->revertParams(); // ensure that the constraint points to the original parameters
         VEC_pD constr_params_orig = (*constr)->params();
         SET_pD constr_params;
@@ -123,11 +125,25 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
 //            jacobi.set(*constr, *p, 0.);
             c2p[*constr].push_back(*p);
             p2c[*p].push_back(*constr);
+            c2pindex[i].push_back(static_cast<int>(*p - pvals.data()));
         }
 //        (*constr)->redirectParams(pmap); // redirect parameters to pvec
     }
 }
 
+void SubSystem::getParamColumns(VEC_pD &params, std::vector<VEC_I> &columns)
+{
+    // a parameter of pvals may appear in several columns if params
+    // contains original parameters that have been reduced to it
+    columns.assign(psize, VEC_I());
+    for (int j=0; j < int(params.size()); j++) {
+        MAP_pD_pD::const_iterator
+          pmapfind = pmap.find(params[j]);
+        if (pmapfind != pmap.end())
+            columns[pmapfind->second - pvals.data()].push_back(j);
+    }
+}
+
 void SubSystem::redirectParams()
 {
     // copying values to pvals
@@ -258,44 +274,111 @@ void SubSystem::calcJacobi()
 }
 */
 
+// The Jacobian is assembled from the parameter footprint of each constraint
+// (c2pindex), so that grad() is only evaluated for the parameters that a
+// constraint actually depends on instead of for every (constraint, parameter)
+// pair.
 void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
 {
+    std::vector<VEC_I> columns;
+    getParamColumns(params, columns);
+
     jacobi.setZero(csize, params.size());
-    for (int j=0; j < int(params.size()); j++) {
-        MAP_pD_pD::const_iterator
-          pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end())
-            for (int i=0; i < csize; i++)
-                jacobi(i,j) = clist[i]->grad(pmapfind->second);
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it) {
+            const VEC_I &cols = columns[*it];
+            if (cols.empty())
+                continue;
+            double value = clist[i]->grad(&pvals[*it]);
+            for (VEC_I::const_iterator col=cols.begin(); col != cols.end(); ++col)
+                jacobi(i,*col) = value;
+        }
     }
 }
 
 void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
 {
-    calcJacobi(plist, jacobi);
+    jacobi.setZero(csize, psize);
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it)
+            jacobi(i,*it) = clist[i]->grad(&pvals[*it]);
+    }
+}
+
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi)
+{
+    std::vector<VEC_I> columns;
+    getParamColumns(params, columns);
+
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it) {
+            const VEC_I &cols = columns[*it];
+            if (cols.empty())
+                continue;
+            double value = clist[i]->grad(&pvals[*it]);
+            for (VEC_I::const_iterator col=cols.begin(); col != cols.end(); ++col)
+                triplets.push_back(Eigen::Triplet<double>(i, *col, value));
+        }
+    }
+
+    jacobi.resize(csize, params.size());
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it)
+            triplets.push_back(Eigen::Triplet<double>(i, *it, clist[i]->grad(&pvals[*it])));
+    }
+
+    jacobi.resize(csize, psize);
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
 }
 
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
 
+    std::vector<VEC_I> columns;
+    getParamColumns(params, columns);
+
     grad.setZero();
-    for (int j=0; j < int(params.size()); j++) {
-        MAP_pD_pD::const_iterator
-          pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end()) {
-            // assert(p2c.find(pmapfind->second) != p2c.end());
-            std::vector<Constraint *> constrs=p2c[pmapfind->second];
-            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
-                 constr != constrs.end(); ++constr)
-                grad[j] += (*constr)->error() * (*constr)->grad(pmapfind->second);
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        if (indices.empty())
+            continue;
+        double err = clist[i]->error(); // evaluated once per constraint
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it) {
+            const VEC_I &cols = columns[*it];
+            if (cols.empty())
+                continue;
+            double value = err * clist[i]->grad(&pvals[*it]);
+            for (VEC_I::const_iterator col=cols.begin(); col != cols.end(); ++col)
+                grad[*col] += value;
         }
     }
 }
 
 void SubSystem::calcGrad(Eigen::VectorXd &grad)
 {
-    calcGrad(plist, grad);
+    assert(grad.size() == psize);
+
+    grad.setZero();
+    for (int i=0; i < csize; i++) {
+        const VEC_I &indices = c2pindex[i];
+        if (indices.empty())
+            continue;
+        double err = clist[i]->error();
+        for (VEC_I::const_iterator it=indices.begin(); it != indices.end(); ++it)
+            grad[*it] += err * clist[i]->grad(&pvals[*it]);
+    }
 }
 
 double SubSystem::maxStep(VEC_pD &params, Eigen::VectorXd &xdir)
@@ -206,6 +206,7 @@ void Cell::setExpression(App::ExpressionPtr &&expr)
     }
 
     expression = std::move(expr);
+    compiled.reset();
     setUsed(EXPRESSION_SET, !!expression);
 
     /* Update dependencies */
@@ -238,6 +239,28 @@ const App::Expression *Cell::getExpression(bool withFormat) const
     return expression.get();
 }
 
+/**
+  * Evaluate the expression with its compiled form.
+  *
+  * @returns true if the expression evaluated to a number, false if it has to
+  * be evaluated with Expression::eval().
+  */
+
+bool Cell::evaluate(Base::Quantity & result) const
+{
+    return expression && compiled.eval(expression.get(), result);
+}
+
+/**
+  * Check whether evaluate() may be called concurrently with other cells,
+  * see App::CompiledExpression::isConcurrent().
+  */
+
+bool Cell::isConcurrent() const
+{
+    return expression && !hasException() && compiled.isConcurrent(expression.get());
+}
+
 /**
   * Get string content.
   *
@@ -285,6 +308,7 @@ void Cell::setContent(const char * value)
     if (value != 0) {
         if(owner->sheet()->isRestoring()) {
             expression.reset(new App::StringExpression(owner->sheet(),value));
+            compiled.reset();
             setUsed(EXPRESSION_SET, true);
             return;
         }
@@ -57,6 +57,10 @@ public:
 
     const App::Expression * getExpression(bool withFormat=false) const;
 
+    bool evaluate(Base::Quantity & result) const;
+
+    bool isConcurrent() const;
+
     bool getStringContent(std::string & s, bool persistent=false) const;
 
     void setContent(const char * value);
@@ -180,6 +184,7 @@ private:
 
     int used;
     mutable App::ExpressionPtr expression;
+    mutable App::CompiledExpression compiled;
     int alignment;
     std::set<std::string> style;
     App::Color foregroundColor;
@@ -71,6 +71,8 @@ void PropertySheet::clear()
     cellToPropertyNameMap.clear();
     documentObjectToCellMap.clear();
     cellToDocumentObjectMap.clear();
+    cellToDependantsMap.clear();
+    cellToPrecedentsMap.clear();
     aliasProp.clear();
     revAliasProp.clear();
 
@@ -198,6 +200,8 @@ PropertySheet::PropertySheet(const PropertySheet &other)
     , cellToPropertyNameMap(other.cellToPropertyNameMap)
     , documentObjectToCellMap(other.documentObjectToCellMap)
     , cellToDocumentObjectMap(other.cellToDocumentObjectMap)
+    , cellToDependantsMap(other.cellToDependantsMap)
+    , cellToPrecedentsMap(other.cellToPrecedentsMap)
     , aliasProp(other.aliasProp)
     , revAliasProp(other.revAliasProp)
     , updateCount(other.updateCount)
@@ -988,9 +992,11 @@ void PropertySheet::addDependencies(CellAddress key)
 
             // Also an alias?
             if (docObj==owner && props.first.size()) {
+                CellAddress address = stringToAddress(props.first.c_str(), true);
                 std::map<std::string, CellAddress>::const_iterator j = revAliasProp.find(props.first);
 
                 if (j != revAliasProp.end()) {
+                    address = j->second;
                     propName = docObjName + "." + j->second.toString();
                     FC_LOG("dep " << key.toString() << " -> " << propName);
 
@@ -998,6 +1004,12 @@ void PropertySheet::addDependencies(CellAddress key)
                     propertyNameToCellMap[propName].insert(key);
                     cellToPropertyNameMap[key].insert(propName);
                 }
+
+                // Cell to cell dependency within this sheet
+                if (address.isValid()) {
+                    cellToDependantsMap[address].insert(key);
+                    cellToPrecedentsMap[key].insert(address);
+                }
             }
         }
     }
@@ -1032,6 +1044,25 @@ void PropertySheet::removeDependencies(CellAddress key)
         cellToPropertyNameMap.erase(i1);
     }
 
+    /* Remove from cell <-> cell maps */
+
+    std::map<CellAddress, std::set< CellAddress > >::iterator i3 = cellToPrecedentsMap.find(key);
+
+    if (i3 != cellToPrecedentsMap.end()) {
+        for (auto &address : i3->second) {
+            std::map<CellAddress, std::set< CellAddress > >::iterator k = cellToDependantsMap.find(address);
+
+            if (k != cellToDependantsMap.end()) {
+                k->second.erase(key);
+
+                if (k->second.size() == 0)
+                    cellToDependantsMap.erase(k);
+            }
+        }
+
+        cellToPrecedentsMap.erase(i3);
+    }
+
     /* Remove from DocumentObject <-> Key maps */
 
     std::map<CellAddress, std::set< std::string > >::iterator i2 = cellToDocumentObjectMap.find(key);
@@ -1211,6 +1242,22 @@ const std::set<CellAddress> &PropertySheet::getDeps(const std::string &name) con
         return empty;
 }
 
+/**
+  * Get the cells of this sheet that have to be recomputed when the cell
+  * at \a pos changes.
+  */
+
+const std::set<CellAddress> &PropertySheet::getDependants(CellAddress pos) const
+{
+    static std::set<CellAddress> empty;
+    std::map<CellAddress, std::set< CellAddress > >::const_iterator i = cellToDependantsMap.find(pos);
+
+    if (i != cellToDependantsMap.end())
+        return i->second;
+    else
+        return empty;
+}
+
 const std::set<std::string> &PropertySheet::getDeps(CellAddress pos) const
 {
     static std::set<std::string> empty;
@@ -154,6 +154,8 @@ public:
 
     const std::set<std::string> &getDeps(App::CellAddress pos) const;
 
+    const std::set<App::CellAddress> &getDependants(App::CellAddress pos) const;
+
     void recomputeDependencies(App::CellAddress key);
 
     PyObject *getPyObject(void) override;
@@ -242,6 +244,12 @@ private:
     /*! DocumentObject this cell depends on */
     std::map<App::CellAddress, std::set< std::string > > cellToDocumentObjectMap;
 
+    /*! Cells of this sheet that refer to the cell given in key, directly or by its alias */
+    std::map<App::CellAddress, std::set< App::CellAddress > > cellToDependantsMap;
+
+    /*! Cells of this sheet this cell refers to */
+    std::map<App::CellAddress, std::set< App::CellAddress > > cellToPrecedentsMap;
+
     /*! Mapping of cell position to alias property */
     std::map<App::CellAddress, std::string> aliasProp;
 
@@ -31,6 +31,7 @@
 #include <boost/range/algorithm/copy.hpp>
 #include <boost/assign.hpp>
 #include <boost/graph/topological_sort.hpp>
+#include <QtConcurrentMap>
 #include <App/Application.h>
 #include <App/Document.h>
 #include <App/DynamicProperty.h>
@@ -481,16 +482,19 @@ void Sheet::onSettingDocument()
 
 Property * Sheet::setFloatProperty(CellAddress key, double value)
 {
-    Property * prop = props.getDynamicPropertyByName(key.toString().c_str());
+    std::string name = key.toString();
+    Property * prop = props.getDynamicPropertyByName(name.c_str());
     PropertyFloat * floatProp;
 
     if (!prop || prop->getTypeId() != PropertyFloat::getClassTypeId()) {
         if (prop) {
-            this->removeDynamicProperty(key.toString().c_str());
+            this->removeDynamicProperty(name.c_str());
             propAddress.erase(prop);
         }
-        floatProp = freecad_dynamic_cast<PropertyFloat>(addDynamicProperty("App::PropertyFloat", key.toString().c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist));
+        floatProp = freecad_dynamic_cast<PropertyFloat>(addDynamicProperty("App::PropertyFloat", name.c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist));
     }
+    else if (static_cast<PropertyFloat*>(prop)->getValue() == value)
+        return prop; // Don't signal a change if the value is the same
     else
         floatProp = static_cast<PropertyFloat*>(prop);
 
@@ -502,18 +506,21 @@ Property * Sheet::setFloatProperty(CellAddress key, double value)
 
 Property * Sheet::setIntegerProperty(CellAddress key, long value)
 {
-    Property * prop = props.getDynamicPropertyByName(key.toString().c_str());
+    std::string name = key.toString();
+    Property * prop = props.getDynamicPropertyByName(name.c_str());
     PropertyInteger * intProp;
 
     if (!prop || prop->getTypeId() != PropertyInteger::getClassTypeId()) {
         if (prop) {
-            this->removeDynamicProperty(key.toString().c_str());
+            this->removeDynamicProperty(name.c_str());
             propAddress.erase(prop);
         }
         intProp = freecad_dynamic_cast<PropertyInteger>(addDynamicProperty(
-                    "App::PropertyInteger", key.toString().c_str(), 0, 0, 
+                    "App::PropertyInteger", name.c_str(), 0, 0, 
                     Prop_ReadOnly | Prop_Hidden | Prop_NoPersist));
     }
+    else if (static_cast<PropertyInteger*>(prop)->getValue() == value)
+        return prop; // Don't signal a change if the value is the same
     else
         intProp = static_cast<PropertyInteger*>(prop);
 
@@ -536,19 +543,26 @@ Property * Sheet::setIntegerProperty(CellAddress key, long value)
 
 Property * Sheet::setQuantityProperty(CellAddress key, double value, const Base::Unit & unit)
 {
-    Property * prop = props.getDynamicPropertyByName(key.toString().c_str());
+    std::string name = key.toString();
+    Property * prop = props.getDynamicPropertyByName(name.c_str());
     PropertySpreadsheetQuantity * quantityProp;
 
     if (!prop || prop->getTypeId() != PropertySpreadsheetQuantity::getClassTypeId()) {
         if (prop) {
-            this->removeDynamicProperty(key.toString().c_str());
+            this->removeDynamicProperty(name.c_str());
             propAddress.erase(prop);
         }
-        Property * p = addDynamicProperty("Spreadsheet::PropertySpreadsheetQuantity", key.toString().c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist);
+        Property * p = addDynamicProperty("Spreadsheet::PropertySpreadsheetQuantity", name.c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist);
         quantityProp = freecad_dynamic_cast<PropertySpreadsheetQuantity>(p);
     }
-    else
+    else {
        quantityProp = static_cast<PropertySpreadsheetQuantity*>(prop);
+       // Don't signal a change if the value is the same
+       if (quantityProp->getValue() == value && quantityProp->getUnit() == unit) {
+           cells.setComputedUnit(key, unit);
+           return quantityProp;
+       }
+    }
 
     propAddress[quantityProp] = key;
     quantityProp->setValue(value);
@@ -570,16 +584,19 @@ Property * Sheet::setQuantityProperty(CellAddress key, double value, const Base:
 
 Property * Sheet::setStringProperty(CellAddress key, const std::string & value)
 {
-    Property * prop = props.getDynamicPropertyByName(key.toString().c_str());
+    std::string name = key.toString();
+    Property * prop = props.getDynamicPropertyByName(name.c_str());
     PropertyString * stringProp = freecad_dynamic_cast<PropertyString>(prop);
 
     if (!stringProp) {
         if (prop) {
-            this->removeDynamicProperty(key.toString().c_str());
+            this->removeDynamicProperty(name.c_str());
             propAddress.erase(prop);
         }
-        stringProp = freecad_dynamic_cast<PropertyString>(addDynamicProperty("App::PropertyString", key.toString().c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist));
+        stringProp = freecad_dynamic_cast<PropertyString>(addDynamicProperty("App::PropertyString", name.c_str(), 0, 0, Prop_ReadOnly | Prop_Hidden | Prop_NoPersist));
     }
+    else if (value == stringProp->getStrValue())
+        return stringProp; // Don't signal a change if the value is the same
 
     propAddress[stringProp] = key;
     stringProp->setValue(value.c_str());
@@ -661,21 +678,30 @@ struct CurrentAddressLock {
 /**
   * Update the Property given by \a key. This will also eventually trigger recomputations of cells depending on \a key.
   *
-  * @param key The address of the cell we want to recompute.
+  * @param key   The address of the cell we want to recompute.
+  * @param value The already evaluated numeric result of the cell, or null.
   *
   */
 
-void Sheet::updateProperty(CellAddress key)
+void Sheet::updateProperty(CellAddress key, const Base::Quantity *value)
 {
     Cell * cell = getCell(key);
 
     if (cell != 0) {
         std::unique_ptr<Expression> output;
+        NumberExpression compiledResult(this);
         const Expression * input = cell->getExpression();
+        const Expression * result = &compiledResult;
 
         if (input) {
             CurrentAddressLock lock(currentRow,currentCol,key);
-            output.reset(input->eval());
+            Base::Quantity number;
+            if (value)
+                compiledResult.setUnit(*value);
+            else if (cell->evaluate(number))
+                compiledResult.setUnit(number);
+            else
+                output.reset(input->eval());
         }
         else {
             std::string s;
@@ -686,9 +712,12 @@ void Sheet::updateProperty(CellAddress key)
                 output.reset(new StringExpression(this, ""));
         }
 
+        if (output)
+            result = output.get();
+
         /* Eval returns either NumberExpression or StringExpression, or
          * PyObjectExpression objects */
-        auto number = freecad_dynamic_cast<NumberExpression>(output.get());
+        auto number = freecad_dynamic_cast<NumberExpression>(result);
         if(number) {
             long l;
             if (!number->getUnit().isEmpty())
@@ -698,12 +727,12 @@ void Sheet::updateProperty(CellAddress key)
             else
                 setFloatProperty(key, number->getValue());
         }else{
-            auto str_expr = freecad_dynamic_cast<StringExpression>(output.get());
+            auto str_expr = freecad_dynamic_cast<StringExpression>(result);
             if(str_expr) 
                 setStringProperty(key, str_expr->getText().c_str());
             else {
                 Base::PyGILStateLocker lock;
-                auto py_expr = freecad_dynamic_cast<PyObjectExpression>(output.get());
+                auto py_expr = freecad_dynamic_cast<PyObjectExpression>(result);
                 if(py_expr) 
                     setObjectProperty(key, py_expr->getPyObject());
                 else
@@ -751,9 +780,10 @@ void Sheet::touchCells(Range range) {
 /**
  * @brief Recompute cell at address \a p.
  * @param p Address of cell.
+ * @param value Already evaluated numeric result of the cell, or null.
  */
 
-void Sheet::recomputeCell(CellAddress p)
+void Sheet::recomputeCell(CellAddress p, const Base::Quantity *value)
 {
     Cell * cell = cells.getValue(p);
 
@@ -764,7 +794,7 @@ void Sheet::recomputeCell(CellAddress p)
             cell->setContent(content.c_str());
         }
 
-        updateProperty(p);
+        updateProperty(p, value);
 
         if(!cell || !cell->hasException()) {
             cells.clearDirty(p);
@@ -794,6 +824,69 @@ void Sheet::recomputeCell(CellAddress p)
         cellSpanChanged(p);
 }
 
+namespace {
+
+// Minimum number of independent cells worth evaluating in parallel
+const std::size_t MinParallelCells = 256;
+
+struct ConcurrentCell {
+    CellAddress address;
+    const Cell *cell;
+    Base::Quantity value;
+    bool valid;
+};
+
+void evaluateConcurrentCell(ConcurrentCell &c)
+{
+    try {
+        c.valid = c.cell->evaluate(c.value);
+    }
+    catch (...) {
+        // Evaluate again in recomputeCell() to report the error
+        c.valid = false;
+    }
+}
+
+}
+
+/**
+ * @brief Recompute the cells at \a addresses, which must not refer to each other.
+ * @param addresses Addresses of the cells.
+ * @param parallel Whether to evaluate the numeric expressions in parallel.
+ *
+ * The properties of the cells are always updated in the calling thread.
+ */
+
+void Sheet::recomputeCells(const std::vector<CellAddress> &addresses, bool parallel)
+{
+    std::vector<ConcurrentCell> concurrent;
+
+    if (parallel && addresses.size() >= MinParallelCells) {
+        for (auto &address : addresses) {
+            const Cell *cell = cells.getValue(address);
+            if (cell && cell->isConcurrent()) {
+                ConcurrentCell c = {address, cell, Base::Quantity(), false};
+                concurrent.push_back(c);
+            }
+        }
+        if (concurrent.size() < MinParallelCells)
+            concurrent.clear();
+        else
+            QtConcurrent::blockingMap(concurrent, evaluateConcurrentCell);
+    }
+
+    auto it = concurrent.begin();
+    for (auto &address : addresses) {
+        FC_LOG(address.toString());
+        if (it != concurrent.end() && it->address == address) {
+            recomputeCell(address, it->valid ? &it->value : 0);
+            ++it;
+        }
+        else
+            recomputeCell(address);
+    }
+}
+
 /**
   * Update the document properties.
   *
@@ -813,48 +906,60 @@ DocumentObjectExecReturn *Sheet::execute(void)
          dirtyCells.insert(*i);
     }
 
-    DependencyList graph;
-    std::map<CellAddress, Vertex> VertexList;
-    std::map<Vertex, CellAddress> VertexIndexList;
+    // Collect the cells depending on the dirty cells, and count for each of
+    // them the number of collected cells it refers to
+    std::map<CellAddress, int> precedentCount;
+    for (auto &address : dirtyCells)
+        precedentCount[address] = 0;
     std::deque<CellAddress> workQueue(dirtyCells.begin(),dirtyCells.end());
     while(workQueue.size()) {
         CellAddress currPos = workQueue.front();
         workQueue.pop_front();
 
-        // Insert into map of CellPos -> Index, if it doesn't exist already
-        auto res = VertexList.emplace(currPos,Vertex());
-        if(res.second) {
-            res.first->second = add_vertex(graph);
-            VertexIndexList[res.first->second] = currPos;
-        }
-
         // Process cells that depend on the current cell
         for(auto &dep : providesTo(currPos)) {
-            auto resDep = VertexList.emplace(dep,Vertex());
-            if(resDep.second) {
-                resDep.first->second = add_vertex(graph);
-                VertexIndexList[resDep.first->second] = dep;
-                if(dirtyCells.insert(dep).second)
-                    workQueue.push_back(dep);
+            auto res = precedentCount.emplace(dep, 0);
+            ++res.first->second;
+            if(res.second) {
+                dirtyCells.insert(dep);
+                workQueue.push_back(dep);
             }
-            // Add edge to graph to signal dependency
-            add_edge(res.first->second, resDep.first->second, graph);
         }
     }
-    // Compute cells
-    std::list<Vertex> make_order;
-    // Sort graph topologically to find evaluation order
-    try {
-        boost::topological_sort(graph, std::front_inserter(make_order));
+
+    // Sort the cells topologically into levels. A cell only refers to cells
+    // of previous levels, so the cells of one level are independent.
+    std::vector<std::vector<CellAddress> > levels(1);
+    for (auto &v : precedentCount) {
+        if (v.second == 0)
+            levels[0].push_back(v.first);
+    }
+    std::size_t sortedCount = levels[0].size();
+    while (levels.back().size()) {
+        std::vector<CellAddress> next;
+        for (auto &address : levels.back()) {
+            for (auto &dep : providesTo(address)) {
+                if (--precedentCount[dep] == 0)
+                    next.push_back(dep);
+            }
+        }
+        sortedCount += next.size();
+        levels.push_back(std::move(next));
+    }
+    levels.pop_back();
+
+    if (sortedCount == precedentCount.size()) {
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+                "User parameter:BaseApp/Preferences/Mod/Spreadsheet");
+        bool parallel = hGrp->GetBool("ParallelRecompute", false);
+
         // Recompute cells
         FC_LOG("recomputing " << getFullName());
-        for(auto &pos : make_order) {
-            const auto &addr = VertexIndexList[pos];
-            FC_LOG(addr.toString());
-            recomputeCell(addr);
-        }
-    } catch (std::exception&) {
-        for(auto &v : VertexList) {
+        for (auto &level : levels)
+            recomputeCells(level, parallel);
+    }
+    else {
+        for(auto &v : precedentCount) {
             Cell * cell = cells.getValue(v.first);
             // Mark as erroneous
             cellErrors.insert(v.first);
@@ -1360,9 +1465,9 @@ void Sheet::providesTo(CellAddress address, std::set<std::string> & result) cons
  * @param result Set of links.
  */
 
-std::set<CellAddress>  Sheet::providesTo(CellAddress address) const
+const std::set<CellAddress> &Sheet::providesTo(CellAddress address) const
 {
-    return cells.getDeps(getFullName()+"."+address.toString());
+    return cells.getDependants(address);
 }
 
 void Sheet::onDocumentRestored()
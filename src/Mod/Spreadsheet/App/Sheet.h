@@ -193,11 +193,13 @@ protected:
 
     void updateColumnsOrRows(bool horizontal, int section, int count) ;
 
-    std::set<App::CellAddress> providesTo(App::CellAddress address) const;
+    const std::set<App::CellAddress> &providesTo(App::CellAddress address) const;
 
     void onDocumentRestored();
 
-    void recomputeCell(App::CellAddress p);
+    void recomputeCell(App::CellAddress p, const Base::Quantity *value = 0);
+
+    void recomputeCells(const std::vector<App::CellAddress> &addresses, bool parallel);
 
     App::Property *getProperty(App::CellAddress key) const;
 
@@ -205,7 +207,7 @@ protected:
 
     void updateAlias(App::CellAddress key);
 
-    void updateProperty(App::CellAddress key);
+    void updateProperty(App::CellAddress key, const Base::Quantity *value = 0);
 
     App::Property *setStringProperty(App::CellAddress key, const std::string & value) ;
 
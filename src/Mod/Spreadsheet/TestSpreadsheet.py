@@ -870,6 +870,85 @@ class SpreadsheetCases(unittest.TestCase):
         self.doc.recompute()
         self.assertEqual(sheet.get('C1'), Units.Quantity('3 mm'))
 
+    def testCompiledExpressions(self):
+        """ Repeated evaluation follows value, type and binding changes of referenced cells """
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        sheet.set('A1', '2')
+        sheet.set('B1', '=A1 * 2 + (A1 > 1 ? 1 : 0) + sqrt(4)')
+        sheet.set('C1', '=A1 * 1mm')
+        other = self.doc.addObject('Spreadsheet::Sheet','Other')
+        other.set('A1', '=Spreadsheet.B1 + 1')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 7)
+        self.assertEqual(sheet.C1, Units.Quantity('2 mm'))
+        self.assertEqual(other.A1, 8)
+
+        sheet.set('A1', '4')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 11)
+        self.assertEqual(other.A1, 12)
+
+        # The cell property is replaced when the value type changes
+        sheet.set('A1', '0.5')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 3)
+        self.assertEqual(sheet.C1, Units.Quantity('0.5 mm'))
+        self.assertEqual(other.A1, 4)
+
+        sheet.set('A1', '2mm')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, u'ERR: Incompatible units for the > operator')
+        self.assertEqual(sheet.C1, Units.Quantity('2 mm^2'))
+
+        sheet.set('A1', 'text')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, u'ERR: Invalid expression')
+
+        sheet.set('A1', '3')
+        sheet.set('B1', '=A1 + 1')
+        self.doc.recompute()
+        self.assertEqual(sheet.B1, 4)
+        self.assertEqual(other.A1, 5)
+
+    def testIncrementalRecompute(self):
+        """ Only cells depending on a changed cell are recomputed, in dependency order """
+        hGrp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Spreadsheet")
+        parallel = hGrp.GetBool("ParallelRecompute", False)
+        sheet = self.doc.addObject('Spreadsheet::Sheet','Spreadsheet')
+        try:
+            for p in (False, True):
+                hGrp.SetBool("ParallelRecompute", p)
+                sheet.set('A1', '1')
+                sheet.setAlias('A1', 'start')
+                # Chain A2..A100 and fan-out B1..B300 on the chain's end
+                for i in range(2, 101):
+                    sheet.set('A%d' % i, '=A%d + 1' % (i - 1))
+                for i in range(1, 301):
+                    sheet.set('B%d' % i, '=A100 * %d + start' % i)
+                sheet.set('C1', '=B300 + B1')
+                self.doc.recompute()
+                self.assertEqual(sheet.A100, 100)
+                self.assertEqual(sheet.B300, 30001)
+                self.assertEqual(sheet.C1, 30102)
+
+                sheet.set('A1', '2')
+                self.doc.recompute()
+                self.assertEqual(sheet.A100, 101)
+                self.assertEqual(sheet.B300, 30302)
+                self.assertEqual(sheet.C1, 30405)
+
+                # Cyclic dependencies are still reported
+                sheet.set('A1', '=C1')
+                self.doc.recompute()
+                self.assertTrue(sheet.C1.startswith(u'ERR: Cyclic dependency') or
+                                sheet.C1.startswith(u'ERR: Pending computation'))
+                sheet.set('A1', '1')
+                self.doc.recompute()
+                self.assertEqual(sheet.C1, 30102)
+                sheet.setAlias('A1', '')
+        finally:
+            hGrp.SetBool("ParallelRecompute", parallel)
+
 
     def tearDown(self):
         #closing doc
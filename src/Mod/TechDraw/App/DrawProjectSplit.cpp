@@ -66,6 +66,7 @@
 #include <algorithm>
 #include <cmath>
 #include <GeomLib_Tool.hxx>
+#include <QtConcurrentMap>
 
 #include <App/Application.h>
 #include <Base/BoundBox.h>
@@ -165,67 +166,10 @@ std::vector<TopoDS_Edge> DrawProjectSplit::getEdges(TechDraw::GeometryObject* ge
         }
     }
     faceEdges = nonZero;
-    origEdges = nonZero;
 
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = origEdges.begin();
-    int iOuter = 0;
-    for (; itOuter != origEdges.end(); ++itOuter, iOuter++) {
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::Add(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
-            Base::Console().Message("DPS::Extract Faces - outer Bnd_Box is void\n");
-            continue;
-        }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            Base::Console().Message("DPS::extractFaces - outerEdge: %d is ZeroEdge\n",iOuter);   //this is not finding ZeroEdges
-            continue;  //skip zero length edges. shouldn't happen ;)
-        }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = faceEdges.begin();
-        for (; itInner != faceEdges.end(); ++itInner,iInner++) {
-            if (iInner == iOuter) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::Add(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
-                Base::Console().Log("INFO - DPS::Extract Faces - inner Bnd_Box is void\n");
-                continue;
-            }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
-            }
-
-            double param = -1;
-            if (isOnEdge((*itInner),v1,param,false)) {
-                gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                splitPoint s1;
-                s1.i = iInner;
-                s1.v = Base::Vector3d(pnt1.X(),pnt1.Y(),pnt1.Z());
-                s1.param = param;
-                splits.push_back(s1);
-            }
-            if (isOnEdge((*itInner),v2,param,false)) {
-                gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                splitPoint s2;
-                s2.i = iInner;
-                s2.v = Base::Vector3d(pnt2.X(),pnt2.Y(),pnt2.Z());
-                s2.param = param;
-                splits.push_back(s2);
-            }
-        } //inner loop
-    }   //outer loop
+    std::vector<splitPoint> splits = findSplitPoints(faceEdges);
 
     std::vector<splitPoint> sorted = sortSplits(splits,true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
@@ -261,29 +205,197 @@ bool DrawProjectSplit::isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, b
         }
     }
     if (!outOfBox) {
-            double dist = DrawUtil::simpleMinDist(v,e);
-            if (dist < 0.0) {
-                Base::Console().Error("DPS::isOnEdge - simpleMinDist failed: %.3f\n",dist);
+        result = isOnCurve(e, v, param, allowEnds);
+    } //!outofbox
+    return result;
+}
+
+//the distance test of isOnEdge for a vertex already known to be in the Bnd_Box of e
+bool DrawProjectSplit::isOnCurve(const TopoDS_Edge& e, const TopoDS_Vertex& v, double& param, bool allowEnds)
+{
+    bool result = false;
+    double dist = DrawUtil::simpleMinDist(v,e);
+    if (dist < 0.0) {
+        Base::Console().Error("DPS::isOnEdge - simpleMinDist failed: %.3f\n",dist);
+        result = false;
+    } else if (dist < Precision::Confusion()) {
+        const gp_Pnt pt = BRep_Tool::Pnt(v);                         //have to duplicate method 3 to get param
+        BRepAdaptor_Curve adapt(e);
+        const Handle(Geom_Curve) c = adapt.Curve().Curve();
+        double maxDist = 0.000001;     //magic number.  less than this gives false positives.
+        //bool found =
+        (void) GeomLib_Tool::Parameter(c,pt,maxDist,param);  //already know point it on curve
+        result = true;
+    }
+    if (result) {
+        TopoDS_Vertex v1 = TopExp::FirstVertex(e);
+        TopoDS_Vertex v2 = TopExp::LastVertex(e);
+        if (DrawUtil::isSamePoint(v,v1) || DrawUtil::isSamePoint(v,v2)) {
+            if (!allowEnds) {
                 result = false;
-            } else if (dist < Precision::Confusion()) {
-                const gp_Pnt pt = BRep_Tool::Pnt(v);                         //have to duplicate method 3 to get param
-                BRepAdaptor_Curve adapt(e);
-                const Handle(Geom_Curve) c = adapt.Curve().Curve();
-                double maxDist = 0.000001;     //magic number.  less than this gives false positives.
-                //bool found =
-                (void) GeomLib_Tool::Parameter(c,pt,maxDist,param);  //already know point it on curve
-                result = true;
             }
-            if (result) {
-                TopoDS_Vertex v1 = TopExp::FirstVertex(e);
-                TopoDS_Vertex v2 = TopExp::LastVertex(e);
-                if (DrawUtil::isSamePoint(v,v1) || DrawUtil::isSamePoint(v,v2)) {
-                    if (!allowEnds) {
-                        result = false;
+        }
+    }
+    return result;
+}
+
+namespace {
+
+//an end point of an edge which may split another edge
+struct SplitVertex {
+    TopoDS_Vertex vertex;
+    gp_Pnt pnt;
+    int edge;
+};
+
+//the split points found on one edge
+struct EdgeSplits {
+    int edge;
+    Bnd_Box box;
+    std::vector<splitPoint> splits;
+};
+
+//a uniform grid over the XY bounds of the end points, as the projected edges are 2d on XY
+class VertexGrid
+{
+public:
+    explicit VertexGrid(const std::vector<SplitVertex>& vertexes)
+        : m_vertexes(vertexes), m_xMin(0.0), m_yMin(0.0), m_cellSize(1.0), m_nx(1), m_ny(1)
+    {
+        if (vertexes.empty()) {
+            m_cells.resize(1);
+            return;
+        }
+        double xMax = vertexes.front().pnt.X(), yMax = vertexes.front().pnt.Y();
+        m_xMin = xMax;
+        m_yMin = yMax;
+        for (auto& v: vertexes) {
+            m_xMin = std::min(m_xMin, v.pnt.X());
+            m_yMin = std::min(m_yMin, v.pnt.Y());
+            xMax = std::max(xMax, v.pnt.X());
+            yMax = std::max(yMax, v.pnt.Y());
+        }
+        //about one vertex per cell
+        double width = std::max(xMax - m_xMin, yMax - m_yMin);
+        m_cellSize = std::max(width / std::sqrt(double(vertexes.size())), Precision::Confusion());
+        m_nx = int((xMax - m_xMin) / m_cellSize) + 1;
+        m_ny = int((yMax - m_yMin) / m_cellSize) + 1;
+        m_cells.resize(std::size_t(m_nx) * m_ny);
+        for (std::size_t i = 0; i < vertexes.size(); i++) {
+            m_cells[cellIndex(cellX(vertexes[i].pnt.X()), cellY(vertexes[i].pnt.Y()))].push_back(int(i));
+        }
+    }
+
+    //the vertexes inside box
+    void find(const Bnd_Box& box, std::vector<int>& result) const
+    {
+        double xMin, yMin, zMin, xMax, yMax, zMax;
+        box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+        int x0 = cellX(xMin), x1 = cellX(xMax);
+        int y0 = cellY(yMin), y1 = cellY(yMax);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                for (int i: m_cells[cellIndex(x, y)]) {
+                    if (!box.IsOut(m_vertexes[i].pnt)) {
+                        result.push_back(i);
                     }
                 }
             }
-    } //!outofbox
+        }
+    }
+
+private:
+    int cellX(double x) const {
+        return std::max(0, std::min(m_nx - 1, int(std::floor((x - m_xMin) / m_cellSize))));
+    }
+    int cellY(double y) const {
+        return std::max(0, std::min(m_ny - 1, int(std::floor((y - m_yMin) / m_cellSize))));
+    }
+    std::size_t cellIndex(int x, int y) const {
+        return std::size_t(y) * m_nx + x;
+    }
+
+    const std::vector<SplitVertex>& m_vertexes;
+    std::vector<std::vector<int> > m_cells;
+    double m_xMin, m_yMin, m_cellSize;
+    int m_nx, m_ny;
+};
+
+const std::size_t MinParallelEdges = 64;
+
+}
+
+//! find the points where an end point of an edge touches the inside of another edge.
+//! The end points are kept in a grid, so each edge is only tested against the end points
+//! inside its Bnd_Box.
+std::vector<splitPoint> DrawProjectSplit::findSplitPoints(const std::vector<TopoDS_Edge>& edges)
+{
+    std::vector<EdgeSplits> edgeSplits;
+    std::vector<SplitVertex> vertexes;
+    int iEdge = 0;
+    for (auto& e: edges) {
+        if (DrawUtil::isZeroEdge(e)) {
+            Base::Console().Message("DPS::findSplitPoints - edge: %d is ZeroEdge\n",iEdge);   //this is not finding ZeroEdges
+            iEdge++;
+            continue;  //skip zero length edges. shouldn't happen ;)
+        }
+        EdgeSplits es;
+        es.edge = iEdge;
+        BRepBndLib::Add(e, es.box);
+        es.box.SetGap(0.1);
+        if (es.box.IsVoid()) {
+            Base::Console().Log("INFO - DPS::findSplitPoints - Bnd_Box is void for edge: %d\n",iEdge);
+            iEdge++;
+            continue;
+        }
+        SplitVertex v1, v2;
+        v1.vertex = TopExp::FirstVertex(e);
+        v2.vertex = TopExp::LastVertex(e);
+        v1.pnt = BRep_Tool::Pnt(v1.vertex);
+        v2.pnt = BRep_Tool::Pnt(v2.vertex);
+        v1.edge = v2.edge = iEdge;
+        vertexes.push_back(v1);
+        vertexes.push_back(v2);
+        edgeSplits.push_back(es);
+        iEdge++;
+    }
+
+    VertexGrid grid(vertexes);
+    auto findEdgeSplits = [&](EdgeSplits& es) {
+        const TopoDS_Edge& e = edges[es.edge];
+        std::vector<int> candidates;
+        grid.find(es.box, candidates);
+        for (int i: candidates) {
+            const SplitVertex& v = vertexes[i];
+            if (v.edge == es.edge) {
+                continue;
+            }
+            double param = -1;
+            if (isOnCurve(e, v.vertex, param, false)) {
+                splitPoint s;
+                s.i = es.edge;
+                s.v = Base::Vector3d(v.pnt.X(),v.pnt.Y(),v.pnt.Z());
+                s.param = param;
+                es.splits.push_back(s);
+            }
+        }
+    };
+
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter().GetGroup("BaseApp")->
+                                         GetGroup("Preferences")->GetGroup("Mod/TechDraw/General");
+    if (edgeSplits.size() >= MinParallelEdges && hGrp->GetBool("ParallelEdgeSplit", false)) {
+        QtConcurrent::blockingMap(edgeSplits, findEdgeSplits);
+    }
+    else {
+        for (auto& es: edgeSplits) {
+            findEdgeSplits(es);
+        }
+    }
+
+    std::vector<splitPoint> result;
+    for (auto& es: edgeSplits) {
+        result.insert(result.end(), es.splits.begin(), es.splits.end());
+    }
     return result;
 }
 
@@ -82,6 +82,7 @@ public:
     static TechDraw::GeometryObject*  buildGeometryObject(TopoDS_Shape shape, const gp_Ax2& viewAxis);
 
     static bool isOnEdge(TopoDS_Edge e, TopoDS_Vertex v, double& param, bool allowEnds = false);
+    static std::vector<splitPoint> findSplitPoints(const std::vector<TopoDS_Edge>& edges);
     static std::vector<TopoDS_Edge> splitEdges(std::vector<TopoDS_Edge> orig, std::vector<splitPoint> splits);
     static std::vector<TopoDS_Edge> split1Edge(TopoDS_Edge e, std::vector<splitPoint> splitPoints);
 
@@ -93,6 +94,7 @@ public:
 
 protected:
     static std::vector<TopoDS_Edge> getEdges(TechDraw::GeometryObject* geometryObject);
+    static bool isOnCurve(const TopoDS_Edge& e, const TopoDS_Vertex& v, double& param, bool allowEnds);
 
 
 private:
@@ -51,6 +51,8 @@
 #include <gp_Dir.hxx>
 #include <gp_Pln.hxx>
 #include <gp_XYZ.hxx>
+#include <gp_Mat.hxx>
+#include <gp_Trsf.hxx>
 #include <HLRBRep_Algo.hxx>
 #include <HLRAlgo_Projector.hxx>
 #include <HLRBRep_ShapeBounds.hxx>
@@ -75,6 +77,9 @@
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <exception>
+#include <Precision.hxx>
+#include <QtConcurrentRun>
 
 #include <App/Application.h>
 #include <App/Document.h>
@@ -100,6 +105,7 @@
 #include "DrawViewBalloon.h"
 #include "DrawViewDetail.h"
 #include "DrawPage.h"
+#include "DrawProjGroupItem.h"
 #include "EdgeWalker.h"
 #include "LineGroup.h"
 #include "Cosmetic.h"
@@ -109,6 +115,125 @@
 using namespace TechDraw;
 using namespace std;
 
+namespace TechDraw {
+
+//! The hidden line removal of a view, which may be made in a worker thread
+//! before the view executes, see DrawViewPart::startConcurrentProjections()
+class ProjectionJob
+{
+public:
+    ProjectionJob() : scale(1.0), rotation(0.0), isoCount(0),
+                      perspective(false), focus(0.0), polygonHLR(false) {}
+
+    bool hasSameInput(const ProjectionJob& other) const;
+
+    //the input of the projection
+    std::vector<TopoDS_Shape> sources;
+    gp_Ax2 baseAxis;
+    double scale;
+    double rotation;
+    int isoCount;
+    bool perspective;
+    double focus;
+    bool polygonHLR;
+
+    //the prepared source shape
+    Base::Vector3d centroid;
+    TopoDS_Shape shape;
+    gp_Ax2 viewAxis;
+
+    //the projection, kept until the view takes it over
+    std::unique_ptr<GeometryObject> geometry;
+    std::exception_ptr error;
+    QFuture<void> future;
+};
+
+}
+
+namespace {
+
+bool isSameAxis(const gp_Ax2& a, const gp_Ax2& b)
+{
+    return a.Location().IsEqual(b.Location(), Precision::Confusion()) &&
+           a.Direction().IsEqual(b.Direction(), Precision::Angular()) &&
+           a.XDirection().IsEqual(b.XDirection(), Precision::Angular());
+}
+
+//the location of a linked shape is made anew for every request, so compare the transformations
+bool isSameShape(const TopoDS_Shape& a, const TopoDS_Shape& b)
+{
+    if (a.TShape() != b.TShape() || a.Orientation() != b.Orientation()) {
+        return false;
+    }
+    gp_Trsf ta = a.Location().Transformation();
+    gp_Trsf tb = b.Location().Transformation();
+    if (!ta.TranslationPart().IsEqual(tb.TranslationPart(), Precision::Confusion())) {
+        return false;
+    }
+    gp_Mat ma = ta.VectorialPart();
+    gp_Mat mb = tb.VectorialPart();
+    for (int i = 1; i <= 3; i++) {
+        for (int j = 1; j <= 3; j++) {
+            if (fabs(ma(i,j) - mb(i,j)) > Precision::Confusion()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//! runs the hidden line removal of a job, the job is kept alive even if its view drops it
+struct ProjectionTask
+{
+    typedef void result_type;
+
+    explicit ProjectionTask(const std::shared_ptr<ProjectionJob>& j) : job(j) {}
+
+    void operator()() const
+    {
+        try {
+            if (job->polygonHLR) {
+                job->geometry->projectShapeWithPolygonAlgo(job->shape, job->viewAxis);
+            }
+            else {
+                job->geometry->projectShape(job->shape, job->viewAxis);
+            }
+        }
+        catch (...) {
+            job->error = std::current_exception();
+        }
+    }
+
+    std::shared_ptr<ProjectionJob> job;
+};
+
+bool isSameShapeList(const std::vector<TopoDS_Shape>& a, const std::vector<TopoDS_Shape>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!isSameShape(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool ProjectionJob::hasSameInput(const ProjectionJob& other) const
+{
+    return isSameShapeList(sources, other.sources) &&
+           isSameAxis(baseAxis, other.baseAxis) &&
+           DrawUtil::fpCompare(scale, other.scale) &&
+           DrawUtil::fpCompare(rotation, other.rotation) &&
+           isoCount == other.isoCount &&
+           perspective == other.perspective &&
+           DrawUtil::fpCompare(focus, other.focus) &&
+           polygonHLR == other.polygonHLR;
+}
+
 
 //===========================================================================
 // DrawViewPart
@@ -177,16 +302,7 @@ TopoDS_Shape DrawViewPart::getSourceShape(void) const
                                   getNameInDocument());
         }
     } else {
-        std::vector<TopoDS_Shape> sourceShapes;
-        for (auto& l:links) {
-            auto shape = Part::Feature::getShape(l);
-            if(!shape.IsNull())
-                sourceShapes.push_back(shape);
-            else {
-                std::vector<TopoDS_Shape> shapeList = getShapesFromObject(l);
-                sourceShapes.insert(sourceShapes.end(),shapeList.begin(),shapeList.end());
-            }
-        }
+        std::vector<TopoDS_Shape> sourceShapes = getLinkedShapes();
 
         BRep_Builder builder;
         TopoDS_Compound comp;
@@ -212,6 +328,22 @@ TopoDS_Shape DrawViewPart::getSourceShape(void) const
     return result;
 }
 
+//! the shapes of the Source objects, not copied
+std::vector<TopoDS_Shape> DrawViewPart::getLinkedShapes(void) const
+{
+    std::vector<TopoDS_Shape> sourceShapes;
+    for (auto& l: Source.getValues()) {
+        auto shape = Part::Feature::getShape(l);
+        if(!shape.IsNull())
+            sourceShapes.push_back(shape);
+        else {
+            std::vector<TopoDS_Shape> shapeList = getShapesFromObject(l);
+            sourceShapes.insert(sourceShapes.end(),shapeList.begin(),shapeList.end());
+        }
+    }
+    return sourceShapes;
+}
+
 std::vector<TopoDS_Shape> DrawViewPart::getShapesFromObject(App::DocumentObject* docObj) const
 {
     std::vector<TopoDS_Shape> result;
@@ -302,37 +434,32 @@ App::DocumentObjectExecReturn *DrawViewPart::execute(void)
         return App::DocumentObject::StdReturn;
     }
 
-    TopoDS_Shape shape = getSourceShape();          //if shape is null, it is probably(?) obj creation time.
-    if (shape.IsNull()) {
-        if (isRestoring) {
-            Base::Console().Warning("DVP::execute - source shape is invalid - (but document is restoring) - %s\n",
-                                getNameInDocument());
-        } else {
-            Base::Console().Error("Error: DVP::execute - Source shape is Null. - %s\n",
-                                  getNameInDocument());
+    //the projection may have been started together with the other views of the source
+    std::shared_ptr<ProjectionJob> job = takeProjection();
+    if (!job && canProjectConcurrently()) {
+        startConcurrentProjections();
+        job = takeProjection();
+    }
+
+    if (!job) {
+        TopoDS_Shape shape = getSourceShape();          //if shape is null, it is probably(?) obj creation time.
+        if (shape.IsNull()) {
+            if (isRestoring) {
+                Base::Console().Warning("DVP::execute - source shape is invalid - (but document is restoring) - %s\n",
+                                    getNameInDocument());
+            } else {
+                Base::Console().Error("Error: DVP::execute - Source shape is Null. - %s\n",
+                                      getNameInDocument());
+            }
+            return App::DocumentObject::StdReturn;
         }
-        return App::DocumentObject::StdReturn;
+        job = std::make_shared<ProjectionJob>();
+        prepareProjection(shape, *job);
     }
 
-    gp_Pnt inputCenter;
-    Base::Vector3d stdOrg(0.0,0.0,0.0);
-    
-    inputCenter = TechDraw::findCentroid(shape,
-                                                 getViewAxis(stdOrg,Direction.getValue()));
-                                                 
-    shapeCentroid = Base::Vector3d(inputCenter.X(),inputCenter.Y(),inputCenter.Z());
-    TopoDS_Shape mirroredShape;
-    mirroredShape = TechDraw::mirrorShape(shape,
-                                                  inputCenter,
-                                                  getScale());
-
-    gp_Ax2 viewAxis = getViewAxis(shapeCentroid,Direction.getValue());
-    if (!DrawUtil::fpCompare(Rotation.getValue(),0.0)) {
-        mirroredShape = TechDraw::rotateShape(mirroredShape,
-                                                      viewAxis,
-                                                      Rotation.getValue());
-     }
-    geometryObject =  buildGeometryObject(mirroredShape,viewAxis);
+    shapeCentroid = job->centroid;
+    m_projection = job;
+    geometryObject =  buildGeometryObject(job->shape,job->viewAxis);
 
 #if MOD_TECHDRAW_HANDLE_FACES
     auto start = std::chrono::high_resolution_clock::now();
@@ -402,22 +529,36 @@ void DrawViewPart::onChanged(const App::Property* prop)
 //note: slightly different than routine with same name in DrawProjectSplit
 TechDraw::GeometryObject* DrawViewPart::buildGeometryObject(TopoDS_Shape shape, gp_Ax2 viewAxis)
 {
-    TechDraw::GeometryObject* go = new TechDraw::GeometryObject(getNameInDocument(), this);
-    go->setIsoCount(IsoCount.getValue());
-    go->isPerspective(Perspective.getValue());
-    go->setFocus(Focus.getValue());
-    go->usePolygonHLR(CoarseView.getValue());
+    //take over a projection made in a worker thread
+    std::shared_ptr<ProjectionJob> job;
+    job.swap(m_projection);
+    TechDraw::GeometryObject* go = nullptr;
+    if (job && job->geometry) {
+        job->future.waitForFinished();
+        if (job->error) {
+            std::rethrow_exception(job->error);
+        }
+        go = job->geometry.release();
+    }
 
     Base::Vector3d baseProjDir = Direction.getValue();
     saveParamSpace(baseProjDir);
 
-    if (go->usePolygonHLR()){
-        go->projectShapeWithPolygonAlgo(shape,
-            viewAxis);
-    }
-    else{
-        go->projectShape(shape,
-            viewAxis);
+    if (!go) {
+        go = new TechDraw::GeometryObject(getNameInDocument(), this);
+        go->setIsoCount(IsoCount.getValue());
+        go->isPerspective(Perspective.getValue());
+        go->setFocus(Focus.getValue());
+        go->usePolygonHLR(CoarseView.getValue());
+
+        if (go->usePolygonHLR()){
+            go->projectShapeWithPolygonAlgo(shape,
+                viewAxis);
+        }
+        else{
+            go->projectShape(shape,
+                viewAxis);
+        }
     }
 
     auto start = std::chrono::high_resolution_clock::now();
@@ -469,6 +610,150 @@ TechDraw::GeometryObject* DrawViewPart::buildGeometryObject(TopoDS_Shape shape,
     return go;
 }
 
+//! views on the same page with the same Source, including the items of projection groups
+std::vector<DrawViewPart*> DrawViewPart::getProjectionSiblings(void) const
+{
+    std::vector<DrawViewPart*> result;
+    DrawPage* page = findParentPage();
+    if (page == nullptr) {
+        return result;
+    }
+    for (auto& v: page->getAllViews()) {
+        DrawViewPart* dvp = dynamic_cast<DrawViewPart*>(v);
+        if ((dvp != nullptr) &&
+            (dvp->Source.getValues() == Source.getValues())) {
+            result.push_back(dvp);
+        }
+    }
+    return result;
+}
+
+//! only plain views and projection group items, sections and details project something else
+bool DrawViewPart::canProjectConcurrently(void)
+{
+    Base::Type type = getTypeId();
+    if ((type != DrawViewPart::getClassTypeId()) &&
+        (type != DrawProjGroupItem::getClassTypeId())) {
+        return false;
+    }
+    return keepUpdated() && !Source.getValues().empty();
+}
+
+//! project the views of the same source that need a recompute in worker threads. The source
+//! shape is copied once and the hidden line removal is the only step made outside the main
+//! thread, each view takes over its projection in its own execute().
+void DrawViewPart::startConcurrentProjections(void)
+{
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter().GetGroup("BaseApp")->
+                                         GetGroup("Preferences")->GetGroup("Mod/TechDraw/General");
+    if (!hGrp->GetBool("ParallelProjection", false)) {
+        return;
+    }
+
+    std::vector<DrawViewPart*> views;
+    for (auto& v: getProjectionSiblings()) {
+        if ((v == this) ||
+            (v->mustRecompute() && !v->m_projection && v->canProjectConcurrently())) {
+            views.push_back(v);
+        }
+    }
+    if (views.size() < 2) {
+        return;
+    }
+
+    //views with the same input share one copy of the source shape
+    std::vector<std::pair<std::vector<TopoDS_Shape>, TopoDS_Shape> > sourceShapes;
+    for (auto& v: views) {
+        try {
+            std::shared_ptr<ProjectionJob> job = std::make_shared<ProjectionJob>();
+            v->setProjectionInput(*job);
+            TopoDS_Shape shape;
+            for (auto& s: sourceShapes) {
+                if (isSameShapeList(s.first, job->sources)) {
+                    shape = s.second;
+                    break;
+                }
+            }
+            if (shape.IsNull()) {
+                shape = v->getSourceShape();
+                if (shape.IsNull()) {
+                    continue;
+                }
+                sourceShapes.emplace_back(job->sources, shape);
+            }
+            v->prepareProjection(shape, *job);
+
+            job->geometry.reset(new TechDraw::GeometryObject(v->getNameInDocument(), v));
+            job->geometry->setIsoCount(job->isoCount);
+            job->geometry->isPerspective(job->perspective);
+            job->geometry->setFocus(job->focus);
+            job->geometry->usePolygonHLR(job->polygonHLR);
+            job->future = QtConcurrent::run(ProjectionTask(job));
+            v->m_projection = job;
+        }
+        //the view runs into the problem again and reports it when it executes
+        catch (Standard_Failure& e) {
+            Base::Console().Log("DVP::startConcurrentProjections - %s - %s\n",
+                                v->getNameInDocument(), e.GetMessageString());
+        }
+        catch (Base::Exception& e) {
+            Base::Console().Log("DVP::startConcurrentProjections - %s - %s\n",
+                                v->getNameInDocument(), e.what());
+        }
+    }
+}
+
+//! the input of the projection, to tell if a projection made ahead is still valid
+void DrawViewPart::setProjectionInput(ProjectionJob& job) const
+{
+    Base::Vector3d stdOrg(0.0,0.0,0.0);
+    job.sources = getLinkedShapes();
+    job.baseAxis = getViewAxis(stdOrg,Direction.getValue());
+    job.scale = getScale();
+    job.rotation = Rotation.getValue();
+    job.isoCount = IsoCount.getValue();
+    job.perspective = Perspective.getValue();
+    job.focus = Focus.getValue();
+    job.polygonHLR = CoarseView.getValue();
+}
+
+//! center, scale, mirror and rotate the source shape for the projection
+void DrawViewPart::prepareProjection(const TopoDS_Shape& shape, ProjectionJob& job) const
+{
+    gp_Pnt inputCenter;
+    Base::Vector3d stdOrg(0.0,0.0,0.0);
+
+    inputCenter = TechDraw::findCentroid(shape,
+                                         getViewAxis(stdOrg,Direction.getValue()));
+
+    job.centroid = Base::Vector3d(inputCenter.X(),inputCenter.Y(),inputCenter.Z());
+    job.shape = TechDraw::mirrorShape(shape,
+                                      inputCenter,
+                                      getScale());
+
+    job.viewAxis = getViewAxis(job.centroid,Direction.getValue());
+    if (!DrawUtil::fpCompare(Rotation.getValue(),0.0)) {
+        job.shape = TechDraw::rotateShape(job.shape,
+                                          job.viewAxis,
+                                          Rotation.getValue());
+    }
+}
+
+//! the projection started ahead for this view, if its input has not changed since
+std::shared_ptr<ProjectionJob> DrawViewPart::takeProjection(void)
+{
+    std::shared_ptr<ProjectionJob> job;
+    job.swap(m_projection);
+    if (job) {
+        ProjectionJob input;
+        setProjectionInput(input);
+        if (!job->hasSameInput(input)) {
+            job.reset();
+        }
+    }
+    return job;
+}
+
 //! make faces from the existing edge geometry
 void DrawViewPart::extractFaces()
 {
@@ -492,67 +777,10 @@ void DrawViewPart::extractFaces()
         }
     }
     faceEdges = nonZero;
-    origEdges = nonZero;
 
     //HLR algo does not provide all edge intersections for edge endpoints.
     //need to split long edges touched by Vertex of another edge
-    std::vector<splitPoint> splits;
-    std::vector<TopoDS_Edge>::iterator itOuter = origEdges.begin();
-    int iOuter = 0;
-    for (; itOuter != origEdges.end(); ++itOuter, iOuter++) {
-        TopoDS_Vertex v1 = TopExp::FirstVertex((*itOuter));
-        TopoDS_Vertex v2 = TopExp::LastVertex((*itOuter));
-        Bnd_Box sOuter;
-        BRepBndLib::Add(*itOuter, sOuter);
-        sOuter.SetGap(0.1);
-        if (sOuter.IsVoid()) {
-            Base::Console().Message("DVP::Extract Faces - outer Bnd_Box is void for %s\n",getNameInDocument());
-            continue;
-        }
-        if (DrawUtil::isZeroEdge(*itOuter)) {
-            Base::Console().Message("DVP::extractFaces - outerEdge: %d is ZeroEdge\n",iOuter);   //this is not finding ZeroEdges
-            continue;  //skip zero length edges. shouldn't happen ;)
-        }
-        int iInner = 0;
-        std::vector<TopoDS_Edge>::iterator itInner = faceEdges.begin();
-        for (; itInner != faceEdges.end(); ++itInner,iInner++) {
-            if (iInner == iOuter) {
-                continue;
-            }
-            if (DrawUtil::isZeroEdge((*itInner))) {
-                continue;  //skip zero length edges. shouldn't happen ;)
-            }
-
-            Bnd_Box sInner;
-            BRepBndLib::Add(*itInner, sInner);
-            sInner.SetGap(0.1);
-            if (sInner.IsVoid()) {
-                Base::Console().Log("INFO - DVP::Extract Faces - inner Bnd_Box is void for %s\n",getNameInDocument());
-                continue;
-            }
-            if (sOuter.IsOut(sInner)) {      //bboxes of edges don't intersect, don't bother
-                continue;
-            }
-
-            double param = -1;
-            if (DrawProjectSplit::isOnEdge((*itInner),v1,param,false)) {
-                gp_Pnt pnt1 = BRep_Tool::Pnt(v1);
-                splitPoint s1;
-                s1.i = iInner;
-                s1.v = Base::Vector3d(pnt1.X(),pnt1.Y(),pnt1.Z());
-                s1.param = param;
-                splits.push_back(s1);
-            }
-            if (DrawProjectSplit::isOnEdge((*itInner),v2,param,false)) {
-                gp_Pnt pnt2 = BRep_Tool::Pnt(v2);
-                splitPoint s2;
-                s2.i = iInner;
-                s2.v = Base::Vector3d(pnt2.X(),pnt2.Y(),pnt2.Z());
-                s2.param = param;
-                splits.push_back(s2);
-            }
-        } //inner loop
-    }   //outer loop
+    std::vector<splitPoint> splits = DrawProjectSplit::findSplitPoints(faceEdges);
 
     std::vector<splitPoint> sorted = DrawProjectSplit::sortSplits(splits,true);
     auto last = std::unique(sorted.begin(), sorted.end(), DrawProjectSplit::splitEqual);  //duplicates to back
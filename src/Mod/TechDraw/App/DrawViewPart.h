@@ -29,6 +29,8 @@
 #include <TopoDS_Vertex.hxx>
 #include <TopoDS_Wire.hxx>
 
+#include <memory>
+
 #include <App/DocumentObject.h>
 #include <App/PropertyLinks.h>
 #include <App/PropertyStandard.h>
@@ -76,6 +78,7 @@ class CosmeticVertex;
 class CosmeticEdge;
 class CenterLine;
 class GeomFormat;
+class ProjectionJob;
 }
 
 namespace TechDraw
@@ -164,6 +167,9 @@ public:
     virtual TopoDS_Shape getSourceShape(void) const; 
     virtual std::vector<TopoDS_Shape> getShapesFromObject(App::DocumentObject* docObj) const; 
     virtual TopoDS_Shape getSourceShapeFused(void) const; 
+    std::vector<TopoDS_Shape> getLinkedShapes(void) const;
+    //! the views whose projections can be made together with this one
+    virtual std::vector<DrawViewPart*> getProjectionSiblings(void) const;
     bool isIso(void) const;
 
     virtual int addCosmeticVertex(Base::Vector3d pos);
@@ -230,6 +236,13 @@ protected:
 private:
     bool nowUnsetting;
 
+    bool canProjectConcurrently(void);
+    void startConcurrentProjections(void);
+    void prepareProjection(const TopoDS_Shape& shape, ProjectionJob& job) const;
+    void setProjectionInput(ProjectionJob& job) const;
+    std::shared_ptr<ProjectionJob> takeProjection(void);
+    std::shared_ptr<ProjectionJob> m_projection;
+
 };
 
 typedef App::FeaturePythonT<DrawViewPart> DrawViewPartPython;
@@ -533,6 +533,33 @@ PyObject* DrawViewPartPy::getVertexByIndex(PyObject *args)
     return new Part::TopoShapeVertexPy(new Part::TopoShape(outVertex));
 }
 
+PyObject* DrawViewPartPy::getEdgeCount(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return 0;
+    }
+    DrawViewPart* dvp = getDrawViewPartPtr();
+    return PyLong_FromSize_t(dvp->getEdgeGeometry().size());
+}
+
+PyObject* DrawViewPartPy::getVertexCount(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return 0;
+    }
+    DrawViewPart* dvp = getDrawViewPartPtr();
+    return PyLong_FromSize_t(dvp->getVertexGeometry().size());
+}
+
+PyObject* DrawViewPartPy::getFaceCount(PyObject *args)
+{
+    if (!PyArg_ParseTuple(args, "")) {
+        return 0;
+    }
+    DrawViewPart* dvp = getDrawViewPartPtr();
+    return PyLong_FromSize_t(dvp->getFaceGeometry().size());
+}
+
 
 //==============================================================================
 PyObject *DrawViewPartPy::getCustomAttributes(const char* /*attr*/) const
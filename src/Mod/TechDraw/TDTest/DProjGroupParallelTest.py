@@ -0,0 +1,84 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# test script for TechDraw module
+# creates a Projection Group of a Fusion of a Box and a Sphere
+# compares the views projected in the main thread and in worker threads
+from __future__ import print_function
+
+import FreeCAD
+import Part
+import TechDraw
+import os
+
+def groupCounts(group):
+    for v in group.Views:
+        v.touch()
+    FreeCAD.ActiveDocument.recompute()
+    counts = {}
+    for v in group.Views:
+        counts[v.Label] = (v.getEdgeCount(), v.getVertexCount())
+    return counts
+
+def DProjGroupParallelTest():
+    path = os.path.dirname(os.path.abspath(__file__))
+    print ('TDGroupParallel path: ' + path)
+    templateFileSpec = path + '/TestTemplate.svg'
+
+    FreeCAD.newDocument("TDGroupParallel")
+    FreeCAD.setActiveDocument("TDGroupParallel")
+    FreeCAD.ActiveDocument=FreeCAD.getDocument("TDGroupParallel")
+    doc = FreeCAD.ActiveDocument
+
+    box = doc.addObject("Part::Box","Box")
+    sphere = doc.addObject("Part::Sphere","Sphere")
+    fusion = doc.addObject("Part::MultiFuse","Fusion")
+    fusion.Shapes = [box,sphere]
+    doc.recompute()
+
+    page = doc.addObject('TechDraw::DrawPage','Page')
+    doc.addObject('TechDraw::DrawSVGTemplate','Template')
+    doc.Template.Template = templateFileSpec
+    page.Template = doc.Template
+    print("Page created")
+
+    group = doc.addObject('TechDraw::DrawProjGroup','ProjGroup')
+    rc = page.addView(group)
+    group.Source = [fusion]
+    group.addProjection("Front")
+    group.Anchor.Direction = FreeCAD.Vector(0.0, 0.0, 1.0)
+    group.Anchor.RotationVector = FreeCAD.Vector(1.0, 0.0, 0.0)
+    for p in ["Left", "Top", "Right", "Rear", "Bottom"]:
+        group.addProjection(p)
+    print("Group created")
+
+    hGrp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/TechDraw/General")
+    parallel = hGrp.GetBool("ParallelProjection", False)
+    try:
+        hGrp.SetBool("ParallelProjection", False)
+        serial = groupCounts(group)
+        hGrp.SetBool("ParallelProjection", True)
+        concurrent = groupCounts(group)
+        same = (serial == concurrent)
+        print("edges/vertices serial: {} parallel: {}".format(serial, concurrent))
+
+        #changes made while the views are projected must not leave stale results behind
+        group.ScaleType = "Custom"
+        group.Scale = 2.0
+        group.Anchor.Rotation = 30.0
+        concurrent = groupCounts(group)
+        hGrp.SetBool("ParallelProjection", False)
+        serial = groupCounts(group)
+        same = same and (serial == concurrent)
+        print("edges/vertices after change serial: {} parallel: {}".format(serial, concurrent))
+    finally:
+        hGrp.SetBool("ParallelProjection", parallel)
+
+    rc = False
+    if same and (len(serial) == 6) and ("Up-to-date" in group.State):
+        rc = True
+    FreeCAD.closeDocument("TDGroupParallel")
+    return rc
+
+if __name__ == '__main__':
+    DProjGroupParallelTest()
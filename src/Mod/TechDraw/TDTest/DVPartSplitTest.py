@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# test script for TechDraw module
+# creates a plate with a grid of holes and 1 view
+# compares the faces found with and without the parallel edge splitting
+from __future__ import print_function
+
+import FreeCAD
+import Part
+import TechDraw
+import os
+
+def viewCounts(view):
+    view.touch()
+    FreeCAD.ActiveDocument.recompute()
+    return (view.getFaceCount(), view.getEdgeCount(), view.getVertexCount())
+
+def DVPartSplitTest():
+    path = os.path.dirname(os.path.abspath(__file__))
+    print ('TDPartSplit path: ' + path)
+    templateFileSpec = path + '/TestTemplate.svg'
+
+    FreeCAD.newDocument("TDPartSplit")
+    FreeCAD.setActiveDocument("TDPartSplit")
+    FreeCAD.ActiveDocument=FreeCAD.getDocument("TDPartSplit")
+
+    #a plate with 8x8 holes gives more edges than are split in one thread
+    plate = Part.makeBox(90.0, 90.0, 5.0)
+    for i in range(8):
+        for j in range(8):
+            hole = Part.makeCylinder(3.0, 5.0, FreeCAD.Vector(10.0 * (i + 1), 10.0 * (j + 1), 0.0))
+            plate = plate.cut(hole)
+    feature = FreeCAD.ActiveDocument.addObject("Part::Feature","Plate")
+    feature.Shape = plate
+
+    page = FreeCAD.ActiveDocument.addObject('TechDraw::DrawPage','Page')
+    FreeCAD.ActiveDocument.addObject('TechDraw::DrawSVGTemplate','Template')
+    FreeCAD.ActiveDocument.Template.Template = templateFileSpec
+    FreeCAD.ActiveDocument.Page.Template = FreeCAD.ActiveDocument.Template
+    print("page created")
+
+    view = FreeCAD.ActiveDocument.addObject('TechDraw::DrawViewPart','View')
+    rc = page.addView(view)
+    view.Source = [feature]
+
+    hGrp = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/TechDraw/General")
+    faces = hGrp.GetBool("HandleFaces", True)
+    split = hGrp.GetBool("ParallelEdgeSplit", False)
+    hGrp.SetBool("HandleFaces", True)
+    try:
+        hGrp.SetBool("ParallelEdgeSplit", False)
+        serial = viewCounts(view)
+        hGrp.SetBool("ParallelEdgeSplit", True)
+        parallel = viewCounts(view)
+    finally:
+        hGrp.SetBool("HandleFaces", faces)
+        hGrp.SetBool("ParallelEdgeSplit", split)
+    print("faces/edges/vertices serial: {} parallel: {}".format(serial, parallel))
+
+    rc = False
+    if ("Up-to-date" in view.State) and (serial == parallel) and (serial[0] > 0):
+        rc = True
+    FreeCAD.closeDocument("TDPartSplit")
+    return rc
+
+if __name__ == '__main__':
+    DVPartSplitTest()
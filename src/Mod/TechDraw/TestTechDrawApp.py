@@ -27,9 +27,11 @@ App = FreeCAD
 
 from TDTest.DHatchTest         import DHatchTest
 from TDTest.DProjGroupTest     import DProjGroupTest
+from TDTest.DProjGroupParallelTest import DProjGroupParallelTest
 from TDTest.DVAnnoSymImageTest import DVAnnoSymImageTest
 from TDTest.DVDimensionTest    import DVDimensionTest
 from TDTest.DVPartTest         import DVPartTest
+from TDTest.DVPartSplitTest    import DVPartSplitTest
 from TDTest.DVSectionTest      import DVSectionTest
 from TDTest.DVBalloonTest      import DVBalloonTest
 
@@ -47,6 +49,15 @@ class TechDrawTestCases(unittest.TestCase):
         else:
             print("TD DrawViewPart test failed")
 
+    def testViewPartSplitCase(self):
+        print("starting TD DrawViewPart edge split test")
+        rc = DVPartSplitTest()
+        if rc:
+            print("TD DrawViewPart edge split test passed")
+        else:
+            print("TD DrawViewPart edge split test failed")
+        self.assertTrue(rc)
+
     def testHatchCase(self):
         print("starting TD DrawHatch test")
         rc = DHatchTest()
@@ -71,6 +82,15 @@ class TechDrawTestCases(unittest.TestCase):
         else:
             print("TD DrawProjGroup test failed")
 
+    def testProjGroupParallelCase(self):
+        print("starting TD DrawProjGroup parallel projection test")
+        rc = DProjGroupParallelTest()
+        if rc:
+            print("TD DrawProjGroup parallel projection test passed")
+        else:
+            print("TD DrawProjGroup parallel projection test failed")
+        self.assertTrue(rc)
+
     def testDimensionCase(self):
         print("starting TD DrawViewDimension test")
         rc = DVDimensionTest()
@@ -157,6 +157,26 @@ class ParameterTestCase(unittest.TestCase):
         self.TestPar.RemString("44")
         self.failUnless(self.TestPar.GetString("44","hallo") == "hallo","Deletion error at String")
 
+    def testCachedValues(self):
+        # repeated reads must follow every modification of the group
+        self.TestPar.SetInt("Cache",1)
+        self.TestPar.SetBool("Cache",0)
+        self.TestPar.SetString("Cache","abc")
+        self.failUnless(self.TestPar.GetInt("Cache") == 1,"In and out error at cached Int")
+        self.TestPar.SetInt("Cache",2)
+        self.failUnless(self.TestPar.GetInt("Cache") == 2,"Update error at cached Int")
+        self.failUnless(self.TestPar.GetBool("Cache",1) == 0,"Types of the same name are mixed up")
+        self.failUnless(self.TestPar.GetString("Cache") == "abc","In and out error at cached String")
+        self.TestPar.SetFloat("Cache",1.0/3.0)
+        self.failUnless(self.TestPar.GetFloat("Cache") == self.TestPar.GetFloat("Cache"),"Cached Float differs from stored one")
+        self.TestPar.RemInt("Cache")
+        self.failUnless(self.TestPar.GetInt("Cache",3) == 3,"Deletion error at cached Int")
+        self.TestPar.SetInt("Cache",4)
+        self.failUnless(self.TestPar.GetInt("Cache") == 4,"Recreation error at cached Int")
+        self.TestPar.Clear()
+        self.failUnless(self.TestPar.GetInt("Cache",5) == 5,"Clear error at cached Int")
+        self.failUnless(self.TestPar.GetString("Cache","def") == "def","Clear error at cached String")
+
     def testMatrix(self):
         m=FreeCAD.Matrix(4,2,1,0,1,1,1,0,0,0,1,0,0,0,0,1)
         u=m.multiply(m.inverse())
@@ -608,6 +608,88 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.Doc.removeObject(L7.Name)
     self.Doc.removeObject(L8.Name)
 
+  def testParallelRecompute(self):
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    parallel = param.GetBool("ParallelRecompute",False)
+    param.SetBool("ParallelRecompute",True)
+    try:
+      # independent chains must be recomputed exactly once like the serial recompute does
+      chains = []
+      for i in range(8):
+        base = self.Doc.addObject("App::FeatureTest","Base")
+        top = self.Doc.addObject("App::FeatureTest","Top")
+        top.Link = base
+        chains.append((base,top))
+      L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+      L1.LinkList = [top for base,top in chains]
+      self.Doc.recompute()
+      for base,top in chains:
+        self.failUnless((1, 1)==(base.ExecCount,top.ExecCount))
+      self.failUnless(L1.ExecCount==1)
+
+      chains[3][0].enforceRecompute()
+      self.failUnless(self.Doc.recompute()==3)
+      self.failUnless((2, 2)==(chains[3][0].ExecCount,chains[3][1].ExecCount))
+      self.failUnless((1, 1)==(chains[4][0].ExecCount,chains[4][1].ExecCount))
+      self.failUnless(L1.ExecCount==2)
+
+      # a failing object must not stop the independent branches
+      E1 = self.Doc.addObject("App::FeatureTestException","E1")
+      chains[5][1].LinkList = [E1]
+      chains[6][0].enforceRecompute()
+      self.Doc.recompute()
+      self.failUnless('Invalid' in E1.State)
+      self.failUnless(chains[6][1].ExecCount==2)
+
+      # observers must see the old value before a property is changed by a worker
+      class Observer():
+        def __init__(self):
+          self.before = {}
+          self.after = {}
+        def slotBeforeChangeObject(self, obj, prop):
+          if prop == "ExecCount":
+            self.before[obj.Name] = obj.ExecCount
+        def slotChangedObject(self, obj, prop):
+          if prop == "ExecCount":
+            self.after[obj.Name] = obj.ExecCount
+      observer = Observer()
+      FreeCAD.addDocumentObserver(observer)
+      try:
+        for base,top in chains:
+          base.enforceRecompute()
+        self.Doc.recompute()
+      finally:
+        FreeCAD.removeDocumentObserver(observer)
+      for base,top in chains:
+        for obj in (base,top):
+          self.failUnless(observer.before[obj.Name]+1==observer.after[obj.Name]==obj.ExecCount)
+    finally:
+      param.SetBool("ParallelRecompute",parallel)
+
+  def testTrace(self):
+    import json
+    self.L1.Link = self.L2
+    FreeCAD.clearTrace()
+    FreeCAD.setTracing(True)
+    try:
+      self.failUnless(FreeCAD.isTracing())
+      self.Doc.recompute()
+    finally:
+      FreeCAD.setTracing(False)
+    # spans are only recorded while tracing is on
+    self.Doc.recompute()
+    TempPath = tempfile.gettempdir() + os.sep + "RecomputeTrace.json"
+    count = FreeCAD.exportTrace(TempPath)
+    with open(TempPath) as f:
+      trace = json.load(f)
+    os.remove(TempPath)
+    spans = [ev for ev in trace["traceEvents"] if ev["ph"] == "X"]
+    self.failUnless(count == len(spans))
+    self.failUnless(len([ev for ev in spans if ev["name"] == "Document::recompute"]) == 1)
+    features = [ev["args"]["detail"] for ev in spans if ev["name"] == "Document::_recomputeFeature"]
+    self.failUnless("Label_1" in features and "Label_2" in features)
+    FreeCAD.clearTrace()
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
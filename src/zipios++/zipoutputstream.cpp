@@ -56,6 +56,11 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
 }
 
 
+void ZipOutputStream::putDeflatedEntry( const std::string &entryName, const char *data,
+                                        uint32 compressed_size, uint32 size, uint32 crc ) {
+  ozf->putDeflatedEntry( ZipCDirEntry( entryName ), data, compressed_size, size, crc ) ;
+}
+
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
 }
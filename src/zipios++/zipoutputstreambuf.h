@@ -49,6 +49,16 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been compressed
+      with raw deflate (no zlib header), e.g. by another thread.
+      @param entry the entry to write.
+      @param data the compressed data.
+      @param compressed_size the number of bytes in data.
+      @param size the size of the uncompressed data.
+      @param crc the CRC32 of the uncompressed data. */
+  void putDeflatedEntry( const ZipCDirEntry &entry, const char *data,
+                         uint32 compressed_size, uint32 size, uint32 crc ) ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -68,6 +78,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int currentDosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 